@@ -0,0 +1,121 @@
+#include "config.h"
+#include "mpu6050_driver.h"
+#include "prefilter.h"
+#include "tflite_inference.h"
+#include "trace_replay.h"
+#include "mpu6050_sim.h"
+
+#include <time.h>
+
+// The whole firmware on the host: src/main.c, src/mpu6050_driver.c and
+// src/tflite_inference.c built unchanged against the OSAL (host/osal), with
+// a simulated MPU6050 on the I2C bus:
+//
+//   fall_sim [--seconds N | --hours N] [--cpu-scale X] [--log E|W|I] [--trace file]
+//
+// app_main() runs as on the device and creates the sensor, inference and
+// debug tasks; the sensor samples on the virtual clock, so an hour of
+// monitoring takes as long as its inferences take to compute. CPU time of
+// the tasks is charged to the clock (--cpu-scale 0 makes it free and the run
+// deterministic). --trace plays a recorded trace (trace_replay.h, looped)
+// through the simulated sensor instead of the synthetic motion. Ends with the
+// firmware's own status report and the real-time factor.
+
+#define SIM_DEFAULT_SECONDS 600
+
+void app_main(void);
+
+static void main_task(void* param) {
+    app_main();
+}
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static int usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [--seconds N | --hours N] [--cpu-scale X] [--log E|W|I] [--trace file]\n",
+            argv0);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    osal_config_t config = {
+        .duration_us = (int64_t)SIM_DEFAULT_SECONDS * 1000000,
+        .cpu_scale = 1.0,
+        .log_level = 'E',
+    };
+    const char* trace = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char* opt = argv[i];
+        if (i + 1 >= argc) {
+            return usage(argv[0]);
+        }
+        const char* arg = argv[++i];
+        if (strcmp(opt, "--seconds") == 0) {
+            config.duration_us = (int64_t)(atof(arg) * 1e6);
+        } else if (strcmp(opt, "--hours") == 0) {
+            config.duration_us = (int64_t)(atof(arg) * 3600e6);
+        } else if (strcmp(opt, "--cpu-scale") == 0) {
+            config.cpu_scale = atof(arg);
+        } else if (strcmp(opt, "--log") == 0 && (arg[0] == 'E' || arg[0] == 'W' || arg[0] == 'I')) {
+            config.log_level = arg[0];
+        } else if (strcmp(opt, "--trace") == 0) {
+            trace = arg;
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (config.duration_us <= 0 || config.cpu_scale < 0.0) {
+        return usage(argv[0]);
+    }
+
+    static mpu6050_sim_trace_t source;
+    if (trace != NULL && trace_replay_open(&source.replay, trace, true) != ESP_OK) {
+        return 1;
+    }
+
+    static mpu6050_sim_t sensor;
+    if (mpu6050_sim_attach(&sensor, trace != NULL ? mpu6050_sim_trace : NULL, &source) != ESP_OK) {
+        fprintf(stderr, "cannot attach the simulated MPU6050\n");
+        return 1;
+    }
+
+    double start = wall_seconds();
+    if (osal_run(&config, main_task, NULL) != ESP_OK) {
+        return 1;
+    }
+    double wall = wall_seconds() - start;
+    double simulated = (double)osal_now_us() / 1e6;
+
+    // Tasks are parked: print the firmware's own report at full verbosity
+    osal_set_log_level('I');
+    print_data_buffer_status();
+    print_inference_metrics();
+    prefilter_print_stats(&g_prefilter);
+    mpu6050_print_jitter();
+
+    printf("\nSimulated %.1f s in %.2f s wall (%.0fx real time, task CPU %.2f s)\n",
+           simulated, wall, wall > 0.0 ? simulated / wall : 0.0, (double)osal_cpu_us() / 1e6);
+    printf("  sensor: %lu samples, %lu FIFO overflows, %lu I2C transactions (%.1f/s, %.0f bytes/s)\n",
+           (unsigned long)sensor.stats.samples, (unsigned long)sensor.stats.fifo_overflows,
+           (unsigned long)sensor.stats.transactions,
+           simulated > 0.0 ? sensor.stats.transactions / simulated : 0.0,
+           simulated > 0.0 ? (sensor.stats.bytes_written + sensor.stats.bytes_read) / simulated : 0.0);
+    printf("  pipeline: %lu samples buffered, %lu windows, %lu inferences (%.1f/s wall)\n",
+           (unsigned long)g_data_buffer.total_samples, (unsigned long)g_inference_metrics.windows,
+           (unsigned long)g_inference_metrics.inferences,
+           wall > 0.0 ? g_inference_metrics.inferences / wall : 0.0);
+    if (trace != NULL) {
+        printf("  trace: %lu samples replayed, %lu passes over '%s'\n",
+               (unsigned long)source.replay.samples, (unsigned long)source.replay.passes, trace);
+    }
+    if (g_last_result.is_valid) {
+        printf("  last inference: %s (%.3f)\n", tflite_class_label(g_last_result.predicted_class),
+               g_last_result.confidence);
+    }
+    return 0;
+}
@@ -0,0 +1,612 @@
+#include "model_store.h"
+#include "nn_engine.h"
+#include "nn_static.h"
+#include "config.h"
+#include "fall_detection_model.h"
+
+// Conformance of the int8 engine against golden vectors: input windows with
+// the reference int8 output of every layer, dumped from the TFLite
+// interpreter by host/golden_export.py (or by --export, below):
+//
+//   golden_check [--model m.tflite] [--tolerance ULP] [--reference] golden.bin
+//   golden_check [--model m.tflite] --layers
+//   golden_check [--model m.tflite] --export N golden.bin
+//
+// Every layer runs on its own, fed with the reference output of the layer
+// before it, so an error is charged to the layer that made it instead of
+// everything downstream. The whole model then runs end to end through the
+// interpreter and the template kernels. Errors are in ULP (steps of the
+// tensor's int8 quantization) and in real units; the first layer, in graph
+// order, off by more than --tolerance is reported and fails the run.
+// --reference checks the op-by-op path (unfused conv blocks) instead of the
+// one the firmware runs.
+//
+// --layers prints the flatbuffer tensor of each layer for the exporter.
+// --export writes a bundle of N synthetic windows from the engine's own
+// reference path. That is a regression baseline for the optimized paths
+// when TensorFlow is not at hand, not conformance: code shared with the
+// reference path cancels out. The bundle records its source, and the report
+// says which kind of check it ran.
+//
+// Bundle, little endian: golden_header_t, golden_layer_t[layers], then per
+// window the int8 input and each layer's int8 output in header order.
+
+#define GOLDEN_MAGIC       0x4E444C47u      // "GLDN"
+#define GOLDEN_VERSION     2
+#define GOLDEN_NAME_LEN    16
+#define GOLDEN_MAX_LAYERS  16
+// One quantization step, as for any kernel that replaces an exported op
+#define GOLDEN_DEFAULT_TOLERANCE 1
+
+// Where a bundle's reference outputs come from (version 2 on)
+typedef enum {
+    GOLDEN_SOURCE_TFLITE = 0,           // the TFLite interpreter, golden_export.py
+    GOLDEN_SOURCE_ENGINE = 1,           // this engine's reference path, --export
+} golden_source_t;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t layers;
+    uint32_t windows;
+    uint32_t input_size;        // int8 elements per window
+    float input_scale;
+    int32_t input_zero_point;
+    uint32_t source;            // golden_source_t; absent in version 1
+} golden_header_t;
+
+typedef struct {
+    char name[GOLDEN_NAME_LEN];
+    int32_t tensor;             // main subgraph tensor index
+    uint32_t elements;
+    float scale;
+    int32_t zero_point;
+} golden_layer_t;
+
+typedef enum {
+    LAYER_CONV,
+    LAYER_LSTM,
+    LAYER_ATTENTION,
+    LAYER_DENSE,
+    LAYER_SOFTMAX,
+} layer_kind_t;
+
+// One engine layer whose output can be checked
+typedef struct {
+    char name[GOLDEN_NAME_LEN];
+    layer_kind_t kind;
+    int index;                  // conv block, LSTM layer or Dense layer
+    int32_t tensor;
+    uint32_t elements;
+    uint32_t cols;              // row length, for reporting [row][col]
+    nn_qparam_t q;
+    int golden;                 // bundle layer holding its reference, -1 if none
+} checkpoint_t;
+
+typedef struct {
+    uint32_t windows;
+    uint32_t mismatches;        // elements that differ at all
+    uint32_t compared;
+    int max_ulp;
+    double max_abs;
+    uint32_t worst_window;
+    uint32_t worst_element;
+} layer_error_t;
+
+// Buffers for running single layers
+typedef struct {
+    int8_t* conv_out;
+    int8_t* xproj;
+    int8_t* scratch;
+    int8_t* cell;
+    int8_t* h0;
+    int8_t* output;
+    nn_head_buffers_t head;
+} layer_buffers_t;
+
+static uint8_t* read_model(const char* path, size_t* size) {
+    model_blob_t blob;
+    if (model_store_open(path, &blob) == ESP_OK) {
+        uint8_t* data = malloc(blob.size);
+        if (data != NULL) {
+            memcpy(data, blob.data, blob.size);
+            *size = blob.size;
+        }
+        model_store_close(&blob);
+        return data;
+    }
+
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t* data = len > 0 ? malloc((size_t)len) : NULL;
+    if (data == NULL || fread(data, 1, (size_t)len, f) != (size_t)len) {
+        fprintf(stderr, "%s: cannot read\n", path);
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    *size = (size_t)len;
+    return data;
+}
+
+static int build_checkpoints(const nn_model_t* model, checkpoint_t* cps) {
+    int n = 0;
+    for (int b = 0; b < NN_CONV_BLOCKS; b++) {
+        const nn_conv_block_t* block = &model->blocks[b];
+        cps[n] = (checkpoint_t){ "", LAYER_CONV, b, block->out_tensor,
+                                 (uint32_t)(block->out_len * block->conv.cout), (uint32_t)block->conv.cout,
+                                 block->out_q, -1 };
+        snprintf(cps[n++].name, GOLDEN_NAME_LEN, "conv%d", b + 1);
+    }
+    for (int l = 0; l < NN_LSTM_LAYERS; l++) {
+        const nn_lstm_layer_t* layer = &model->lstm[l];
+        cps[n] = (checkpoint_t){ "", LAYER_LSTM, l, layer->out_tensor,
+                                 (uint32_t)(layer->steps * layer->units), (uint32_t)layer->units,
+                                 layer->hidden_q, -1 };
+        snprintf(cps[n++].name, GOLDEN_NAME_LEN, "lstm%d", l + 1);
+    }
+    cps[n++] = (checkpoint_t){ "attention", LAYER_ATTENTION, 0, model->attention.out_tensor,
+                               (uint32_t)model->attention.units, (uint32_t)model->attention.units,
+                               model->attention.out_q, -1 };
+    for (int d = 0; d < NN_DENSE_LAYERS; d++) {
+        cps[n] = (checkpoint_t){ "", LAYER_DENSE, d, model->dense_tensor[d],
+                                 (uint32_t)model->dense[d].out, (uint32_t)model->dense[d].out,
+                                 model->dense_q[d], -1 };
+        snprintf(cps[n++].name, GOLDEN_NAME_LEN, "dense%d", d + 1);
+    }
+    cps[n++] = (checkpoint_t){ "softmax", LAYER_SOFTMAX, 0, model->output_tensor,
+                               (uint32_t)model->classes, (uint32_t)model->classes, model->output_q, -1 };
+    return n;
+}
+
+static bool alloc_layer_buffers(const nn_model_t* model, layer_buffers_t* buf) {
+    int units = nn_lstm_max_units(model);
+    size_t conv_out = 0;
+    for (int b = 0; b < NN_CONV_BLOCKS; b++) {
+        size_t bytes = (size_t)model->blocks[b].in_len * model->blocks[b].conv.cout;
+        conv_out = bytes > conv_out ? bytes : conv_out;
+    }
+    buf->conv_out = malloc(conv_out);
+    buf->xproj = malloc((size_t)model->lstm[0].steps * NN_GATES * units);
+    buf->scratch = malloc((size_t)NN_LSTM_SCRATCH_ROWS * units);
+    buf->cell = malloc((size_t)units);
+    buf->h0 = malloc((size_t)units);
+    buf->output = malloc((size_t)model->classes);
+    uint8_t* head = aligned_alloc(NN_ARENA_ALIGNMENT, nn_head_buffers_size(model));
+    if (head != NULL) {
+        nn_head_buffers_place(model, head, &buf->head);
+    }
+    return buf->conv_out != NULL && buf->xproj != NULL && buf->scratch != NULL && buf->cell != NULL &&
+           buf->h0 != NULL && buf->output != NULL && head != NULL;
+}
+
+// Runs one layer as the engine does; in and out are in the engine's quantization
+static void run_layer(const nn_model_t* model, const checkpoint_t* cp, const int8_t* in, int8_t* out,
+                      layer_buffers_t* buf) {
+    switch (cp->kind) {
+    case LAYER_CONV: {
+        const nn_conv_block_t* block = &model->blocks[cp->index];
+        if (model->fuse_conv_blocks) {
+            nn_conv_bn_relu_pool_s8(&block->conv, &block->fold, in, block->in_len, out);
+        } else {
+            nn_conv1d_s8(&block->conv, in, block->in_len, buf->conv_out);
+            nn_conv_block_bn(block, buf->conv_out, block->in_len * block->conv.cout);
+            nn_maxpool1d_s8(buf->conv_out, block->in_len, block->conv.cout, block->pool, out);
+        }
+        break;
+    }
+    case LAYER_LSTM: {
+        const nn_lstm_layer_t* layer = &model->lstm[cp->index];
+        const int u = layer->units;
+        nn_lstm_reset_state(layer, buf->h0, buf->cell);
+        nn_gemm_s8(&layer->input_gemm, in, layer->steps, buf->xproj);
+        for (int t = 0; t < layer->steps; t++) {
+            const int8_t* h_prev = t > 0 ? out + (size_t)(t - 1) * u : buf->h0;
+            nn_lstm_step_projected(layer, buf->xproj + (size_t)t * NN_GATES * u, h_prev, buf->cell,
+                                   buf->scratch, out + (size_t)t * u);
+        }
+        break;
+    }
+    case LAYER_ATTENTION:
+        // The head runs attention into head.context, then the Dense layers
+        nn_run_head(model, in, &buf->head, buf->output);
+        memcpy(out, buf->head.context, cp->elements);
+        break;
+    case LAYER_DENSE:
+        nn_fc_s8(&model->dense[cp->index], in, out);
+        break;
+    case LAYER_SOFTMAX:
+        nn_softmax_s8(&model->softmax, in, model->classes, out);
+        break;
+    }
+}
+
+static void compare(const int8_t* got, const int8_t* want, uint32_t n, float scale, uint32_t window,
+                    layer_error_t* err) {
+    err->windows++;
+    err->compared += n;
+    for (uint32_t i = 0; i < n; i++) {
+        int ulp = abs((int)got[i] - (int)want[i]);
+        err->mismatches += ulp != 0;
+        if (ulp > err->max_ulp) {
+            err->max_ulp = ulp;
+            err->max_abs = (double)ulp * scale;
+            err->worst_window = window;
+            err->worst_element = i;
+        }
+    }
+}
+
+// Engine output in the reference tensor's quantization, when the two differ
+static const int8_t* as_golden(const checkpoint_t* cp, const golden_layer_t* g, const int8_t* x, int8_t* tmp) {
+    nn_qparam_t gq = { g->scale, g->zero_point };
+    if (nn_qparam_equal(cp->q, gq)) {
+        return x;
+    }
+    nn_requant_s8(cp->q, gq, x, (int)cp->elements, tmp);
+    return tmp;
+}
+
+static bool read_bundle_header(FILE* f, const char* path, golden_header_t* header, golden_layer_t* layers) {
+    // Version 1 headers end before source; those came from golden_export.py
+    const size_t v1_size = offsetof(golden_header_t, source);
+    memset(header, 0, sizeof(*header));
+    if (fread(header, v1_size, 1, f) != 1 || header->magic != GOLDEN_MAGIC) {
+        fprintf(stderr, "%s: not a golden vector bundle\n", path);
+        return false;
+    }
+    if (header->version >= 2 && fread(&header->source, sizeof(header->source), 1, f) != 1) {
+        fprintf(stderr, "%s: truncated bundle header\n", path);
+        return false;
+    }
+    if (header->version < 1 || header->version > GOLDEN_VERSION || header->layers > GOLDEN_MAX_LAYERS ||
+        fread(layers, sizeof(layers[0]), header->layers, f) != header->layers) {
+        fprintf(stderr, "%s: unsupported bundle (version %u, %u layers)\n", path,
+                (unsigned)header->version, (unsigned)header->layers);
+        return false;
+    }
+    for (int i = 0; i < header->layers; i++) {
+        layers[i].name[GOLDEN_NAME_LEN - 1] = '\0';
+    }
+    return true;
+}
+
+static int check(nn_model_t* model, const char* path, int tolerance) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return 2;
+    }
+    golden_header_t header;
+    golden_layer_t layers[GOLDEN_MAX_LAYERS];
+    if (!read_bundle_header(f, path, &header, layers)) {
+        fclose(f);
+        return 2;
+    }
+    const uint32_t input_size = (uint32_t)(model->seq_len * model->features);
+    if (header.input_size != input_size) {
+        fprintf(stderr, "%s: windows of %lu values, the model takes %lu\n", path,
+                (unsigned long)header.input_size, (unsigned long)input_size);
+        fclose(f);
+        return 2;
+    }
+    nn_qparam_t bundle_input_q = { header.input_scale, header.input_zero_point };
+    if (!nn_qparam_equal(bundle_input_q, model->input_q)) {
+        printf("warning: bundle input quantization (%g, %ld) differs from the model's (%g, %ld)\n",
+               header.input_scale, (long)header.input_zero_point, model->input_q.scale,
+               (long)model->input_q.zero_point);
+    }
+
+    checkpoint_t cps[GOLDEN_MAX_LAYERS];
+    int count = build_checkpoints(model, cps);
+    size_t record = input_size;
+    size_t largest = input_size;
+    for (int g = 0; g < header.layers; g++) {
+        int match = -1;
+        for (int c = 0; c < count; c++) {
+            match = cps[c].tensor == layers[g].tensor && layers[g].tensor >= 0 ? c : match;
+        }
+        if (match < 0) {
+            printf("note: bundle layer %s (tensor %ld) is not an engine layer, ignored\n", layers[g].name,
+                   (long)layers[g].tensor);
+        } else if (layers[g].elements != cps[match].elements) {
+            printf("note: bundle layer %s has %lu values, %s has %lu, ignored\n", layers[g].name,
+                   (unsigned long)layers[g].elements, cps[match].name, (unsigned long)cps[match].elements);
+        } else {
+            cps[match].golden = g;
+        }
+        record += layers[g].elements;
+        largest = layers[g].elements > largest ? layers[g].elements : largest;
+    }
+    for (int c = 0; c < count; c++) {
+        largest = cps[c].elements > largest ? cps[c].elements : largest;
+    }
+
+    size_t engine_arena_size = nn_engine_arena_size(model);
+    bool use_static = nn_static_matches(model);
+    size_t static_arena_size = use_static ? nn_static_arena_size() : 0;
+    uint8_t* engine_arena = aligned_alloc(NN_ARENA_ALIGNMENT, engine_arena_size);
+    uint8_t* static_arena = use_static ? aligned_alloc(NN_ARENA_ALIGNMENT, static_arena_size) : NULL;
+    int8_t* data = malloc(record);
+    int8_t* in = malloc(largest);
+    int8_t* out = malloc(largest);
+    int8_t* tmp = malloc(largest);
+    static layer_buffers_t buf;
+    nn_engine_t engine;
+    static nn_static_engine_t fixed;
+    if (engine_arena == NULL || (use_static && static_arena == NULL) || data == NULL || in == NULL ||
+        out == NULL || tmp == NULL || !alloc_layer_buffers(model, &buf) ||
+        nn_engine_init(&engine, model, engine_arena, engine_arena_size) != ESP_OK ||
+        (use_static && nn_static_init(&fixed, model, static_arena, static_arena_size) != ESP_OK)) {
+        fclose(f);
+        return 2;
+    }
+
+    // Reference output of the graph, for the end-to-end runs
+    int output_golden = cps[count - 1].golden;
+    layer_error_t errors[GOLDEN_MAX_LAYERS] = { 0 };
+    layer_error_t model_error = { 0 };
+    layer_error_t static_error = { 0 };
+    uint32_t windows = 0;
+
+    while (windows < header.windows && fread(data, 1, record, f) == record) {
+        const int8_t* window = data;
+        const int8_t* golden[GOLDEN_MAX_LAYERS];
+        size_t offset = input_size;
+        for (int g = 0; g < header.layers; g++) {
+            golden[g] = data + offset;
+            offset += layers[g].elements;
+        }
+
+        if (nn_qparam_equal(bundle_input_q, model->input_q)) {
+            memcpy(in, window, input_size);
+        } else {
+            nn_requant_s8(bundle_input_q, model->input_q, window, (int)input_size, in);
+        }
+        for (int c = 0; c < count; c++) {
+            const checkpoint_t* cp = &cps[c];
+            run_layer(model, cp, in, out, &buf);
+            if (cp->golden < 0) {
+                memcpy(in, out, cp->elements);      // nothing to check against: carry on
+                continue;
+            }
+            const golden_layer_t* g = &layers[cp->golden];
+            compare(as_golden(cp, g, out, tmp), golden[cp->golden], cp->elements, g->scale, windows, &errors[c]);
+
+            // Next layer starts from the reference, in the engine's quantization
+            nn_qparam_t gq = { g->scale, g->zero_point };
+            if (nn_qparam_equal(cp->q, gq)) {
+                memcpy(in, golden[cp->golden], cp->elements);
+            } else {
+                nn_requant_s8(gq, cp->q, golden[cp->golden], (int)cp->elements, in);
+            }
+        }
+
+        if (output_golden >= 0) {
+            const checkpoint_t* cp = &cps[count - 1];
+            const golden_layer_t* g = &layers[output_golden];
+            nn_engine_invoke(&engine, window, out);
+            compare(as_golden(cp, g, out, tmp), golden[output_golden], cp->elements, g->scale, windows,
+                    &model_error);
+            if (use_static) {
+                nn_static_invoke(&fixed, window, out);
+                compare(as_golden(cp, g, out, tmp), golden[output_golden], cp->elements, g->scale, windows,
+                        &static_error);
+            }
+        }
+        windows++;
+    }
+    fclose(f);
+    if (windows == 0) {
+        fprintf(stderr, "%s: no complete window\n", path);
+        return 2;
+    }
+    if (windows < header.windows) {
+        printf("warning: bundle is truncated, %lu of %lu windows read\n", (unsigned long)windows,
+               (unsigned long)header.windows);
+    }
+
+    printf("\nGolden vectors '%s': %lu windows, %s path, tolerance %d ULP\n", path, (unsigned long)windows,
+           model->fuse_conv_blocks ? "optimized" : "reference", tolerance);
+    if (header.source == GOLDEN_SOURCE_ENGINE) {
+        printf("  regression baseline from this engine's reference path (--export), not TFLite conformance\n");
+    } else {
+        printf("  conformance against the TFLite interpreter (golden_export.py)\n");
+    }
+    printf("  %-12s %8s %10s %8s %12s  %s\n", "layer", "tensor", "mismatch", "max ULP", "max abs", "worst");
+    int first = -1;
+    for (int c = 0; c <= count + 1; c++) {
+        const char* name;
+        const checkpoint_t* cp = &cps[c < count ? c : count - 1];
+        const layer_error_t* err;
+        if (c < count) {
+            name = cp->name;
+            err = &errors[c];
+            if (cps[c].golden < 0) {
+                printf("  %-12s %8ld  (no reference in the bundle)\n", name, (long)cp->tensor);
+                continue;
+            }
+        } else if (output_golden < 0 || (c == count + 1 && !use_static)) {
+            continue;
+        } else {
+            name = c == count ? "model" : "model_static";
+            err = c == count ? &model_error : &static_error;
+        }
+        double pct = err->compared > 0 ? 100.0 * err->mismatches / err->compared : 0.0;
+        printf("  %-12s %8ld %9.2f%% %8d %12.6f", name, (long)cp->tensor, pct, err->max_ulp, err->max_abs);
+        if (err->max_ulp > 0 && cp->cols < cp->elements) {
+            printf("  window %lu, [%lu][%lu]", (unsigned long)err->worst_window,
+                   (unsigned long)(err->worst_element / cp->cols), (unsigned long)(err->worst_element % cp->cols));
+        } else if (err->max_ulp > 0) {
+            printf("  window %lu, [%lu]", (unsigned long)err->worst_window, (unsigned long)err->worst_element);
+        }
+        printf("%s\n", err->max_ulp > tolerance ? "  DIVERGES" : "");
+        if (first < 0 && err->max_ulp > tolerance) {
+            first = c;
+        }
+    }
+
+    if (first < 0) {
+        printf("PASS\n");
+    } else {
+        const char* name = first < count ? cps[first].name : first == count ? "model" : "model_static";
+        printf("FAIL: first divergence at %s\n", name);
+    }
+    return first < 0 ? 0 : 1;
+}
+
+static uint32_t lcg_state = 12345;
+
+static uint32_t lcg_next(void) {
+    lcg_state = lcg_state * 1664525u + 1013904223u;
+    return lcg_state >> 8;
+}
+
+// Even windows a smooth swing with noise, odd windows uniform noise
+static void make_window(const nn_model_t* model, int w, int8_t* input) {
+    for (int t = 0; t < model->seq_len; t++) {
+        for (int f = 0; f < model->features; f++) {
+            int8_t* q = &input[t * model->features + f];
+            if (w % 2 == 1) {
+                *q = (int8_t)(lcg_next() & 0xFF);
+                continue;
+            }
+            float s = (float)t / SAMPLE_RATE_HZ + 0.37f * (float)w;
+            float v = f == 2 ? 0.5f : 0.0f;
+            v += 0.4f * sinf(2.0f * (float)M_PI * (0.5f + 0.1f * (float)(w % 7)) * s + (float)f);
+            v += 0.02f * (float)((int)(lcg_next() % 201) - 100) / 100.0f;
+            *q = nn_quantize_f32(v, model->input_q);
+        }
+    }
+}
+
+static int export_bundle(nn_model_t* model, int windows, const char* path) {
+    model->fuse_conv_blocks = false;
+    model->online_attention = false;
+
+    checkpoint_t cps[GOLDEN_MAX_LAYERS];
+    int count = build_checkpoints(model, cps);
+    golden_header_t header = {
+        .magic = GOLDEN_MAGIC,
+        .version = GOLDEN_VERSION,
+        .layers = (uint16_t)count,
+        .windows = (uint32_t)windows,
+        .input_size = (uint32_t)(model->seq_len * model->features),
+        .input_scale = model->input_q.scale,
+        .input_zero_point = model->input_q.zero_point,
+        .source = GOLDEN_SOURCE_ENGINE,
+    };
+    golden_layer_t layers[GOLDEN_MAX_LAYERS];
+    size_t largest = header.input_size;
+    for (int c = 0; c < count; c++) {
+        memset(&layers[c], 0, sizeof(layers[c]));
+        snprintf(layers[c].name, GOLDEN_NAME_LEN, "%.*s", GOLDEN_NAME_LEN - 1, cps[c].name);
+        layers[c].tensor = cps[c].tensor;
+        layers[c].elements = cps[c].elements;
+        layers[c].scale = cps[c].q.scale;
+        layers[c].zero_point = cps[c].q.zero_point;
+        largest = cps[c].elements > largest ? cps[c].elements : largest;
+    }
+
+    static layer_buffers_t buf;
+    int8_t* in = malloc(largest);
+    int8_t* out = malloc(largest);
+    FILE* f = fopen(path, "wb");
+    if (in == NULL || out == NULL || !alloc_layer_buffers(model, &buf) || f == NULL) {
+        if (f == NULL) {
+            perror(path);
+        }
+        return 1;
+    }
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(layers, sizeof(layers[0]), (size_t)count, f);
+    for (int w = 0; w < windows; w++) {
+        make_window(model, w, in);
+        fwrite(in, 1, header.input_size, f);
+        for (int c = 0; c < count; c++) {
+            run_layer(model, &cps[c], in, out, &buf);
+            fwrite(out, 1, cps[c].elements, f);
+            memcpy(in, out, cps[c].elements);
+        }
+    }
+    bool ok = ferror(f) == 0;
+    ok &= fclose(f) == 0;
+    printf("%s: %d windows, %d layers from the engine's reference path (a regression baseline, not TFLite "
+           "conformance)\n", path, windows, count);
+    return ok ? 0 : 1;
+}
+
+static int usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [--model m.tflite] [--tolerance ULP] [--reference] golden.bin\n"
+                    "       %s [--model m.tflite] --layers\n"
+                    "       %s [--model m.tflite] --export N golden.bin\n", argv0, argv0, argv0);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    const char* model_path = NULL;
+    int tolerance = GOLDEN_DEFAULT_TOLERANCE;
+    bool reference = false;
+    bool list_layers = false;
+    int export_windows = 0;
+    const char* bundle = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--model") == 0 && i + 1 < argc) {
+            model_path = argv[++i];
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--reference") == 0) {
+            reference = true;
+        } else if (strcmp(argv[i], "--layers") == 0) {
+            list_layers = true;
+        } else if (strcmp(argv[i], "--export") == 0 && i + 1 < argc) {
+            export_windows = atoi(argv[++i]);
+            if (export_windows <= 0) {
+                return usage(argv[0]);
+            }
+        } else if (argv[i][0] != '-' && bundle == NULL) {
+            bundle = argv[i];
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (tolerance < 0 || (bundle == NULL) != list_layers) {
+        return usage(argv[0]);
+    }
+
+    const uint8_t* data = fall_detection_model;
+    size_t size = fall_detection_model_len;
+    if (model_path != NULL && (data = read_model(model_path, &size)) == NULL) {
+        return 2;
+    }
+    static nn_model_t model;
+    if (nn_model_load(&model, data, size) != ESP_OK) {
+        return 2;
+    }
+
+    if (list_layers) {
+        // name:tensor pairs, the --layers argument of golden_export.py
+        checkpoint_t cps[GOLDEN_MAX_LAYERS];
+        int count = build_checkpoints(&model, cps);
+        for (int c = 0; c < count; c++) {
+            printf("%s%s:%ld", c > 0 ? "," : "", cps[c].name, (long)cps[c].tensor);
+        }
+        printf("\n");
+        return 0;
+    }
+    if (export_windows > 0) {
+        return export_bundle(&model, export_windows, bundle);
+    }
+    if (reference) {
+        model.fuse_conv_blocks = false;
+        model.online_attention = false;
+    }
+    return check(&model, bundle, tolerance);
+}
@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""Golden vectors for host/golden_check, dumped from the TFLite interpreter.
+
+    golden_export.py model.tflite golden.bin --layers $(golden_check --layers) \
+        [--windows x_test.npy] [--random N] [--limit N]
+
+Runs every window through the TFLite interpreter with all intermediate
+tensors kept and writes the int8 input and the int8 output of each layer
+(--layers: name:tensor pairs, as printed by `golden_check --layers`) into
+one bundle. Windows come from a float32 .npy array shaped [N, T, C], scaled
+as the notebook scales X_test, or are uniform random int8 (--random).
+
+Needs numpy and tflite-runtime (or tensorflow).
+"""
+
+import argparse
+import struct
+import sys
+
+import numpy as np
+
+try:
+    from tflite_runtime.interpreter import Interpreter
+except ImportError:
+    from tensorflow.lite.python.interpreter import Interpreter
+
+GOLDEN_MAGIC = 0x4E444C47  # "GLDN"
+GOLDEN_VERSION = 2
+GOLDEN_SOURCE_TFLITE = 0  # golden_source_t
+GOLDEN_NAME_LEN = 16
+HEADER = struct.Struct("<IHHIIfiI")  # golden_header_t
+LAYER = struct.Struct("<16siIfi")  # golden_layer_t
+
+
+def parse_layers(text):
+    layers = []
+    for item in text.split(","):
+        name, _, tensor = item.partition(":")
+        if not name or not tensor:
+            sys.exit(f"bad --layers entry '{item}', expected name:tensor")
+        layers.append((name[:GOLDEN_NAME_LEN - 1], int(tensor)))
+    return layers
+
+
+def quantize(x, scale, zero_point):
+    q = np.round(x / scale) + zero_point
+    return np.clip(q, -128, 127).astype(np.int8)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("model")
+    parser.add_argument("out")
+    parser.add_argument("--layers", required=True, help="name:tensor,... from golden_check --layers")
+    parser.add_argument("--windows", help="float32 .npy [N, T, C], scaled like the training data")
+    parser.add_argument("--random", type=int, default=0, help="uniform random int8 windows")
+    parser.add_argument("--limit", type=int, default=0, help="at most this many windows from --windows")
+    parser.add_argument("--seed", type=int, default=12345)
+    args = parser.parse_args()
+
+    interpreter = Interpreter(model_path=args.model, experimental_preserve_all_tensors=True)
+    interpreter.allocate_tensors()
+    inp = interpreter.get_input_details()[0]
+    if inp["dtype"] != np.int8:
+        sys.exit("model input is not int8")
+    in_scale, in_zero_point = inp["quantization"]
+    shape = tuple(inp["shape"][1:])
+    details = {d["index"]: d for d in interpreter.get_tensor_details()}
+
+    windows = []
+    if args.windows:
+        x = np.load(args.windows).astype(np.float32)
+        if x.shape[1:] != shape:
+            sys.exit(f"{args.windows}: windows are {x.shape[1:]}, the model takes {shape}")
+        if args.limit:
+            x = x[:args.limit]
+        windows += [quantize(w, in_scale, in_zero_point) for w in x]
+    rng = np.random.default_rng(args.seed)
+    windows += [rng.integers(-128, 128, size=shape, dtype=np.int8) for _ in range(args.random)]
+    if not windows:
+        sys.exit("no windows: give --windows and/or --random")
+
+    layers = parse_layers(args.layers)
+    for name, tensor in layers:
+        if tensor not in details or details[tensor]["dtype"] != np.int8:
+            sys.exit(f"layer {name}: tensor {tensor} is not an int8 tensor of the main graph")
+
+    records = []
+    for w in windows:
+        interpreter.set_tensor(inp["index"], w[np.newaxis])
+        interpreter.invoke()
+        records.append([interpreter.get_tensor(t).astype(np.int8).ravel() for _, t in layers])
+
+    with open(args.out, "wb") as f:
+        f.write(HEADER.pack(GOLDEN_MAGIC, GOLDEN_VERSION, len(layers), len(windows), int(np.prod(shape)),
+                            float(in_scale), int(in_zero_point), GOLDEN_SOURCE_TFLITE))
+        for (name, tensor), data in zip(layers, records[0]):
+            scale, zero_point = details[tensor]["quantization"]
+            f.write(LAYER.pack(name.encode(), tensor, data.size, float(scale), int(zero_point)))
+        for w, record in zip(windows, records):
+            f.write(w.tobytes())
+            for data in record:
+                f.write(data.tobytes())
+
+    print(f"{args.out}: {len(windows)} windows, {len(layers)} layers")
+
+
+if __name__ == "__main__":
+    main()
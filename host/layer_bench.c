@@ -0,0 +1,105 @@
+#include "nn_bench.h"
+#include "nn_engine.h"
+#include "config.h"
+#include "fall_detection_model.h"
+
+// Per-layer latency of the built-in model, with regression checks against a
+// stored baseline:
+//
+//   layer_bench [--iterations N] [--out results.csv] [--baseline base.csv] [--threshold PCT]
+//   layer_bench --compare base.csv results.csv [--threshold PCT]
+//
+// Prints the table and the CSV results (nn_bench.h); --out also writes the
+// CSV to a file, which can serve as the next baseline. With --baseline the
+// median of every case is compared against the baseline's and the exit
+// status is 1 when any case is more than PCT percent slower. --compare
+// checks two stored result files without running anything, e.g. CSV lines
+// captured from the target's serial log (NN_BENCH_AT_BOOT) in cycles.
+
+#define BENCH_DEFAULT_ITERATIONS 200
+#define BENCH_DEFAULT_THRESHOLD  10.0f
+
+static int usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [--iterations N] [--out results.csv] [--baseline base.csv] [--threshold PCT]\n"
+                    "       %s --compare base.csv results.csv [--threshold PCT]\n", argv0, argv0);
+    return 2;
+}
+
+static int compare(const nn_bench_report_t* baseline, const nn_bench_report_t* current, float threshold) {
+    int regressions = 0;
+    if (nn_bench_compare(baseline, current, threshold, &regressions) != ESP_OK) {
+        return 2;
+    }
+    printf("%d regression%s beyond %.1f%%\n", regressions, regressions == 1 ? "" : "s", threshold);
+    return regressions > 0 ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    int iterations = BENCH_DEFAULT_ITERATIONS;
+    float threshold = BENCH_DEFAULT_THRESHOLD;
+    const char* out_path = NULL;
+    const char* baseline_path = NULL;
+    const char* compare_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char* opt = argv[i];
+        if (i + 1 >= argc) {
+            return usage(argv[0]);
+        }
+        const char* arg = argv[++i];
+        if (strcmp(opt, "--iterations") == 0) {
+            iterations = atoi(arg);
+        } else if (strcmp(opt, "--out") == 0) {
+            out_path = arg;
+        } else if (strcmp(opt, "--baseline") == 0) {
+            baseline_path = arg;
+        } else if (strcmp(opt, "--threshold") == 0) {
+            threshold = (float)atof(arg);
+        } else if (strcmp(opt, "--compare") == 0 && i + 1 < argc) {
+            baseline_path = arg;
+            compare_path = argv[++i];
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (iterations <= 0 || threshold < 0.0f || (compare_path != NULL && out_path != NULL)) {
+        return usage(argv[0]);
+    }
+
+    static nn_bench_report_t baseline;
+    if (baseline_path != NULL && nn_bench_load_csv(baseline_path, &baseline) != ESP_OK) {
+        return 2;
+    }
+
+    static nn_bench_report_t current;
+    if (compare_path != NULL) {
+        if (nn_bench_load_csv(compare_path, &current) != ESP_OK) {
+            return 2;
+        }
+        return compare(&baseline, &current, threshold);
+    }
+
+    static nn_model_t model;
+    if (nn_model_load(&model, fall_detection_model, fall_detection_model_len) != ESP_OK) {
+        return 1;
+    }
+    if (nn_bench_run(&model, iterations, &current) != ESP_OK) {
+        return 1;
+    }
+    nn_bench_print(&current);
+    nn_bench_write_csv(&current, stdout);
+
+    if (out_path != NULL) {
+        FILE* out = fopen(out_path, "w");
+        if (out == NULL) {
+            perror(out_path);
+            return 1;
+        }
+        nn_bench_write_csv(&current, out);
+        if (ferror(out) != 0 || fclose(out) != 0) {
+            perror(out_path);
+            return 1;
+        }
+    }
+    return baseline_path != NULL ? compare(&baseline, &current, threshold) : 0;
+}
@@ -0,0 +1,6 @@
+#include "nn_lut.h"
+
+int main(void) {
+    nn_lut_report();
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include "model_store.h"
+#include "nn_engine.h"
+#include "config.h"
+#include "fall_detection_model.h"
+
+// Generates the shape header for the template kernels (nn_static.hpp):
+//
+//   model_codegen [model.tflite | model.bin] output.h
+//
+// Model images are unwrapped first; without a model the built-in array
+// (src/fall_detection_model.h) is used. The model is bound exactly as the
+// firmware binds it, every shape in the output comes from the bound graph,
+// and the interpreter's planned arena becomes the upper bound the static
+// plan is checked against. The host build regenerates the header on every
+// model change; src/nn_static_model.h is the checked-in copy for the
+// firmware build.
+
+static uint8_t* read_model(const char* path, size_t* size) {
+    model_blob_t blob;
+    if (model_store_open(path, &blob) == ESP_OK) {
+        uint8_t* data = malloc(blob.size);
+        if (data != NULL) {
+            memcpy(data, blob.data, blob.size);
+            *size = blob.size;
+        }
+        model_store_close(&blob);
+        return data;
+    }
+
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t* data = len > 0 ? malloc((size_t)len) : NULL;
+    if (data == NULL || fread(data, 1, (size_t)len, f) != (size_t)len) {
+        fprintf(stderr, "%s: cannot read\n", path);
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    *size = (size_t)len;
+    return data;
+}
+
+static const char* base_name(const char* path) {
+    const char* slash = strrchr(path, '/');
+    return slash != NULL ? slash + 1 : path;
+}
+
+static bool write_header(FILE* out, const nn_model_t* m, const char* source, size_t size, uint32_t crc) {
+    const nn_conv_block_t* b0 = &m->blocks[0];
+    const nn_conv_block_t* b1 = &m->blocks[1];
+    const nn_lstm_layer_t* l0 = &m->lstm[0];
+    const nn_lstm_layer_t* l1 = &m->lstm[1];
+    size_t arena = nn_engine_arena_size(m);
+
+    fprintf(out, "// Generated by host/model_codegen from %s\n", source);
+    fprintf(out, "// (%zu bytes, CRC-32 %08lx). Do not edit; regenerate with\n", size, (unsigned long)crc);
+    fprintf(out, "//   model_codegen [model.tflite] src/nn_static_model.h\n");
+    fprintf(out, "\n#ifndef NN_STATIC_MODEL_H\n#define NN_STATIC_MODEL_H\n\n");
+    fprintf(out, "#define NN_STATIC_MODEL_CRC32 0x%08lxu\n", (unsigned long)crc);
+    fprintf(out, "#define NN_STATIC_MODEL_SHAPE \"%dx%d k%d/%d %d/%d lstm %d/%d att %d dense %d -> %d\"\n",
+            m->seq_len, m->features, b0->conv.kernel, b1->conv.kernel, b0->conv.cout, b1->conv.cout,
+            l0->units, l1->units, m->attention.steps, m->dense[0].out, m->classes);
+    fprintf(out, "#define NN_STATIC_INTERPRETER_ARENA %zu\n", arena);
+    fprintf(out, "\n#ifdef __cplusplus\n\nnamespace nn_static_model {\n\n");
+    fprintf(out, "using Graph = nn_static::Graph<\n");
+    fprintf(out, "    nn_static::ConvBlock<nn_static::Conv1D<int8_t, %d, %d, %d>, %d, %d>,\n",
+            b0->conv.kernel, b0->conv.cin, b0->conv.cout, b0->in_len, b0->pool);
+    fprintf(out, "    nn_static::ConvBlock<nn_static::Conv1D<int8_t, %d, %d, %d>, %d, %d>,\n",
+            b1->conv.kernel, b1->conv.cin, b1->conv.cout, b1->in_len, b1->pool);
+    fprintf(out, "    nn_static::Lstm<int8_t, %d, %d>,\n", l0->input_size, l0->units);
+    fprintf(out, "    nn_static::Lstm<int8_t, %d, %d>,\n", l1->input_size, l1->units);
+    fprintf(out, "    nn_static::Attention<int8_t, %d, %d>,\n", m->attention.steps, m->attention.units);
+    fprintf(out, "    nn_static::Dense<%d, %d>,\n", m->dense[0].in, m->dense[0].out);
+    fprintf(out, "    nn_static::Dense<%d, %d>,\n", m->dense[1].in, m->dense[1].out);
+    fprintf(out, "    NN_STATIC_INTERPRETER_ARENA>;\n");
+    fprintf(out, "\n} // namespace nn_static_model\n\n#endif // __cplusplus\n");
+    fprintf(out, "\n#endif // NN_STATIC_MODEL_H\n");
+    return !ferror(out);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: %s [model.tflite | model.bin] output.h\n", argv[0]);
+        return 2;
+    }
+
+    const uint8_t* data = fall_detection_model;
+    size_t size = fall_detection_model_len;
+    char source[256] = "the built-in model (src/fall_detection_model.h)";
+    uint8_t* loaded = NULL;
+    if (argc == 3) {
+        loaded = read_model(argv[1], &size);
+        if (loaded == NULL) {
+            return 1;
+        }
+        data = loaded;
+        snprintf(source, sizeof(source), "%s", base_name(argv[1]));
+    }
+
+    static nn_model_t model;
+    esp_err_t ret = nn_model_load(&model, data, size);
+    if (ret != ESP_OK) {
+        fprintf(stderr, "%s: not a supported model (%s)\n", source, esp_err_to_name(ret));
+        free(loaded);
+        return 1;
+    }
+    if (!model.fuse_conv_blocks) {
+        fprintf(stderr, "%s: BatchNorm cannot be folded, the template kernels need fused conv blocks\n", source);
+        free(loaded);
+        return 1;
+    }
+
+    const char* out_path = argv[argc - 1];
+    FILE* out = fopen(out_path, "w");
+    if (out == NULL) {
+        perror(out_path);
+        free(loaded);
+        return 1;
+    }
+    bool ok = write_header(out, &model, source, size, model_crc32(0, data, size));
+    ok = fclose(out) == 0 && ok;
+    free(loaded);
+    if (!ok) {
+        fprintf(stderr, "%s: write failed\n", out_path);
+        return 1;
+    }
+    printf("%s: shapes of %s\n", out_path, source);
+    return 0;
+}
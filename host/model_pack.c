@@ -0,0 +1,227 @@
+#include "model_store.h"
+#include "nn_model.h"
+#include "config.h"
+
+// Wraps a .tflite flatbuffer and its metadata in a model image for the
+// "model" partition:
+//
+//   model_pack [options] fall_detection_model.tflite model.bin
+//
+// Window shape and quantization come from the flatbuffer itself. The scaler
+// is the training RobustScaler (center_ and scale_, in g and deg/s):
+//
+//   --center c0,...,c5   default 0
+//   --scale s0,...,s5    default 2 g / 250 dps
+//   --clip lo,hi         default [-1, 1], or the int8 input range with --scale
+//   --labels A,B,...     default the built-in labels
+//   --rate hz            default SAMPLE_RATE_HZ
+//   --v1                 flatbuffer only, no metadata
+//
+// and checks an existing image with
+//
+//   model_pack --check model.bin
+
+static uint8_t* read_file(const char* path, size_t* size) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    uint8_t* data = len > 0 ? malloc((size_t)len) : NULL;
+    if (data == NULL || fread(data, 1, (size_t)len, f) != (size_t)len) {
+        fprintf(stderr, "%s: cannot read\n", path);
+        free(data);
+        fclose(f);
+        return NULL;
+    }
+    fclose(f);
+    *size = (size_t)len;
+    return data;
+}
+
+static int parse_floats(const char* arg, float* out, int max) {
+    int n = 0;
+    const char* p = arg;
+    while (*p != '\0' && n < max) {
+        char* end;
+        out[n++] = strtof(p, &end);
+        if (end == p || (*end != ',' && *end != '\0')) {
+            return -1;
+        }
+        p = *end == ',' ? end + 1 : end;
+    }
+    return *p == '\0' ? n : -1;
+}
+
+static int parse_labels(const char* arg, model_meta_t* meta) {
+    int n = 0;
+    const char* p = arg;
+    while (n < MODEL_META_MAX_CLASSES) {
+        size_t len = strcspn(p, ",");
+        if (len == 0 || len >= MODEL_META_LABEL_LEN) {
+            return -1;
+        }
+        memset(meta->labels[n], 0, MODEL_META_LABEL_LEN);
+        memcpy(meta->labels[n++], p, len);
+        if (p[len] == '\0') {
+            return n;
+        }
+        p += len + 1;
+    }
+    return -1;
+}
+
+static void print_meta(const model_meta_t* meta) {
+    printf("  window %u x %u at %u Hz, %u classes\n",
+           meta->seq_len, meta->features, meta->sample_rate_hz, meta->classes);
+    printf("  input q %g/%ld, output q %g/%ld, clip [%g, %g]\n",
+           meta->input_scale, (long)meta->input_zero_point,
+           meta->output_scale, (long)meta->output_zero_point, meta->clip_min, meta->clip_max);
+    for (int f = 0; f < meta->features; f++) {
+        printf("  feature %d: center %g, scale %g\n", f, meta->center[f], meta->scale[f]);
+    }
+    for (int c = 0; c < meta->classes; c++) {
+        printf("  class %d: %s\n", c, meta->labels[c]);
+    }
+}
+
+static int check(const char* path) {
+    model_blob_t blob;
+    esp_err_t ret = model_store_open(path, &blob);
+    if (ret != ESP_OK) {
+        fprintf(stderr, "%s: invalid model image (%s)\n", path, esp_err_to_name(ret));
+        return 1;
+    }
+    printf("%s: %zu byte flatbuffer, CRC OK, %s\n", path, blob.size,
+           blob.has_meta ? "metadata:" : "no metadata");
+    if (blob.has_meta) {
+        print_meta(&blob.meta);
+    }
+    model_store_close(&blob);
+    return 0;
+}
+
+static int usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [--center c,...] [--scale s,...] [--clip lo,hi] [--labels A,...] [--rate hz] [--v1]\n"
+                    "          model.tflite model.bin\n"
+                    "       %s --check model.bin\n", argv0, argv0);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && strcmp(argv[1], "--check") == 0) {
+        return check(argv[2]);
+    }
+
+    model_meta_t meta;
+    model_meta_default(&meta);
+    bool with_meta = true;
+    bool scaled = false;
+    bool clipped = false;
+    int labels = 0;
+
+    int i = 1;
+    for (; i < argc - 2; i++) {
+        const char* opt = argv[i];
+        if (strcmp(opt, "--v1") == 0) {
+            with_meta = false;
+            continue;
+        }
+        if (i + 1 >= argc - 2) {
+            return usage(argv[0]);
+        }
+        const char* arg = argv[++i];
+        float clip[2];
+        if (strcmp(opt, "--center") == 0 && parse_floats(arg, meta.center, MODEL_META_MAX_FEATURES) > 0) {
+            continue;
+        } else if (strcmp(opt, "--scale") == 0 && parse_floats(arg, meta.scale, MODEL_META_MAX_FEATURES) > 0) {
+            scaled = true;
+        } else if (strcmp(opt, "--clip") == 0 && parse_floats(arg, clip, 2) == 2) {
+            meta.clip_min = clip[0];
+            meta.clip_max = clip[1];
+            clipped = true;
+        } else if (strcmp(opt, "--labels") == 0 && (labels = parse_labels(arg, &meta)) > 0) {
+            continue;
+        } else if (strcmp(opt, "--rate") == 0 && atoi(arg) > 0) {
+            meta.sample_rate_hz = (uint16_t)atoi(arg);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (i != argc - 2) {
+        return usage(argv[0]);
+    }
+    const char* in_path = argv[argc - 2];
+    const char* out_path = argv[argc - 1];
+
+    size_t size;
+    uint8_t* payload = read_file(in_path, &size);
+    if (payload == NULL) {
+        return 1;
+    }
+
+    // Shapes and quantization as the firmware will bind them
+    static nn_model_t model;
+    esp_err_t ret = nn_model_load(&model, payload, size);
+    if (ret != ESP_OK) {
+        fprintf(stderr, "%s: not a supported model (%s)\n", in_path, esp_err_to_name(ret));
+        free(payload);
+        return 1;
+    }
+    meta.seq_len = (uint16_t)model.seq_len;
+    meta.features = (uint8_t)model.features;
+    meta.classes = (uint8_t)model.classes;
+    meta.input_scale = model.input_q.scale;
+    meta.input_zero_point = model.input_q.zero_point;
+    meta.output_scale = model.output_q.scale;
+    meta.output_zero_point = model.output_q.zero_point;
+    if (scaled && !clipped) {
+        // A RobustScaler output is unbounded; clamp only to what int8 can hold
+        meta.clip_min = (INT8_MIN - model.input_q.zero_point) * model.input_q.scale;
+        meta.clip_max = (INT8_MAX - model.input_q.zero_point) * model.input_q.scale;
+    }
+    if (labels != 0 && labels != meta.classes) {
+        fprintf(stderr, "%d labels for %d classes\n", labels, model.classes);
+        free(payload);
+        return 1;
+    }
+    if (with_meta && (ret = model_meta_check(&meta)) != ESP_OK) {
+        fprintf(stderr, "invalid metadata (%s)\n", esp_err_to_name(ret));
+        free(payload);
+        return 1;
+    }
+
+    model_image_header_t header;
+    model_image_header_init(&header, payload, size, with_meta ? &meta : NULL);
+    size_t header_bytes = with_meta ? sizeof(header) : MODEL_IMAGE_V1_HEADER_BYTES;
+    size_t meta_offset = model_image_meta_offset(&header);
+    static const uint8_t pad[MODEL_IMAGE_ALIGN];
+
+    FILE* out = fopen(out_path, "wb");
+    if (out == NULL) {
+        perror(out_path);
+        free(payload);
+        return 1;
+    }
+    bool ok = fwrite(&header, header_bytes, 1, out) == 1 &&
+              fwrite(pad, 1, header.header_size - header_bytes, out) == header.header_size - header_bytes &&
+              fwrite(payload, 1, size, out) == size;
+    if (with_meta) {
+        size_t gap = meta_offset - header.header_size - size;
+        ok = ok && fwrite(pad, 1, gap, out) == gap && fwrite(&meta, sizeof(meta), 1, out) == 1;
+    }
+    ok = fclose(out) == 0 && ok;
+    free(payload);
+    if (!ok) {
+        fprintf(stderr, "%s: write failed\n", out_path);
+        return 1;
+    }
+
+    printf("%s: %zu byte flatbuffer, CRC-32 %08lx, image %zu bytes\n", out_path, size,
+           (unsigned long)header.payload_crc32, with_meta ? meta_offset + sizeof(meta) : header.header_size + size);
+    return check(out_path);
+}
@@ -0,0 +1,165 @@
+#include "tflite_inference.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+// Replays a sensor stream through the inference pipeline while models are
+// hot-swapped from another thread, and checks that no sample or window is
+// lost:
+//
+//   model_swap model_a.bin model_b.bin [samples]
+//
+// Three threads stand in for the firmware tasks: the sensor task pushes
+// samples at SWAP_SPEEDUP x real time, the inference task consumes windows,
+// and a staging task loads the two images alternately with
+// tflite_stage_model(). Exits non-zero on any loss.
+
+#define SWAP_SPEEDUP        50
+#define SWAP_DEFAULT_SAMPLES 20000
+#define SWAP_STAGE_EVERY_MS 150
+
+typedef struct {
+    const char* images[2];
+    uint32_t samples;
+    atomic_bool producer_done;
+    uint32_t push_failures;
+    uint32_t staged;
+    uint32_t stage_failures;
+    uint32_t inferences;
+    uint32_t inference_failures;
+} swap_run_t;
+
+// Replayed motion: standing, walking bursts and a fall every 30 s
+static void replay_sample(uint32_t i, mpu6050_data_t* d) {
+    float t = (float)i / SAMPLE_RATE_HZ;
+    uint32_t phase = i % (30 * SAMPLE_RATE_HZ);
+    bool walking = (i / (8 * SAMPLE_RATE_HZ)) % 2 == 1;
+
+    memset(d, 0, sizeof(*d));
+    d->accel_z = 1.0f;
+    if (walking) {
+        d->accel_x = 0.3f * sinf(2.0f * (float)M_PI * 1.8f * t);
+        d->accel_z += 0.2f * sinf(2.0f * (float)M_PI * 3.6f * t);
+        d->gyro_y = 40.0f * sinf(2.0f * (float)M_PI * 1.8f * t);
+    }
+    if (phase >= 20 * SAMPLE_RATE_HZ && phase < 20 * SAMPLE_RATE_HZ + 15) {
+        d->accel_z = 0.1f;                                  // free fall
+    } else if (phase >= 20 * SAMPLE_RATE_HZ + 15 && phase < 20 * SAMPLE_RATE_HZ + 20) {
+        d->accel_x = 3.0f;                                  // impact
+        d->gyro_x = 200.0f;
+    } else if (phase >= 20 * SAMPLE_RATE_HZ + 20 && phase < 24 * SAMPLE_RATE_HZ) {
+        d->accel_x = 1.0f;                                  // lying
+        d->accel_z = 0.0f;
+    }
+    d->timestamp = (uint64_t)i * 1000000 / SAMPLE_RATE_HZ;
+    mpu6050_encode_raw(d);
+}
+
+static void* sensor_task(void* arg) {
+    swap_run_t* run = arg;
+    for (uint32_t i = 0; i < run->samples; i++) {
+        mpu6050_data_t d;
+        replay_sample(i, &d);
+        if (add_sensor_data_to_buffer(&d) != ESP_OK) {
+            run->push_failures++;
+        }
+        usleep(1000000 / SAMPLE_RATE_HZ / SWAP_SPEEDUP);
+    }
+    atomic_store(&run->producer_done, true);
+    return NULL;
+}
+
+static void* inference_task(void* arg) {
+    swap_run_t* run = arg;
+    for (;;) {
+        process_sensor_samples();
+        if (!g_data_buffer.window_ready) {
+            if (atomic_load(&run->producer_done) && spsc_ring_count(&g_sample_ring) == 0) {
+                break;
+            }
+            usleep(100);
+            continue;
+        }
+        if (!inference_window_due()) {
+            skip_inference_window();
+            continue;
+        }
+        inference_result_t result;
+        esp_err_t ret = run_inference(&result);
+        if (ret == ESP_OK) {
+            run->inferences++;
+        } else if (ret != ESP_ERR_INVALID_STATE) {
+            run->inference_failures++;
+        }
+    }
+    return NULL;
+}
+
+static void* staging_task(void* arg) {
+    swap_run_t* run = arg;
+    while (!atomic_load(&run->producer_done)) {
+        usleep(SWAP_STAGE_EVERY_MS * 1000);
+        if (tflite_model_swap_pending()) {
+            continue;
+        }
+        const char* image = run->images[run->staged % 2];
+        if (strcmp(image, tflite_active_model_location()) == 0) {
+            image = run->images[(run->staged + 1) % 2];
+        }
+        if (tflite_stage_model(image) == ESP_OK) {
+            run->staged++;
+        } else {
+            run->stage_failures++;
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s model_a.bin model_b.bin [samples]\n", argv[0]);
+        return 2;
+    }
+
+    static swap_run_t run;
+    run.images[0] = argv[1];
+    run.images[1] = argv[2];
+    run.samples = argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 10) : SWAP_DEFAULT_SAMPLES;
+    atomic_init(&run.producer_done, false);
+
+    if (tflite_init() != ESP_OK) {
+        return 1;
+    }
+
+    pthread_t threads[3];
+    pthread_create(&threads[0], NULL, inference_task, &run);
+    pthread_create(&threads[1], NULL, staging_task, &run);
+    pthread_create(&threads[2], NULL, sensor_task, &run);
+    for (int i = 0; i < 3; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    uint32_t window_len = tflite_model_meta()->seq_len;
+    uint32_t expected_windows = run.samples >= window_len ? (run.samples - window_len) / INFERENCE_HOP_SIZE + 1 : 0;
+    uint32_t swaps = tflite_model_swaps();
+    bool pass = run.push_failures == 0 && g_sample_ring.dropped == 0 &&
+                g_data_buffer.total_samples == run.samples &&
+                g_data_buffer.windows_dropped == 0 && g_data_buffer.windows_emitted == expected_windows &&
+                run.inference_failures == 0 && run.stage_failures == 0 && swaps > 0;
+
+    printf("\nModel swap replay: %lu samples at %dx real time\n", (unsigned long)run.samples, SWAP_SPEEDUP);
+    printf("  samples: %lu consumed, %lu push failures, %lu ring drops\n",
+           (unsigned long)g_data_buffer.total_samples, (unsigned long)run.push_failures,
+           (unsigned long)g_sample_ring.dropped);
+    printf("  windows: %lu emitted (%lu expected), %lu dropped\n",
+           (unsigned long)g_data_buffer.windows_emitted, (unsigned long)expected_windows,
+           (unsigned long)g_data_buffer.windows_dropped);
+    printf("  inferences: %lu, %lu failed\n",
+           (unsigned long)run.inferences, (unsigned long)run.inference_failures);
+    printf("  models: %lu staged, %lu failed, %lu swaps, active '%s'\n",
+           (unsigned long)run.staged, (unsigned long)run.stage_failures, (unsigned long)swaps,
+           tflite_active_model_location());
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,358 @@
+#include "mpu6050_sim.h"
+
+// Registers the driver does not name
+#define REG_ACCEL_XOUT_H  MPU6050_REG_ACCEL_XOUT_H
+#define REG_FIFO_COUNTL   (MPU6050_REG_FIFO_COUNTH + 1)
+
+#define PWR_MGMT_1_RESET  0x80
+#define PWR_MGMT_1_SLEEP  0x40
+#define USER_CTRL_FIFO_RST 0x04
+#define INT_DATA_RDY      0x01
+
+// FIFO_EN bits, in the order the sensor writes them
+#define FIFO_EN_TEMP      0x80
+#define FIFO_EN_XG        0x40
+#define FIFO_EN_YG        0x20
+#define FIFO_EN_ZG        0x10
+#define FIFO_EN_ACCEL     0x08
+
+static void power_on_reset(mpu6050_sim_t* sim) {
+    memset(sim->regs, 0, sizeof(sim->regs));
+    sim->regs[MPU6050_REG_PWR_MGMT_1] = PWR_MGMT_1_SLEEP;
+    sim->regs[MPU6050_REG_WHO_AM_I] = MPU6050_WHO_AM_I_VALUE;
+    sim->fifo_head = 0;
+    sim->fifo_count = 0;
+}
+
+static void fifo_push(mpu6050_sim_t* sim, uint8_t byte) {
+    if (sim->fifo_count == MPU6050_FIFO_SIZE) {
+        // Full: the oldest byte is overwritten
+        sim->fifo_head = (uint16_t)((sim->fifo_head + 1) % MPU6050_FIFO_SIZE);
+        sim->fifo_count--;
+        if (!(sim->regs[MPU6050_REG_INT_STATUS] & MPU6050_INT_FIFO_OFLOW)) {
+            sim->stats.fifo_overflows++;
+        }
+        sim->regs[MPU6050_REG_INT_STATUS] |= MPU6050_INT_FIFO_OFLOW;
+    }
+    sim->fifo[(sim->fifo_head + sim->fifo_count) % MPU6050_FIFO_SIZE] = byte;
+    sim->fifo_count++;
+}
+
+static uint8_t fifo_pop(mpu6050_sim_t* sim) {
+    if (sim->fifo_count == 0) {
+        return 0xFF;
+    }
+    uint8_t byte = sim->fifo[sim->fifo_head];
+    sim->fifo_head = (uint16_t)((sim->fifo_head + 1) % MPU6050_FIFO_SIZE);
+    sim->fifo_count--;
+    return byte;
+}
+
+static void put_s16(uint8_t* dst, float v) {
+    int16_t r = mpu6050_saturate_s16(v);
+    dst[0] = (uint8_t)((uint16_t)r >> 8);
+    dst[1] = (uint8_t)r;
+}
+
+static int64_t sample_period_us(const mpu6050_sim_t* sim) {
+    int dlpf = sim->regs[MPU6050_REG_CONFIG] & 0x07;
+    int rate = dlpf == 0 || dlpf == 7 ? MPU6050_SIM_BASE_RATE_HZ : MPU6050_GYRO_RATE_DLPF_HZ;
+    return (int64_t)1000000 * (1 + sim->regs[MPU6050_REG_SMPLRT_DIV]) / rate;
+}
+
+// Sample clock, in ISR context
+static int64_t sample_tick(void* arg, int64_t due_us) {
+    mpu6050_sim_t* sim = arg;
+    if (sim->regs[MPU6050_REG_PWR_MGMT_1] & PWR_MGMT_1_SLEEP) {
+        return due_us + sample_period_us(sim);
+    }
+
+    float accel[3];
+    float gyro[3];
+    sim->source(sim->source_ctx, due_us, accel, gyro);
+    sim->stats.samples++;
+
+    // Sensitivity halves with every full-scale step
+    float accel_lsb = MPU6050_ACCEL_LSB_PER_G / (float)(1 << ((sim->regs[MPU6050_REG_ACCEL_CONFIG] >> 3) & 3));
+    float gyro_lsb = MPU6050_GYRO_LSB_PER_DPS / (float)(1 << ((sim->regs[MPU6050_REG_GYRO_CONFIG] >> 3) & 3));
+    uint8_t* out = &sim->regs[REG_ACCEL_XOUT_H];
+    for (int i = 0; i < 3; i++) {
+        put_s16(&out[2 * i], accel[i] * accel_lsb);
+        put_s16(&out[8 + 2 * i], gyro[i] * gyro_lsb);
+    }
+    put_s16(&out[6], (25.0f - 36.53f) * 340.0f);
+
+    if (sim->regs[MPU6050_REG_USER_CTRL] & MPU6050_USER_CTRL_FIFO_EN) {
+        uint8_t sources = sim->regs[MPU6050_REG_FIFO_EN];
+        static const uint8_t order[] = { FIFO_EN_TEMP, FIFO_EN_XG, FIFO_EN_YG, FIFO_EN_ZG };
+        if (sources & FIFO_EN_ACCEL) {
+            for (int i = 0; i < 6; i++) {
+                fifo_push(sim, out[i]);
+            }
+        }
+        for (int s = 0; s < 4; s++) {
+            if (sources & order[s]) {
+                fifo_push(sim, out[6 + 2 * s]);
+                fifo_push(sim, out[7 + 2 * s]);
+            }
+        }
+    }
+
+    sim->regs[MPU6050_REG_INT_STATUS] |= INT_DATA_RDY;
+    if (sim->regs[MPU6050_REG_INT_ENABLE] & sim->regs[MPU6050_REG_INT_STATUS]) {
+        // 50 us pulse, only the rising edge matters to the driver
+        osal_gpio_set_level(MPU6050_INT_PIN, 1);
+        osal_gpio_set_level(MPU6050_INT_PIN, 0);
+    }
+    return due_us + sample_period_us(sim);
+}
+
+static void write_register(mpu6050_sim_t* sim, uint8_t reg, uint8_t value) {
+    switch (reg) {
+        case MPU6050_REG_WHO_AM_I:
+        case MPU6050_REG_INT_STATUS:
+            return;             // read only
+        case MPU6050_REG_PWR_MGMT_1:
+            if (value & PWR_MGMT_1_RESET) {
+                power_on_reset(sim);
+                return;
+            }
+            break;
+        case MPU6050_REG_USER_CTRL:
+            if (value & USER_CTRL_FIFO_RST) {
+                sim->fifo_head = 0;
+                sim->fifo_count = 0;
+                value &= (uint8_t)~USER_CTRL_FIFO_RST;
+            }
+            break;
+        case MPU6050_REG_FIFO_R_W:
+            fifo_push(sim, value);
+            return;
+        default:
+            break;
+    }
+    sim->regs[reg] = value;
+}
+
+static uint8_t read_register(mpu6050_sim_t* sim, uint8_t reg) {
+    switch (reg) {
+        case MPU6050_REG_FIFO_COUNTH:
+            // Latched so a burst read of both bytes is consistent
+            sim->fifo_count_latch = sim->fifo_count;
+            return (uint8_t)(sim->fifo_count_latch >> 8);
+        case REG_FIFO_COUNTL:
+            return (uint8_t)sim->fifo_count_latch;
+        case MPU6050_REG_FIFO_R_W:
+            return fifo_pop(sim);
+        case MPU6050_REG_INT_STATUS: {
+            uint8_t status = sim->regs[reg];
+            sim->regs[reg] = 0;
+            return status;
+        }
+        default:
+            return sim->regs[reg];
+    }
+}
+
+static uint32_t fault_random(mpu6050_sim_t* sim) {
+    sim->fault_state = sim->fault_state * 1664525u + 1013904223u;
+    return sim->fault_state >> 8;
+}
+
+// Address byte, in task context: the task blocks for any clock stretching
+static bool bus_start(void* ctx, bool read) {
+    mpu6050_sim_t* sim = ctx;
+    sim->stats.bytes_written++;
+    const mpu6050_sim_faults_t* f = &sim->faults;
+    if (f->nack_rate > 0.0f && (float)fault_random(sim) < f->nack_rate * (float)(1u << 24)) {
+        sim->stats.nacks++;
+        return false;
+    }
+    uint32_t stretch = f->stretch_us;
+    if (f->stretch_jitter_us > 0) {
+        stretch += fault_random(sim) % (f->stretch_jitter_us + 1);
+    }
+    if (stretch > 0) {
+        sim->stats.stretch_us += stretch;
+        osal_sleep_us(stretch);
+    }
+    sim->pointer_next = !read;
+    return true;
+}
+
+static bool bus_write(void* ctx, uint8_t data) {
+    mpu6050_sim_t* sim = ctx;
+    sim->stats.bytes_written++;
+    if (sim->pointer_next) {
+        sim->pointer = data & 0x7F;
+        sim->pointer_next = false;
+        return true;
+    }
+    write_register(sim, sim->pointer, data);
+    sim->pointer = (sim->pointer + 1) & 0x7F;
+    return true;
+}
+
+// A stall holds SCL low before the byte is shifted out: the bytes before it
+// have left the FIFO, this one has not
+static bool bus_read(void* ctx, uint8_t* data) {
+    mpu6050_sim_t* sim = ctx;
+    const mpu6050_sim_faults_t* f = &sim->faults;
+    if (f->stall_rate > 0.0f && (float)fault_random(sim) < f->stall_rate * (float)(1u << 24)) {
+        sim->stats.stalls++;
+        return false;
+    }
+    sim->stats.bytes_read++;
+    *data = read_register(sim, sim->pointer);
+    // Burst reads of FIFO_R_W keep draining the FIFO
+    if (sim->pointer != MPU6050_REG_FIFO_R_W) {
+        sim->pointer = (sim->pointer + 1) & 0x7F;
+    }
+    return true;
+}
+
+static void bus_stop(void* ctx) {
+    mpu6050_sim_t* sim = ctx;
+    sim->stats.transactions++;
+}
+
+// Bus time of a transfer at MPU6050_I2C_FREQ, as the OSAL charges a command
+// link: one bit per START and for the STOP (not sent after a NACK or a
+// stall), nine per byte that went through
+static void transport_wait(const mpu6050_sim_t* sim, uint32_t bytes_before, int starts, bool stopped) {
+    int64_t bytes = (int64_t)(sim->stats.bytes_written + sim->stats.bytes_read - bytes_before);
+    int64_t bits = starts + (stopped ? 1 : 0) + 9 * bytes;
+    osal_sleep_us((bits * 1000000 + MPU6050_I2C_FREQ - 1) / MPU6050_I2C_FREQ);
+}
+
+static esp_err_t transport_read(void* ctx, uint8_t reg, uint8_t* data, size_t len) {
+    mpu6050_sim_t* sim = ctx;
+    uint32_t bytes_before = sim->stats.bytes_written + sim->stats.bytes_read;
+    int starts = 1;
+    bool ack = bus_start(sim, false) && bus_write(sim, reg);
+    if (ack) {
+        starts++;
+        ack = bus_start(sim, true);
+    }
+    bool stalled = false;
+    for (size_t i = 0; ack && !stalled && i < len; i++) {
+        stalled = !bus_read(sim, &data[i]);
+    }
+    bus_stop(sim);
+    transport_wait(sim, bytes_before, starts, ack && !stalled);
+    if (stalled) {
+        return ESP_ERR_TIMEOUT;
+    }
+    return ack ? ESP_OK : ESP_FAIL;
+}
+
+static esp_err_t transport_write(void* ctx, uint8_t reg, const uint8_t* data, size_t len) {
+    mpu6050_sim_t* sim = ctx;
+    uint32_t bytes_before = sim->stats.bytes_written + sim->stats.bytes_read;
+    bool ack = bus_start(sim, false) && bus_write(sim, reg);
+    for (size_t i = 0; ack && i < len; i++) {
+        ack = bus_write(sim, data[i]);
+    }
+    bus_stop(sim);
+    transport_wait(sim, bytes_before, 1, ack);
+    return ack ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t mpu6050_sim_init(mpu6050_sim_t* sim, mpu6050_sim_source_fn source, void* ctx) {
+    if (sim == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(sim, 0, sizeof(*sim));
+    power_on_reset(sim);
+    sim->source = source != NULL ? source : mpu6050_sim_synthetic;
+    sim->source_ctx = ctx;
+    return osal_timer_start(sample_period_us(sim), sample_tick, sim);
+}
+
+esp_err_t mpu6050_sim_attach(mpu6050_sim_t* sim, mpu6050_sim_source_fn source, void* ctx) {
+    esp_err_t ret = mpu6050_sim_init(sim, source, ctx);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    osal_i2c_device_t device = {
+        .address = MPU6050_I2C_ADDR,
+        .ctx = sim,
+        .start = bus_start,
+        .write = bus_write,
+        .read = bus_read,
+        .stop = bus_stop,
+    };
+    return osal_i2c_attach(MPU6050_I2C_PORT, &device);
+}
+
+void mpu6050_sim_transport(mpu6050_sim_t* sim, mpu6050_transport_t* transport) {
+    *transport = (mpu6050_transport_t){
+        .read = transport_read,
+        .write = transport_write,
+        .ctx = sim,
+    };
+}
+
+void mpu6050_sim_set_faults(mpu6050_sim_t* sim, const mpu6050_sim_faults_t* faults) {
+    sim->faults = *faults;
+    sim->fault_state = faults->seed;
+}
+
+static uint32_t noise_state = 1;
+
+static float noise(float amplitude) {
+    noise_state = noise_state * 1664525u + 1013904223u;
+    return amplitude * ((float)(noise_state >> 8) / (float)(1u << 24) - 0.5f);
+}
+
+void mpu6050_sim_synthetic(void* ctx, int64_t t_us, float accel_g[3], float gyro_dps[3]) {
+    const float two_pi = 2.0f * (float)M_PI;
+    float s = (float)(t_us % ((int64_t)MPU6050_SIM_FALL_PERIOD_S * 1000000)) / 1e6f;
+    float p = s / MPU6050_SIM_FALL_PERIOD_S;
+
+    // Upright, gravity on Z
+    float a[3] = { 0.0f, 0.0f, 1.0f };
+    float g[3] = { 0.0f, 0.0f, 0.0f };
+    if (p >= 0.3f && p < 0.65f) {
+        // Walking at 1.8 steps per second
+        float phase = two_pi * 1.8f * s;
+        a[0] = 0.25f * sinf(phase);
+        a[2] = 1.0f + 0.3f * sinf(2.0f * phase);
+        g[1] = 40.0f * sinf(phase);
+    } else if (p >= 0.65f) {
+        float f = s - 0.65f * MPU6050_SIM_FALL_PERIOD_S;
+        if (f < 0.4f) {
+            // Free fall while rotating forward
+            a[2] = 0.15f;
+            g[0] = 200.0f;
+        } else if (f < 0.6f) {
+            // Impact
+            a[0] = 2.5f;
+            a[2] = -1.5f;
+            g[0] = -120.0f;
+        } else {
+            // Lying on the side, gravity on X
+            a[0] = 1.0f;
+            a[2] = 0.05f;
+        }
+    }
+
+    for (int i = 0; i < 3; i++) {
+        accel_g[i] = a[i] + noise(0.02f);
+        gyro_dps[i] = g[i] + noise(1.0f);
+    }
+}
+
+void mpu6050_sim_trace(void* ctx, int64_t t_us, float accel_g[3], float gyro_dps[3]) {
+    mpu6050_sim_trace_t* trace = ctx;
+    while (trace->next_us <= t_us && trace_replay_read(&trace->replay, &trace->sample) == ESP_OK) {
+        trace->next_us += 1000000 / trace->replay.sample_rate_hz;
+    }
+    const mpu6050_data_t* d = &trace->sample;
+    accel_g[0] = d->accel_x;
+    accel_g[1] = d->accel_y;
+    accel_g[2] = d->accel_z;
+    gyro_dps[0] = d->gyro_x;
+    gyro_dps[1] = d->gyro_y;
+    gyro_dps[2] = d->gyro_z;
+}
@@ -0,0 +1,98 @@
+#ifndef MPU6050_SIM_H
+#define MPU6050_SIM_H
+
+#include "osal.h"
+#include "mpu6050_driver.h"
+#include "trace_replay.h"
+
+// MPU6050 on the host OSAL's I2C bus: a register file the unmodified driver
+// (src/mpu6050_driver.c) talks to. The sample clock is an OSAL timer at the
+// rate CONFIG/SMPLRT_DIV select; each sample updates the data registers,
+// feeds the FIFO as FIFO_EN selects (dropping the oldest bytes and flagging
+// FIFO_OFLOW when full) and pulses the INT pin on DATA_RDY.
+//
+// Motion comes from a source callback: the built-in synthetic one below, or
+// a recorded trace (mpu6050_sim_trace).
+//
+// The driver reaches it either through the OSAL's I2C command links
+// (mpu6050_sim_attach, the path fall_sim takes) or directly as its transport
+// (mpu6050_sim_transport), which skips the command-link replay. Both run the
+// same bus state machine, charge the same bus time and inject the same
+// faults:
+//  - NACKs on the address byte: no register is touched by the failed transfer
+//  - clock stretching after the address byte
+//  - stalls part way through a read: SCL held low until the master times
+//    out (ESP_ERR_TIMEOUT), after the bytes before it were read, so a FIFO
+//    burst has already drained them
+
+#define MPU6050_SIM_BASE_RATE_HZ   8000     // gyro output rate, DLPF off
+#define MPU6050_SIM_FALL_PERIOD_S  60       // synthetic source: one fall per period
+
+// One sample of motion in physical units at t_us
+typedef void (*mpu6050_sim_source_fn)(void* ctx, int64_t t_us, float accel_g[3], float gyro_dps[3]);
+
+typedef struct {
+    uint32_t samples;           // sample clock ticks while awake
+    uint32_t fifo_overflows;
+    uint32_t transactions;      // START ... STOP, NACKed ones included
+    uint32_t bytes_written;     // on the wire: address, register and data bytes
+    uint32_t bytes_read;
+    uint32_t nacks;             // injected
+    uint32_t stalls;            // injected
+    uint64_t stretch_us;        // injected
+} mpu6050_sim_stats_t;
+
+// Faults, drawn from a seeded generator so runs repeat
+typedef struct {
+    float nack_rate;            // probability an address byte is NACKed
+    uint32_t stretch_us;        // clock stretching after every address byte
+    uint32_t stretch_jitter_us; // plus uniform 0..jitter
+    float stall_rate;           // probability the bus stalls before a read byte
+    uint32_t seed;
+} mpu6050_sim_faults_t;
+
+typedef struct {
+    uint8_t regs[128];
+    uint8_t pointer;
+    bool pointer_next;          // next written byte is the register address
+    uint16_t fifo_count_latch;
+
+    uint8_t fifo[MPU6050_FIFO_SIZE];
+    uint16_t fifo_head;
+    uint16_t fifo_count;
+
+    mpu6050_sim_source_fn source;
+    void* source_ctx;
+    mpu6050_sim_faults_t faults;
+    uint32_t fault_state;
+    mpu6050_sim_stats_t stats;
+} mpu6050_sim_t;
+
+// Powers the sensor on and starts its sample clock. source NULL uses
+// mpu6050_sim_synthetic().
+esp_err_t mpu6050_sim_init(mpu6050_sim_t* sim, mpu6050_sim_source_fn source, void* ctx);
+
+// mpu6050_sim_init(), then attaches the sensor at MPU6050_I2C_ADDR on
+// MPU6050_I2C_PORT for the driver's default transport
+esp_err_t mpu6050_sim_attach(mpu6050_sim_t* sim, mpu6050_sim_source_fn source, void* ctx);
+
+// Transport for mpu6050_set_transport(), bus time at MPU6050_I2C_FREQ
+void mpu6050_sim_transport(mpu6050_sim_t* sim, mpu6050_transport_t* transport);
+
+void mpu6050_sim_set_faults(mpu6050_sim_t* sim, const mpu6050_sim_faults_t* faults);
+
+// Standing still, with walking bouts and one fall every
+// MPU6050_SIM_FALL_PERIOD_S
+void mpu6050_sim_synthetic(void* ctx, int64_t t_us, float accel_g[3], float gyro_dps[3]);
+
+// Recorded motion: the trace sample current at t_us. Open replay (looped)
+// and pass the struct as the source context.
+typedef struct {
+    trace_replay_t replay;
+    mpu6050_data_t sample;
+    int64_t next_us;
+} mpu6050_sim_trace_t;
+
+void mpu6050_sim_trace(void* ctx, int64_t t_us, float accel_g[3], float gyro_dps[3]);
+
+#endif // MPU6050_SIM_H
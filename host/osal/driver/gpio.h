@@ -0,0 +1,7 @@
+#ifndef OSAL_DRIVER_GPIO_H
+#define OSAL_DRIVER_GPIO_H
+
+// Host stand-in for the ESP-IDF header, see osal.h
+#include "osal.h"
+
+#endif // OSAL_DRIVER_GPIO_H
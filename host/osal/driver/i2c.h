@@ -0,0 +1,7 @@
+#ifndef OSAL_DRIVER_I2C_H
+#define OSAL_DRIVER_I2C_H
+
+// Host stand-in for the ESP-IDF header, see osal.h
+#include "osal.h"
+
+#endif // OSAL_DRIVER_I2C_H
@@ -0,0 +1,7 @@
+#ifndef OSAL_ESP_ATTR_H
+#define OSAL_ESP_ATTR_H
+
+// Host stand-in for the ESP-IDF header, see osal.h
+#include "osal.h"
+
+#endif // OSAL_ESP_ATTR_H
@@ -0,0 +1,7 @@
+#ifndef OSAL_ESP_SYSTEM_H
+#define OSAL_ESP_SYSTEM_H
+
+// Host stand-in for the ESP-IDF header, see osal.h
+#include "osal.h"
+
+#endif // OSAL_ESP_SYSTEM_H
@@ -0,0 +1,7 @@
+#ifndef OSAL_FREERTOS_QUEUE_H
+#define OSAL_FREERTOS_QUEUE_H
+
+// Host stand-in for the ESP-IDF header, see osal.h
+#include "osal.h"
+
+#endif // OSAL_FREERTOS_QUEUE_H
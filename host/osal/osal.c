@@ -0,0 +1,493 @@
+#include "osal.h"
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Scheduler and virtual clock of the host OSAL (see osal.h). Everything below
+// runs under `big`; a task owns it while it runs and gives it up only inside
+// reschedule().
+
+#define OSAL_MAX_TASKS 16
+#define OSAL_HEAP_SIZE (320 * 1024)         // reported by esp_get_free_heap_size()
+
+typedef enum {
+    TASK_READY,
+    TASK_RUNNING,
+    TASK_BLOCKED,
+    TASK_DELETED,
+} task_state_t;
+
+struct tskTaskControlBlock {
+    pthread_t thread;
+    pthread_cond_t cond;
+    char name[16];
+    UBaseType_t priority;
+    TaskFunction_t fn;
+    void* param;
+
+    task_state_t state;
+    uint64_t ready_seq;                     // FIFO order among equal priorities
+    const void* waiting_on;                 // object a blocked task waits for
+    int64_t wake_at;                        // timeout, INT64_MAX for none
+    bool timed_out;
+    uint32_t notify;
+};
+
+struct osal_queue {
+    uint8_t* storage;
+    UBaseType_t item_size;
+    UBaseType_t length;
+    UBaseType_t count;
+    UBaseType_t head;
+};
+
+typedef struct {
+    int64_t due_us;
+    osal_timer_fn_t fn;
+    void* arg;
+} osal_timer_t;
+
+static pthread_mutex_t big = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t stopped_cond = PTHREAD_COND_INITIALIZER;
+
+static struct tskTaskControlBlock tasks[OSAL_MAX_TASKS];
+static int task_count = 0;
+static struct tskTaskControlBlock* current = NULL;
+static uint64_t ready_seq = 0;
+
+static osal_timer_t timers[OSAL_MAX_TIMERS];
+static int timer_count = 0;
+static bool in_isr = false;
+static int64_t isr_now_us = 0;              // clock seen by the running timer
+
+static osal_config_t config = { .duration_us = 0, .cpu_scale = 1.0, .log_level = 'I' };
+static int64_t now_us = 0;                  // virtual clock at the last switch
+static int64_t slice_start_ns = 0;          // host time the running task got the CPU
+static int64_t cpu_ns = 0;
+static bool stopped = false;
+
+static int64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int64_t slice_us(void) {
+    if (current == NULL || in_isr || config.cpu_scale <= 0.0) {
+        return 0;
+    }
+    return (int64_t)((double)(host_ns() - slice_start_ns) * config.cpu_scale / 1000.0);
+}
+
+// Moves the running task's CPU time onto the clock
+static void charge_cpu(void) {
+    if (current == NULL) {
+        return;
+    }
+    int64_t t = host_ns();
+    if (config.cpu_scale > 0.0) {
+        now_us += (int64_t)((double)(t - slice_start_ns) * config.cpu_scale / 1000.0);
+    }
+    cpu_ns += t - slice_start_ns;
+    slice_start_ns = t;
+}
+
+static void make_ready(struct tskTaskControlBlock* t) {
+    t->state = TASK_READY;
+    t->ready_seq = ready_seq++;
+    t->waiting_on = NULL;
+    t->wake_at = INT64_MAX;
+}
+
+static void wake_waiters(const void* object) {
+    for (int i = 0; i < task_count; i++) {
+        if (tasks[i].state == TASK_BLOCKED && tasks[i].waiting_on == object) {
+            make_ready(&tasks[i]);
+        }
+    }
+}
+
+// Timers and timeouts due at or before now_us
+static void fire_due(void) {
+    bool fired = true;
+    while (fired) {
+        fired = false;
+        osal_timer_t* next = NULL;
+        for (int i = 0; i < timer_count; i++) {
+            if (timers[i].fn != NULL && timers[i].due_us <= now_us &&
+                (next == NULL || timers[i].due_us < next->due_us)) {
+                next = &timers[i];
+            }
+        }
+        if (next != NULL) {
+            // Interrupts preempt on hardware: the handler sees its own due time
+            // even when the task it interrupted overran it
+            in_isr = true;
+            isr_now_us = next->due_us;
+            int64_t due = next->fn(next->arg, next->due_us);
+            in_isr = false;
+            if (due < 0) {
+                next->fn = NULL;
+            } else {
+                next->due_us = due > next->due_us ? due : next->due_us + 1;
+            }
+            fired = true;
+        }
+    }
+
+    for (int i = 0; i < task_count; i++) {
+        if (tasks[i].state == TASK_BLOCKED && tasks[i].wake_at <= now_us) {
+            make_ready(&tasks[i]);
+            tasks[i].timed_out = true;
+        }
+    }
+}
+
+static struct tskTaskControlBlock* pick_ready(void) {
+    struct tskTaskControlBlock* best = NULL;
+    for (int i = 0; i < task_count; i++) {
+        struct tskTaskControlBlock* t = &tasks[i];
+        if (t->state == TASK_READY &&
+            (best == NULL || t->priority > best->priority ||
+             (t->priority == best->priority && t->ready_seq < best->ready_seq))) {
+            best = t;
+        }
+    }
+    return best;
+}
+
+static int64_t next_event_us(void) {
+    int64_t next = INT64_MAX;
+    for (int i = 0; i < timer_count; i++) {
+        if (timers[i].fn != NULL && timers[i].due_us < next) {
+            next = timers[i].due_us;
+        }
+    }
+    for (int i = 0; i < task_count; i++) {
+        if (tasks[i].state == TASK_BLOCKED && tasks[i].wake_at < next) {
+            next = tasks[i].wake_at;
+        }
+    }
+    return next;
+}
+
+// Parks the calling thread until the scheduler hands it the CPU again; self
+// is NULL for the thread that starts the run
+static void reschedule(struct tskTaskControlBlock* self) {
+    charge_cpu();
+
+    struct tskTaskControlBlock* next = NULL;
+    while (!stopped) {
+        fire_due();
+        next = pick_ready();
+        if (next != NULL) {
+            break;
+        }
+
+        // Idle: jump to the next event
+        int64_t event = next_event_us();
+        if (event == INT64_MAX) {
+            osal_log('E', "OSAL", "All tasks blocked with nothing pending, stopping");
+        }
+        if (event == INT64_MAX || event >= config.duration_us) {
+            now_us = event == INT64_MAX ? now_us : config.duration_us;
+            stopped = true;
+            current = NULL;
+            pthread_cond_broadcast(&stopped_cond);
+            break;
+        }
+        now_us = event;
+    }
+
+    if (!stopped) {
+        next->state = TASK_RUNNING;
+        current = next;
+        slice_start_ns = host_ns();
+        pthread_cond_signal(&next->cond);
+    }
+    if (self == NULL) {
+        return;
+    }
+    while (current != self || stopped) {
+        pthread_cond_wait(&self->cond, &big);
+    }
+}
+
+// Blocks the running task on object (NULL: just sleep) until woken or until
+// deadline. Returns false on timeout.
+static bool block(const void* object, int64_t deadline) {
+    struct tskTaskControlBlock* self = current;
+    self->state = TASK_BLOCKED;
+    self->waiting_on = object;
+    self->wake_at = deadline;
+    self->timed_out = false;
+    reschedule(self);
+    return !self->timed_out;
+}
+
+static int64_t deadline_after(TickType_t ticks) {
+    if (ticks == portMAX_DELAY) {
+        return INT64_MAX;
+    }
+    return osal_now_us() + (int64_t)ticks * (1000000 / configTICK_RATE_HZ);
+}
+
+static void* task_main(void* arg) {
+    struct tskTaskControlBlock* self = arg;
+    pthread_mutex_lock(&big);
+    while (current != self || stopped) {
+        pthread_cond_wait(&self->cond, &big);
+    }
+    self->fn(self->param);
+
+    // FreeRTOS tasks must not return; treat it as vTaskDelete(NULL)
+    self->state = TASK_DELETED;
+    reschedule(self);
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack_depth, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core) {
+    if (fn == NULL || task_count >= OSAL_MAX_TASKS) {
+        return pdFAIL;
+    }
+    struct tskTaskControlBlock* t = &tasks[task_count];
+    memset(t, 0, sizeof(*t));
+    pthread_cond_init(&t->cond, NULL);
+    snprintf(t->name, sizeof(t->name), "%s", name != NULL ? name : "task");
+    t->priority = priority;
+    t->fn = fn;
+    t->param = param;
+    make_ready(t);
+
+    // Host threads need more than the FreeRTOS stack depth
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, 1024 * 1024);
+    int err = pthread_create(&t->thread, &attr, task_main, t);
+    pthread_attr_destroy(&attr);
+    if (err != 0) {
+        return pdFAIL;
+    }
+    task_count++;
+    if (handle != NULL) {
+        *handle = t;
+    }
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack_depth, void* param,
+                       UBaseType_t priority, TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(fn, name, stack_depth, param, priority, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    struct tskTaskControlBlock* t = task != NULL ? task : current;
+    t->state = TASK_DELETED;
+    if (t == current) {
+        reschedule(t);
+    }
+}
+
+void vTaskDelay(TickType_t ticks) {
+    if (ticks == 0) {
+        taskYIELD();
+        return;
+    }
+    block(NULL, deadline_after(ticks));
+}
+
+void vTaskDelayUntil(TickType_t* previous_wake, TickType_t increment) {
+    TickType_t wake = *previous_wake + increment;
+    *previous_wake = wake;
+    int64_t wake_us = (int64_t)wake * (1000000 / configTICK_RATE_HZ);
+    if (wake_us > osal_now_us()) {
+        block(NULL, wake_us);
+    }
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)(osal_now_us() / (1000000 / configTICK_RATE_HZ));
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return current;
+}
+
+void taskYIELD(void) {
+    struct tskTaskControlBlock* self = current;
+    make_ready(self);
+    reschedule(self);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks) {
+    struct tskTaskControlBlock* self = current;
+    if (self->notify == 0 && ticks > 0) {
+        block(&self->notify, deadline_after(ticks));
+    }
+    uint32_t value = self->notify;
+    if (value > 0) {
+        self->notify = clear_on_exit ? 0 : value - 1;
+    }
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    task->notify++;
+    if (task->state == TASK_BLOCKED && task->waiting_on == &task->notify) {
+        make_ready(task);
+    }
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higher_priority_woken) {
+    xTaskNotifyGive(task);
+    if (higher_priority_woken != NULL) {
+        *higher_priority_woken = pdFALSE;
+    }
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    struct osal_queue* q = calloc(1, sizeof(*q));
+    if (q == NULL) {
+        return NULL;
+    }
+    q->storage = malloc((size_t)length * item_size);
+    if (q->storage == NULL) {
+        free(q);
+        return NULL;
+    }
+    q->length = length;
+    q->item_size = item_size;
+    return q;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t ticks) {
+    int64_t deadline = deadline_after(ticks);
+    while (q->count == q->length) {
+        if (ticks == 0 || !block(q, deadline)) {
+            return errQUEUE_FULL;
+        }
+    }
+    memcpy(q->storage + (size_t)((q->head + q->count) % q->length) * q->item_size, item, q->item_size);
+    q->count++;
+    wake_waiters(q);
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void* item, TickType_t ticks) {
+    int64_t deadline = deadline_after(ticks);
+    while (q->count == 0) {
+        if (ticks == 0 || !block(q, deadline)) {
+            return pdFALSE;
+        }
+    }
+    memcpy(item, q->storage + (size_t)q->head * q->item_size, q->item_size);
+    q->head = (q->head + 1) % q->length;
+    q->count--;
+    wake_waiters(q);
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+    return q->count;
+}
+
+void esp_restart(void) {
+    osal_log('E', "OSAL", "esp_restart() at %.3f s", (double)osal_now_us() / 1e6);
+    exit(1);
+}
+
+// No heap accounting on the host: the ESP32-S3 internal RAM budget
+uint32_t esp_get_free_heap_size(void) {
+    return OSAL_HEAP_SIZE;
+}
+
+uint32_t esp_get_minimum_free_heap_size(void) {
+    return OSAL_HEAP_SIZE;
+}
+
+int64_t esp_timer_get_time(void) {
+    return osal_now_us();
+}
+
+int64_t osal_now_us(void) {
+    if (in_isr) {
+        return isr_now_us;
+    }
+    return now_us + slice_us();
+}
+
+void osal_sleep_us(int64_t us) {
+    if (us > 0) {
+        block(NULL, osal_now_us() + us);
+    }
+}
+
+int64_t osal_cpu_us(void) {
+    return cpu_ns / 1000;
+}
+
+esp_err_t osal_timer_start(int64_t due_us, osal_timer_fn_t fn, void* arg) {
+    if (fn == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < timer_count; i++) {
+        if (timers[i].fn == NULL) {
+            timers[i] = (osal_timer_t){ due_us, fn, arg };
+            return ESP_OK;
+        }
+    }
+    if (timer_count >= OSAL_MAX_TIMERS) {
+        return ESP_ERR_NO_MEM;
+    }
+    timers[timer_count++] = (osal_timer_t){ due_us, fn, arg };
+    return ESP_OK;
+}
+
+static int log_rank(char level) {
+    return level == 'E' ? 0 : level == 'W' ? 1 : 2;
+}
+
+// IDF format, stamped with the virtual clock
+void osal_log(char level, const char* tag, const char* fmt, ...) {
+    if (log_rank(level) > log_rank(config.log_level)) {
+        return;
+    }
+    FILE* out = level == 'I' ? stdout : stderr;
+    fprintf(out, "%c (%lld) %s: ", level, (long long)(osal_now_us() / 1000), tag);
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(out, fmt, args);
+    va_end(args);
+    fputc('\n', out);
+}
+
+void osal_set_log_level(char level) {
+    config.log_level = level;
+}
+
+esp_err_t osal_run(const osal_config_t* cfg, TaskFunction_t entry, void* param) {
+    if (cfg == NULL || entry == NULL || cfg->duration_us <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&big);
+    config = *cfg;
+    now_us = 0;
+    stopped = false;
+    if (xTaskCreate(entry, "main", 4096, param, 1, NULL) != pdPASS) {
+        pthread_mutex_unlock(&big);
+        return ESP_ERR_NO_MEM;
+    }
+
+    reschedule(NULL);
+    while (!stopped) {
+        pthread_cond_wait(&stopped_cond, &big);
+    }
+    pthread_mutex_unlock(&big);
+    return ESP_OK;
+}
@@ -0,0 +1,211 @@
+#ifndef OSAL_H
+#define OSAL_H
+
+#include "port.h"
+
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Host OSAL: the FreeRTOS, esp_system, I2C and GPIO services the firmware
+// sources use, on pthreads and a virtual clock. The stand-in headers in this
+// directory (freertos/task.h, driver/i2c.h, ...) all resolve here, so
+// src/main.c, src/mpu6050_driver.c and src/tflite_inference.c build unchanged
+// with HOST_OSAL defined.
+//
+// Tasks are pthreads, but only one runs at a time: the running task holds
+// the scheduler until it blocks (delay, notification, queue, I2C transfer) or
+// yields, and the highest-priority ready task runs next. Core pinning is
+// ignored. Time is virtual: when no task is ready the clock jumps to the next
+// wake-up or timer, so idle time costs nothing and a run goes as fast as the
+// host computes. CPU time of a task is charged to the clock, scaled by
+// osal_config_t.cpu_scale (0 makes compute free and runs deterministic).
+//
+// Timers (osal_timer_start) stand in for hardware: they run at their due time
+// in "ISR context", between tasks, and are what simulated devices use to
+// sample, raise interrupts and fill FIFOs.
+
+// ---- FreeRTOS ----
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef struct osal_queue* QueueHandle_t;
+typedef void (*TaskFunction_t)(void* param);
+
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFu)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define errQUEUE_FULL pdFALSE
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack_depth, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack_depth, void* param,
+                       UBaseType_t priority, TaskHandle_t* handle);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t* previous_wake, TickType_t increment);
+TickType_t xTaskGetTickCount(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+void taskYIELD(void);
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higher_priority_woken);
+#define portYIELD_FROM_ISR(...) do { } while (0)
+
+// Timers never preempt a running task, so there is nothing to exclude
+typedef struct {
+    int unused;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+#define portENTER_CRITICAL(mux) do { (void)(mux); } while (0)
+#define portEXIT_CRITICAL(mux) do { (void)(mux); } while (0)
+#define portENTER_CRITICAL_ISR(mux) do { (void)(mux); } while (0)
+#define portEXIT_CRITICAL_ISR(mux) do { (void)(mux); } while (0)
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size);
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks);
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+
+// ---- esp_system / esp_attr ----
+
+#define IRAM_ATTR
+
+void esp_restart(void);
+uint32_t esp_get_free_heap_size(void);
+uint32_t esp_get_minimum_free_heap_size(void);
+
+// ---- driver/i2c.h (legacy command-link API) ----
+
+typedef int i2c_port_t;
+#define I2C_NUM_0 0
+#define I2C_NUM_1 1
+#define I2C_NUM_MAX 2
+
+typedef enum { I2C_MODE_SLAVE, I2C_MODE_MASTER } i2c_mode_t;
+typedef enum { I2C_MASTER_WRITE = 0, I2C_MASTER_READ = 1 } i2c_rw_t;
+typedef enum { I2C_MASTER_ACK, I2C_MASTER_NACK, I2C_MASTER_LAST_NACK } i2c_ack_type_t;
+
+typedef struct {
+    i2c_mode_t mode;
+    int sda_io_num;
+    int scl_io_num;
+    bool sda_pullup_en;
+    bool scl_pullup_en;
+    struct {
+        uint32_t clk_speed;
+    } master;
+    uint32_t clk_flags;
+} i2c_config_t;
+
+typedef void* i2c_cmd_handle_t;
+
+// Host links live in the shim; the caller's buffer only has to exist
+#define I2C_LINK_RECOMMENDED_SIZE(transactions) (16 * (transactions))
+
+esp_err_t i2c_param_config(i2c_port_t port, const i2c_config_t* conf);
+esp_err_t i2c_driver_install(i2c_port_t port, i2c_mode_t mode, size_t rx_buf, size_t tx_buf, int intr_flags);
+esp_err_t i2c_driver_delete(i2c_port_t port);
+i2c_cmd_handle_t i2c_cmd_link_create_static(uint8_t* buffer, uint32_t size);
+void i2c_cmd_link_delete_static(i2c_cmd_handle_t cmd);
+esp_err_t i2c_master_start(i2c_cmd_handle_t cmd);
+esp_err_t i2c_master_write_byte(i2c_cmd_handle_t cmd, uint8_t data, bool ack_en);
+esp_err_t i2c_master_write(i2c_cmd_handle_t cmd, const uint8_t* data, size_t len, bool ack_en);
+esp_err_t i2c_master_read_byte(i2c_cmd_handle_t cmd, uint8_t* data, i2c_ack_type_t ack);
+esp_err_t i2c_master_read(i2c_cmd_handle_t cmd, uint8_t* data, size_t len, i2c_ack_type_t ack);
+esp_err_t i2c_master_stop(i2c_cmd_handle_t cmd);
+// Runs the link against the attached devices; the task sleeps for the bus time
+esp_err_t i2c_master_cmd_begin(i2c_port_t port, i2c_cmd_handle_t cmd, TickType_t ticks);
+
+// ---- driver/gpio.h ----
+
+typedef int gpio_num_t;
+typedef void (*gpio_isr_t)(void* arg);
+
+typedef enum { GPIO_MODE_DISABLE, GPIO_MODE_INPUT, GPIO_MODE_OUTPUT } gpio_mode_t;
+typedef enum { GPIO_PULLUP_DISABLE, GPIO_PULLUP_ENABLE } gpio_pullup_t;
+typedef enum { GPIO_PULLDOWN_DISABLE, GPIO_PULLDOWN_ENABLE } gpio_pulldown_t;
+typedef enum {
+    GPIO_INTR_DISABLE,
+    GPIO_INTR_POSEDGE,
+    GPIO_INTR_NEGEDGE,
+    GPIO_INTR_ANYEDGE,
+} gpio_int_type_t;
+
+typedef struct {
+    uint64_t pin_bit_mask;
+    gpio_mode_t mode;
+    gpio_pullup_t pull_up_en;
+    gpio_pulldown_t pull_down_en;
+    gpio_int_type_t intr_type;
+} gpio_config_t;
+
+#define OSAL_GPIO_PINS 64
+
+esp_err_t gpio_config(const gpio_config_t* conf);
+esp_err_t gpio_install_isr_service(int intr_flags);
+esp_err_t gpio_isr_handler_add(gpio_num_t pin, gpio_isr_t handler, void* arg);
+esp_err_t gpio_isr_handler_remove(gpio_num_t pin);
+
+// ---- Simulation control ----
+
+typedef struct {
+    int64_t duration_us;        // virtual run time
+    double cpu_scale;           // virtual us charged per host us of task CPU time
+    char log_level;             // 'E', 'W' or 'I'
+} osal_config_t;
+
+// Runs entry as the first task (priority 1, like app_main) until the virtual
+// clock reaches config->duration_us or every task is blocked for good. Returns
+// with all tasks parked, so their state can be inspected.
+esp_err_t osal_run(const osal_config_t* config, TaskFunction_t entry, void* param);
+
+int64_t osal_now_us(void);
+// Blocks the running task for us of virtual time (finer than a tick)
+void osal_sleep_us(int64_t us);
+int64_t osal_cpu_us(void);      // host CPU time spent in tasks
+
+// Hardware timer: fn runs at due_us in ISR context and returns its next due
+// time, or a negative value to stop
+#define OSAL_MAX_TIMERS 8
+typedef int64_t (*osal_timer_fn_t)(void* arg, int64_t due_us);
+esp_err_t osal_timer_start(int64_t due_us, osal_timer_fn_t fn, void* arg);
+
+// I2C slave device, called in bus order for each transaction it is addressed
+// in. start() and write() return false to NACK; read() returns false to hold
+// SCL low until the master gives up (ESP_ERR_TIMEOUT), with the bytes before
+// it already transferred.
+typedef struct {
+    uint8_t address;
+    void* ctx;
+    bool (*start)(void* ctx, bool read);
+    bool (*write)(void* ctx, uint8_t data);
+    bool (*read)(void* ctx, uint8_t* data);
+    void (*stop)(void* ctx);
+} osal_i2c_device_t;
+
+#define OSAL_I2C_MAX_DEVICES 4
+esp_err_t osal_i2c_attach(i2c_port_t port, const osal_i2c_device_t* device);
+
+// Edge on an input pin, from a device model: runs the pin's ISR handler if
+// its interrupt type matches
+void osal_gpio_set_level(gpio_num_t pin, int level);
+
+void osal_log(char level, const char* tag, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
+void osal_set_log_level(char level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OSAL_H
@@ -0,0 +1,276 @@
+#include "osal.h"
+
+#include <string.h>
+
+// I2C command links and GPIO interrupts of the host OSAL. A link records the
+// same operations the IDF driver queues; i2c_master_cmd_begin() replays them
+// against the attached device models and then sleeps the calling task for
+// the time the transfer takes on the bus.
+
+#define I2C_MAX_OPS 16
+#define I2C_MAX_LINKS 4
+
+typedef enum {
+    OP_START,
+    OP_WRITE,
+    OP_READ,
+    OP_STOP,
+} i2c_op_kind_t;
+
+typedef struct {
+    i2c_op_kind_t kind;
+    uint8_t* data;              // read destination
+    uint8_t byte;               // write data
+    size_t len;
+} i2c_op_t;
+
+typedef struct {
+    bool used;
+    int count;
+    i2c_op_t ops[I2C_MAX_OPS];
+} i2c_link_t;
+
+typedef struct {
+    bool installed;
+    uint32_t clk_speed;
+    osal_i2c_device_t devices[OSAL_I2C_MAX_DEVICES];
+    int device_count;
+} i2c_bus_t;
+
+static i2c_link_t links[I2C_MAX_LINKS];
+static i2c_bus_t buses[I2C_NUM_MAX];
+
+typedef struct {
+    gpio_int_type_t intr_type;
+    gpio_isr_t handler;
+    void* arg;
+    int level;
+} gpio_pin_t;
+
+static gpio_pin_t pins[OSAL_GPIO_PINS];
+static bool isr_service = false;
+
+esp_err_t i2c_param_config(i2c_port_t port, const i2c_config_t* conf) {
+    if (port < 0 || port >= I2C_NUM_MAX || conf == NULL || conf->mode != I2C_MODE_MASTER) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    buses[port].clk_speed = conf->master.clk_speed > 0 ? conf->master.clk_speed : 100000;
+    return ESP_OK;
+}
+
+esp_err_t i2c_driver_install(i2c_port_t port, i2c_mode_t mode, size_t rx_buf, size_t tx_buf, int intr_flags) {
+    if (port < 0 || port >= I2C_NUM_MAX || mode != I2C_MODE_MASTER) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (buses[port].installed) {
+        return ESP_FAIL;
+    }
+    buses[port].installed = true;
+    return ESP_OK;
+}
+
+esp_err_t i2c_driver_delete(i2c_port_t port) {
+    if (port < 0 || port >= I2C_NUM_MAX || !buses[port].installed) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    buses[port].installed = false;
+    return ESP_OK;
+}
+
+i2c_cmd_handle_t i2c_cmd_link_create_static(uint8_t* buffer, uint32_t size) {
+    if (buffer == NULL || size < I2C_LINK_RECOMMENDED_SIZE(1)) {
+        return NULL;
+    }
+    for (int i = 0; i < I2C_MAX_LINKS; i++) {
+        if (!links[i].used) {
+            links[i].used = true;
+            links[i].count = 0;
+            return &links[i];
+        }
+    }
+    return NULL;
+}
+
+void i2c_cmd_link_delete_static(i2c_cmd_handle_t cmd) {
+    if (cmd != NULL) {
+        ((i2c_link_t*)cmd)->used = false;
+    }
+}
+
+static esp_err_t add_op(i2c_cmd_handle_t cmd, i2c_op_t op) {
+    i2c_link_t* link = cmd;
+    if (link == NULL || link->count >= I2C_MAX_OPS) {
+        return ESP_ERR_NO_MEM;
+    }
+    link->ops[link->count++] = op;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_start(i2c_cmd_handle_t cmd) {
+    return add_op(cmd, (i2c_op_t){ .kind = OP_START });
+}
+
+esp_err_t i2c_master_write_byte(i2c_cmd_handle_t cmd, uint8_t data, bool ack_en) {
+    return add_op(cmd, (i2c_op_t){ .kind = OP_WRITE, .byte = data, .len = 1 });
+}
+
+esp_err_t i2c_master_write(i2c_cmd_handle_t cmd, const uint8_t* data, size_t len, bool ack_en) {
+    for (size_t i = 0; i < len; i++) {
+        esp_err_t ret = i2c_master_write_byte(cmd, data[i], ack_en);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_read_byte(i2c_cmd_handle_t cmd, uint8_t* data, i2c_ack_type_t ack) {
+    return add_op(cmd, (i2c_op_t){ .kind = OP_READ, .data = data, .len = 1 });
+}
+
+esp_err_t i2c_master_read(i2c_cmd_handle_t cmd, uint8_t* data, size_t len, i2c_ack_type_t ack) {
+    return add_op(cmd, (i2c_op_t){ .kind = OP_READ, .data = data, .len = len });
+}
+
+esp_err_t i2c_master_stop(i2c_cmd_handle_t cmd) {
+    return add_op(cmd, (i2c_op_t){ .kind = OP_STOP });
+}
+
+static osal_i2c_device_t* find_device(i2c_bus_t* bus, uint8_t address) {
+    for (int i = 0; i < bus->device_count; i++) {
+        if (bus->devices[i].address == address) {
+            return &bus->devices[i];
+        }
+    }
+    return NULL;
+}
+
+esp_err_t i2c_master_cmd_begin(i2c_port_t port, i2c_cmd_handle_t cmd, TickType_t ticks) {
+    if (port < 0 || port >= I2C_NUM_MAX || cmd == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    i2c_bus_t* bus = &buses[port];
+    if (!bus->installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    const i2c_link_t* link = cmd;
+    osal_i2c_device_t* device = NULL;
+    bool address_next = false;
+    bool nack = false;
+    bool stalled = false;
+    uint32_t bits = 0;
+
+    for (int i = 0; i < link->count && !nack && !stalled; i++) {
+        const i2c_op_t* op = &link->ops[i];
+        switch (op->kind) {
+            case OP_START:
+                address_next = true;
+                bits += 1;
+                break;
+            case OP_WRITE:
+                bits += 9;
+                if (address_next) {
+                    address_next = false;
+                    device = find_device(bus, op->byte >> 1);
+                    nack = device == NULL || (device->start != NULL &&
+                                              !device->start(device->ctx, (op->byte & 1) == I2C_MASTER_READ));
+                } else if (device != NULL && device->write != NULL) {
+                    nack = !device->write(device->ctx, op->byte);
+                }
+                break;
+            case OP_READ:
+                for (size_t j = 0; j < op->len && !stalled; j++) {
+                    op->data[j] = 0xFF;
+                    if (device != NULL && device->read != NULL) {
+                        stalled = !device->read(device->ctx, &op->data[j]);
+                    }
+                    bits += stalled ? 0 : 9;
+                }
+                break;
+            case OP_STOP:
+                bits += 1;
+                break;
+        }
+    }
+    if (device != NULL && device->stop != NULL) {
+        device->stop(device->ctx);
+    }
+
+    // The IDF driver blocks the task for the transfer
+    osal_sleep_us(((int64_t)bits * 1000000 + bus->clk_speed - 1) / bus->clk_speed);
+    if (stalled) {
+        return ESP_ERR_TIMEOUT;
+    }
+    return nack ? ESP_FAIL : ESP_OK;
+}
+
+esp_err_t osal_i2c_attach(i2c_port_t port, const osal_i2c_device_t* device) {
+    if (port < 0 || port >= I2C_NUM_MAX || device == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    i2c_bus_t* bus = &buses[port];
+    if (bus->device_count >= OSAL_I2C_MAX_DEVICES || find_device(bus, device->address) != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    bus->devices[bus->device_count++] = *device;
+    return ESP_OK;
+}
+
+esp_err_t gpio_config(const gpio_config_t* conf) {
+    if (conf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int pin = 0; pin < OSAL_GPIO_PINS; pin++) {
+        if (conf->pin_bit_mask & (1ULL << pin)) {
+            pins[pin].intr_type = conf->intr_type;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t gpio_install_isr_service(int intr_flags) {
+    if (isr_service) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    isr_service = true;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t pin, gpio_isr_t handler, void* arg) {
+    if (pin < 0 || pin >= OSAL_GPIO_PINS || handler == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!isr_service) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    pins[pin].handler = handler;
+    pins[pin].arg = arg;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t pin) {
+    if (pin < 0 || pin >= OSAL_GPIO_PINS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pins[pin].handler = NULL;
+    pins[pin].arg = NULL;
+    return ESP_OK;
+}
+
+void osal_gpio_set_level(gpio_num_t pin, int level) {
+    if (pin < 0 || pin >= OSAL_GPIO_PINS) {
+        return;
+    }
+    gpio_pin_t* p = &pins[pin];
+    int previous = p->level;
+    p->level = level != 0;
+    bool rising = !previous && p->level;
+    bool falling = previous && !p->level;
+    bool fire = (p->intr_type == GPIO_INTR_POSEDGE && rising) ||
+                (p->intr_type == GPIO_INTR_NEGEDGE && falling) ||
+                (p->intr_type == GPIO_INTR_ANYEDGE && (rising || falling));
+    if (fire && p->handler != NULL) {
+        p->handler(p->arg);
+    }
+}
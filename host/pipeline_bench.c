@@ -0,0 +1,185 @@
+#include "nn_engine.h"
+#include "nn_pipeline.h"
+#include "config.h"
+#include "fall_detection_model.h"
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <unistd.h>
+
+// Two-stage pipelined inference (nn_pipeline) on two pthreads against the
+// single-threaded interpreter (nn_engine) on the same windows:
+//
+//   pipeline_bench [windows]
+//
+// The main thread plays the inference task (back stage: LSTM, attention,
+// Dense); a worker thread plays the front task on the other core (fused conv
+// blocks), woken through the pipeline's notify hook like the firmware's
+// task notification. Every output must match bit for bit; per-window latency
+// and per-stage utilisation are reported. Exits non-zero on any difference.
+// The stages only overlap with at least two host CPUs; on one CPU the
+// threads time-slice and the pipeline shows its overhead instead.
+
+#define BENCH_DEFAULT_WINDOWS 200
+
+typedef struct {
+    nn_pipeline_t* pipeline;
+    sem_t wake;
+    atomic_bool stop;
+} front_worker_t;
+
+static void wake_front(void* ctx) {
+    sem_post(&((front_worker_t*)ctx)->wake);
+}
+
+static void* front_thread(void* arg) {
+    front_worker_t* worker = arg;
+    while (1) {
+        sem_wait(&worker->wake);
+        if (atomic_load(&worker->stop)) {
+            return NULL;
+        }
+        while (nn_pipeline_front_step(worker->pipeline)) {
+        }
+    }
+}
+
+static uint32_t lcg_state = 12345;
+
+static uint32_t lcg_next(void) {
+    lcg_state = lcg_state * 1664525u + 1013904223u;
+    return lcg_state >> 8;
+}
+
+// Replayed-looking motion on even windows, int8 noise on odd ones
+static void make_window(const nn_model_t* model, int w, int8_t* input) {
+    for (int t = 0; t < model->seq_len; t++) {
+        for (int f = 0; f < model->features; f++) {
+            int8_t* q = &input[t * model->features + f];
+            if (w % 2 == 1) {
+                *q = (int8_t)(lcg_next() & 0xFF);
+                continue;
+            }
+            float s = (float)t / SAMPLE_RATE_HZ + 0.37f * (float)w;
+            float v = f == 2 ? 0.5f : 0.0f;
+            if (f == 0 || f == 4) {
+                v += 0.4f * sinf(2.0f * (float)M_PI * (0.5f + 0.1f * (float)(w % 7)) * s);
+            }
+            v += 0.02f * (float)((int)(lcg_next() % 201) - 100) / 100.0f;
+            *q = nn_quantize_f32(v, model->input_q);
+        }
+    }
+}
+
+static int compare_s64(const void* a, const void* b) {
+    int64_t x = *(const int64_t*)a;
+    int64_t y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static int64_t print_latency(const char* name, int64_t* us, int n) {
+    qsort(us, (size_t)n, sizeof(us[0]), compare_s64);
+    int64_t sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += us[i];
+    }
+    printf("  %-12s median %6lld us, p90 %6lld us, mean %8.1f us\n", name,
+           (long long)us[n / 2], (long long)us[n * 9 / 10], (double)sum / n);
+    return us[n / 2];
+}
+
+int main(int argc, char** argv) {
+    int windows = argc > 1 ? atoi(argv[1]) : BENCH_DEFAULT_WINDOWS;
+    if (windows <= 0) {
+        fprintf(stderr, "usage: %s [windows]\n", argv[0]);
+        return 2;
+    }
+
+    static nn_model_t model;
+    if (nn_model_load(&model, fall_detection_model, fall_detection_model_len) != ESP_OK) {
+        return 1;
+    }
+    if (!nn_pipeline_supported(&model)) {
+        fprintf(stderr, "built-in model cannot run pipelined\n");
+        return 1;
+    }
+
+    size_t engine_arena_size = nn_engine_arena_size(&model);
+    size_t pipeline_arena_size = nn_pipeline_arena_size(&model);
+    uint8_t* engine_arena = aligned_alloc(NN_ARENA_ALIGNMENT, engine_arena_size);
+    uint8_t* pipeline_arena = aligned_alloc(NN_ARENA_ALIGNMENT, pipeline_arena_size);
+    int8_t* input = malloc((size_t)model.seq_len * model.features);
+    int64_t* engine_us = malloc(sizeof(int64_t) * windows);
+    int64_t* pipeline_us = malloc(sizeof(int64_t) * windows);
+    if (engine_arena == NULL || pipeline_arena == NULL || input == NULL || engine_us == NULL || pipeline_us == NULL) {
+        return 1;
+    }
+
+    nn_engine_t engine;
+    static nn_pipeline_t pipeline;
+    if (nn_engine_init(&engine, &model, engine_arena, engine_arena_size) != ESP_OK ||
+        nn_pipeline_init(&pipeline, &model, pipeline_arena, pipeline_arena_size) != ESP_OK) {
+        return 1;
+    }
+
+    front_worker_t worker = { .pipeline = &pipeline };
+    sem_init(&worker.wake, 0, 0);
+    atomic_init(&worker.stop, false);
+    pthread_t front;
+    if (pthread_create(&front, NULL, front_thread, &worker) != 0) {
+        perror("pthread_create");
+        return 1;
+    }
+    nn_pipeline_set_front_worker(&pipeline, wake_front, &worker);
+
+    int mismatches = 0;
+    int failures = 0;
+    for (int w = 0; w < windows; w++) {
+        int8_t a[NN_MAX_CHANNELS];
+        int8_t b[NN_MAX_CHANNELS];
+        make_window(&model, w, input);
+
+        int64_t start = esp_timer_get_time();
+        nn_engine_invoke(&engine, input, a);
+        engine_us[w] = esp_timer_get_time() - start;
+
+        start = esp_timer_get_time();
+        esp_err_t ret = nn_pipeline_invoke(&pipeline, input, b);
+        pipeline_us[w] = esp_timer_get_time() - start;
+        if (ret != ESP_OK) {
+            failures++;
+            continue;
+        }
+
+        if (memcmp(a, b, (size_t)model.classes) != 0 && mismatches++ < 5) {
+            printf("window %d differs:", w);
+            for (int c = 0; c < model.classes; c++) {
+                printf(" %d/%d", a[c], b[c]);
+            }
+            printf("\n");
+        }
+    }
+
+    atomic_store(&worker.stop, true);
+    sem_post(&worker.wake);
+    pthread_join(front, NULL);
+
+    printf("\nInterpreter vs two-stage pipeline (2 threads on %ld CPUs), %d windows\n",
+           sysconf(_SC_NPROCESSORS_ONLN), windows);
+    printf("  arena: interpreter %zu bytes, pipeline %zu bytes\n", engine_arena_size, pipeline_arena_size);
+    int64_t engine_median = print_latency("interpreter", engine_us, windows);
+    int64_t pipeline_median = print_latency("pipelined", pipeline_us, windows);
+    printf("  speedup (median): %.2fx\n", pipeline_median > 0 ? (double)engine_median / pipeline_median : 0.0);
+    nn_pipeline_print_stats(&pipeline);
+    printf("  outputs: %d of %d windows differ, %d failed\n", mismatches, windows, failures);
+    bool pass = mismatches == 0 && failures == 0;
+    printf("%s\n", pass ? "PASS" : "FAIL");
+
+    sem_destroy(&worker.wake);
+    free(engine_arena);
+    free(pipeline_arena);
+    free(input);
+    free(engine_us);
+    free(pipeline_us);
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+#include "tflite_inference.h"
+#include "trace_replay.h"
+
+#include <time.h>
+#include <unistd.h>
+
+// Pushes a recorded trace through the sample pipeline and the model and
+// reports throughput:
+//
+//   replay_bench [--realtime] [--every-hop] [--loops N] trace.csv|trace.bin
+//   replay_bench --pack trace.csv trace.bin
+//
+// Samples come from trace_replay_read() and enter through
+// add_sensor_data_to_buffer(), as on the target with SENSOR_SOURCE_REPLAY.
+// One thread alternates between the two tasks' work: unthrottled by default,
+// at SAMPLE_RATE_HZ with --realtime. --every-hop runs the model on every
+// window instead of the configured cadence. --pack converts a CSV trace to
+// the packed binary format.
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static int pack(const char* in_path, const char* out_path) {
+    trace_replay_t replay;
+    if (trace_replay_open(&replay, in_path, false) != ESP_OK) {
+        return 1;
+    }
+    FILE* out = fopen(out_path, "wb");
+    if (out == NULL) {
+        perror(out_path);
+        trace_replay_close(&replay);
+        return 1;
+    }
+
+    trace_header_t header = {
+        .magic = TRACE_MAGIC,
+        .version = TRACE_VERSION,
+        .sample_rate_hz = replay.sample_rate_hz,
+    };
+    fwrite(&header, sizeof(header), 1, out);
+    mpu6050_data_t d;
+    while (trace_replay_read(&replay, &d) == ESP_OK) {
+        fwrite(&d.raw, sizeof(d.raw), 1, out);
+    }
+    header.samples = replay.samples;
+    fseek(out, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, out);
+    bool ok = ferror(out) == 0;
+    ok &= fclose(out) == 0;
+    trace_replay_close(&replay);
+
+    printf("%s: %lu samples at %u Hz, %lu bad rows skipped -> %s (%zu bytes)\n", in_path,
+           (unsigned long)replay.samples, (unsigned)replay.sample_rate_hz, (unsigned long)replay.bad_rows,
+           out_path, sizeof(header) + replay.samples * sizeof(d.raw));
+    return ok ? 0 : 1;
+}
+
+typedef struct {
+    uint32_t inferences;
+    uint32_t failures;
+    uint32_t predicted[NUM_CLASSES];
+} replay_run_t;
+
+// The inference task's loop body: every ready window, then back to the sensor
+static void consume(replay_run_t* run) {
+    process_sensor_samples();
+    while (g_data_buffer.window_ready) {
+        if (!inference_window_due()) {
+            skip_inference_window();
+        } else {
+            inference_result_t result;
+            if (run_inference(&result) == ESP_OK) {
+                run->inferences++;
+                if (result.predicted_class >= 0 && result.predicted_class < NUM_CLASSES) {
+                    run->predicted[result.predicted_class]++;
+                }
+            } else {
+                run->failures++;
+            }
+        }
+        process_sensor_samples();
+    }
+}
+
+static int usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [--realtime] [--every-hop] [--loops N] trace.csv|trace.bin\n"
+                    "       %s --pack trace.csv trace.bin\n", argv0, argv0);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 4 && strcmp(argv[1], "--pack") == 0) {
+        return pack(argv[2], argv[3]);
+    }
+
+    bool realtime = false;
+    bool every_hop = false;
+    uint32_t loops = 1;
+    int i = 1;
+    for (; i < argc - 1; i++) {
+        if (strcmp(argv[i], "--realtime") == 0) {
+            realtime = true;
+        } else if (strcmp(argv[i], "--every-hop") == 0) {
+            every_hop = true;
+        } else if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc - 1) {
+            loops = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (i != argc - 1 || loops == 0) {
+        return usage(argv[0]);
+    }
+    const char* path = argv[argc - 1];
+
+    if (tflite_init() != ESP_OK) {
+        return 1;
+    }
+    if (every_hop) {
+        set_inference_cadence(CADENCE_EVERY_HOP, 1);
+    }
+    static trace_replay_t replay;
+    if (trace_replay_open(&replay, path, loops > 1) != ESP_OK) {
+        return 1;
+    }
+
+    static replay_run_t run;
+    uint32_t push_failures = 0;
+    double start = wall_seconds();
+    mpu6050_data_t d;
+    while (trace_replay_read(&replay, &d) == ESP_OK && replay.passes < loops) {
+        if (realtime) {
+            double due = start + (double)(replay.samples - 1) / replay.sample_rate_hz;
+            double wait = due - wall_seconds();
+            if (wait > 0.0) {
+                usleep((useconds_t)(wait * 1e6));
+            }
+        }
+        if (spsc_ring_count(&g_sample_ring) >= g_sample_ring.capacity) {
+            consume(&run);
+        }
+        if (add_sensor_data_to_buffer(&d) != ESP_OK) {
+            push_failures++;
+        }
+    }
+    consume(&run);
+    double wall = wall_seconds() - start;
+    uint32_t samples = g_data_buffer.total_samples;
+    trace_replay_close(&replay);
+
+    double trace_seconds = (double)samples / replay.sample_rate_hz;
+    printf("\nTrace replay of '%s' (%s, %s), %lu pass%s\n", path,
+           replay.format == TRACE_FORMAT_CSV ? "CSV" : "binary", realtime ? "1x" : "unthrottled",
+           (unsigned long)loops, loops == 1 ? "" : "es");
+    printf("  samples: %lu (%.1f s of data), %lu bad rows, %lu push failures\n",
+           (unsigned long)samples, trace_seconds, (unsigned long)replay.bad_rows, (unsigned long)push_failures);
+    printf("  windows: %lu emitted, %lu inferences, %lu skipped, %lu failed\n",
+           (unsigned long)g_data_buffer.windows_emitted, (unsigned long)run.inferences,
+           (unsigned long)g_inference_metrics.skipped, (unsigned long)run.failures);
+    printf("  throughput: %.0f samples/s, %.1f inferences/s, %.0fx real time (%.2f s wall)\n",
+           wall > 0.0 ? samples / wall : 0.0, wall > 0.0 ? run.inferences / wall : 0.0,
+           wall > 0.0 ? trace_seconds / wall : 0.0, wall);
+    printf("  predictions:");
+    for (int c = 0; c < NUM_CLASSES; c++) {
+        printf(" %s %lu%s", tflite_class_label(c), (unsigned long)run.predicted[c], c + 1 < NUM_CLASSES ? "," : "\n");
+    }
+    return run.failures == 0 && push_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,376 @@
+#include "config.h"
+#include "mpu6050_driver.h"
+#include "mpu6050_sim.h"
+
+// The MPU6050 driver (src/mpu6050_driver.c) against the simulated sensor,
+// one acquisition mode after another, on the OSAL's virtual clock:
+//
+//   sensor_bench [--seconds N] [--trace file] [--nack-rate P] [--stall-rate P]
+//                [--stretch-us N] [--jitter-us N] [--seed N] [--bus] [--log E|W|I]
+//
+// The modes are the ones src/main.c's sensor task can run:
+//
+//   poll       one 15-byte burst (INT_STATUS and data) per sample, paced by the tick
+//   int        one 15-byte burst per DATA_RDY interrupt
+//   fifo       the FIFO drained every MPU6050_FIFO_BURST_SAMPLES, paced by the tick
+//   int_fifo   the FIFO drained every MPU6050_FIFO_BURST_SAMPLES DATA_RDY interrupts
+//
+// Every mode covers the same --seconds worth of sensor samples, and runs one
+// burst past them so the driver can read the last ones. For each mode it
+// reports what the sensor saw on the bus (transactions and bytes per second,
+// and the load at MPU6050_I2C_FREQ) and how many of those samples the driver
+// delivered. --nack-rate, --stall-rate
+// (per read byte, part way through a burst) and --stretch-us/--jitter-us
+// inject faults (mpu6050_sim_faults_t), and the NACKs, stalls, driver
+// retries, errors that got through and FIFO overflows show how the driver
+// recovers.
+//
+// The sensor plays a ramp: sample n holds c = n mod BENCH_RAMP_PERIOD in
+// accel X and c + 1 ... c + 5 in the other channels. Every delivered sample
+// must hold one ramp step, and FIFO samples must follow on from the one
+// before, skipping at most MPU6050_FIFO_CHUNK_SAMPLES per failed transfer;
+// anything else is counted as corrupt and fails the run. In int_fifo every
+// sample must also carry the DATA_RDY timestamp of its own sampling
+// instant; the stamps column counts those that do not, which fails the run
+// too. int mode is not held to this: a single register read cannot tell
+// which sample it latched. In poll and int a sample delivered twice counts
+// as a duplicate, which fails the run as well. --trace feeds a recorded
+// trace (trace_replay.h, looped) through the sensor instead, unchecked; the
+// driver column then counts every sample returned, the extra burst's too.
+//
+// The driver reaches the sensor through mpu6050_sim_transport(), or through
+// the OSAL's I2C command links with --bus; both give the same traffic.
+
+#define BENCH_DEFAULT_SECONDS 60
+#define BENCH_RAMP_PERIOD     16384
+
+typedef enum {
+    MODE_POLL,
+    MODE_INT,
+    MODE_FIFO,
+    MODE_INT_FIFO,
+    MODE_COUNT,
+} bench_mode_t;
+
+static const char* const mode_names[MODE_COUNT] = { "poll", "int", "fifo", "int_fifo" };
+
+typedef struct {
+    esp_err_t status;           // setup of the mode
+    double seconds;
+    mpu6050_sim_stats_t sensor;
+    mpu6050_bus_stats_t driver;
+    uint32_t delivered;         // samples of the window the driver returned
+    uint32_t corrupt;           // delivered samples that fail the ramp check
+    uint32_t duplicates;        // poll, int: the previous sample delivered again
+    uint32_t misstamped;        // int_fifo: timestamp is not the sample's
+} bench_result_t;
+
+static mpu6050_sim_t sensor;
+static uint32_t mode_samples;           // sensor samples each mode is measured over
+static uint32_t ramp_count;
+static bool verify;
+static esp_err_t init_status = ESP_FAIL;
+static bench_result_t results[MODE_COUNT];
+static int64_t ramp_time_us[BENCH_RAMP_PERIOD];    // when each ramp step was sampled
+
+static void ramp_source(void* ctx, int64_t t_us, float accel_g[3], float gyro_dps[3]) {
+    uint32_t* n = ctx;
+    int c = (int)(*n % BENCH_RAMP_PERIOD);
+    (*n)++;
+    ramp_time_us[c] = t_us;
+    for (int i = 0; i < 3; i++) {
+        accel_g[i] = (float)(c + i) / MPU6050_ACCEL_LSB_PER_G;
+        gyro_dps[i] = (float)(c + 3 + i) / MPU6050_GYRO_LSB_PER_DPS;
+    }
+}
+
+// Ramp step of a delivered sample, or -1 if its channels do not hold one
+static int ramp_step(const mpu6050_data_t* d) {
+    int c = d->raw.accel[0];
+    for (int i = 0; i < 3; i++) {
+        if (d->raw.accel[i] != c + i || d->raw.gyro[i] != c + 3 + i) {
+            return -1;
+        }
+    }
+    return c;
+}
+
+// Sensor sample number of a ramp step the driver just delivered: the most
+// recent one with that step
+static uint32_t ramp_sample(int c) {
+    uint32_t newest = sensor.stats.samples - 1;
+    return newest - (newest - (uint32_t)c) % BENCH_RAMP_PERIOD;
+}
+
+// Counts the delivered samples from first on, within the window.
+// FIFO samples must continue the ramp from the previous good read; last is
+// -1 when there is nothing to continue from. A failed FIFO transfer loses
+// at most its chunk, so a read with failures may skip up to gap steps.
+// The DATA_RDY interrupt fires at the sampling instant, so with stamped set
+// every sample must carry the time its ramp step was taken.
+static void check_samples(const mpu6050_data_t* samples, size_t count, bool continuous, int gap, bool stamped,
+                          uint32_t first, int* last, bench_result_t* r) {
+    for (size_t i = 0; i < count; i++) {
+        int c = ramp_step(&samples[i]);
+        if (c < 0 || ramp_sample(c) - first < mode_samples) {
+            r->delivered++;
+        }
+        int step = (c - *last + BENCH_RAMP_PERIOD) % BENCH_RAMP_PERIOD;
+        if (c >= 0 && !continuous && c == *last) {
+            r->duplicates++;
+        } else if (c < 0 || (continuous && *last >= 0 && (step < 1 || step > 1 + gap))) {
+            r->corrupt++;
+        } else if (stamped && (int64_t)samples[i].timestamp != ramp_time_us[c]) {
+            r->misstamped++;
+        }
+        *last = c;
+    }
+}
+
+static void diff_stats(bench_result_t* r, const mpu6050_sim_stats_t* s0, const mpu6050_bus_stats_t* d0) {
+    const mpu6050_sim_stats_t* s = &sensor.stats;
+    r->sensor.samples = s->samples - s0->samples;
+    r->sensor.fifo_overflows = s->fifo_overflows - s0->fifo_overflows;
+    r->sensor.transactions = s->transactions - s0->transactions;
+    r->sensor.bytes_written = s->bytes_written - s0->bytes_written;
+    r->sensor.bytes_read = s->bytes_read - s0->bytes_read;
+    r->sensor.nacks = s->nacks - s0->nacks;
+    r->sensor.stalls = s->stalls - s0->stalls;
+    r->sensor.stretch_us = s->stretch_us - s0->stretch_us;
+
+    mpu6050_bus_stats_t d;
+    mpu6050_get_bus_stats(&d);
+    r->driver.transactions = d.transactions - d0->transactions;
+    r->driver.retries = d.retries - d0->retries;
+    r->driver.errors = d.errors - d0->errors;
+}
+
+static esp_err_t run_mode(bench_mode_t mode, bench_result_t* r) {
+    bool fifo = mode == MODE_FIFO || mode == MODE_INT_FIFO;
+    bool int_paced = mode == MODE_INT || mode == MODE_INT_FIFO;
+    uint32_t burst = fifo ? MPU6050_FIFO_BURST_SAMPLES : 1;
+
+    if (fifo) {
+        esp_err_t ret = mpu6050_fifo_enable();
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    if (int_paced) {
+        ulTaskNotifyTake(pdTRUE, 0);
+        esp_err_t ret = mpu6050_int_enable(xTaskGetCurrentTaskHandle(), burst);
+        if (ret != ESP_OK) {
+            mpu6050_fifo_disable();
+            return ret;
+        }
+    }
+
+    static mpu6050_data_t samples[MPU6050_FIFO_MAX_SAMPLES];
+    mpu6050_sim_stats_t s0 = sensor.stats;
+    mpu6050_bus_stats_t d0;
+    mpu6050_get_bus_stats(&d0);
+    int64_t start = osal_now_us();
+    TickType_t last_wake_time = xTaskGetTickCount();
+    int last = -1;
+
+    // The registers and FIFO may already hold samples from before the window
+    uint32_t first = sensor.stats.samples;
+    while (sensor.stats.samples - first < mode_samples + burst) {
+        if (int_paced) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(burst * SAMPLE_INTERVAL_MS * 2));
+        } else {
+            vTaskDelayUntil(&last_wake_time, pdMS_TO_TICKS(burst * SAMPLE_INTERVAL_MS));
+        }
+
+        mpu6050_bus_stats_t before;
+        mpu6050_get_bus_stats(&before);
+        size_t count = 1;
+        esp_err_t ret = fifo ? mpu6050_read_fifo(samples, MPU6050_FIFO_MAX_SAMPLES, &count)
+                             : mpu6050_read_data(&samples[0]);
+        if (ret != ESP_OK && !fifo) {
+            count = 0;
+        }
+        // A failed FIFO read still delivers the samples before the failure
+        if (verify) {
+            mpu6050_bus_stats_t after;
+            mpu6050_get_bus_stats(&after);
+            int gap = (int)(after.errors - before.errors) * MPU6050_FIFO_CHUNK_SAMPLES;
+            check_samples(samples, count, fifo, gap, mode == MODE_INT_FIFO, first, &last, r);
+        } else {
+            r->delivered += count;
+        }
+        if (ret != ESP_OK && fifo) {
+            // Samples were lost or the FIFO was reset: no continuity to check
+            last = -1;
+        }
+    }
+
+    r->seconds = (double)(osal_now_us() - start) / 1e6;
+    diff_stats(r, &s0, &d0);
+    r->sensor.samples = mode_samples;
+
+    if (int_paced) {
+        mpu6050_int_disable();
+    }
+    if (fifo) {
+        mpu6050_fifo_disable();
+    }
+    return ESP_OK;
+}
+
+static void bench_task(void* param) {
+    init_status = mpu6050_init();
+    if (init_status != ESP_OK) {
+        return;
+    }
+    // Each mode sets up the FIFO it needs
+    mpu6050_fifo_disable();
+
+    for (int mode = 0; mode < MODE_COUNT; mode++) {
+        results[mode].status = run_mode((bench_mode_t)mode, &results[mode]);
+    }
+}
+
+static void print_results(void) {
+    printf("%-9s %8s %8s %8s %6s %8s %9s %10s %8s %6s %6s %7s %6s %9s\n", "mode", "samples", "driver",
+           "corrupt", "dups", "stamps", "trans/s", "bytes/s", "bus load", "nacks", "stalls", "retries", "errors", "overflows");
+    for (int mode = 0; mode < MODE_COUNT; mode++) {
+        const bench_result_t* r = &results[mode];
+        if (r->status != ESP_OK) {
+            printf("%-9s setup failed: %s\n", mode_names[mode], esp_err_to_name(r->status));
+            continue;
+        }
+        double bytes = (double)r->sensor.bytes_written + r->sensor.bytes_read;
+        // Nine bits per byte, START, repeated START and STOP around them
+        double bits = 9.0 * bytes + 3.0 * r->sensor.transactions;
+        char corrupt[16] = "-";
+        char dups[16] = "-";
+        char stamps[16] = "-";
+        if (verify) {
+            snprintf(corrupt, sizeof(corrupt), "%lu", (unsigned long)r->corrupt);
+        }
+        if (verify && (mode == MODE_POLL || mode == MODE_INT)) {
+            snprintf(dups, sizeof(dups), "%lu", (unsigned long)r->duplicates);
+        }
+        if (verify && mode == MODE_INT_FIFO) {
+            snprintf(stamps, sizeof(stamps), "%lu", (unsigned long)r->misstamped);
+        }
+        printf("%-9s %8lu %8lu %8s %6s %8s %9.1f %10.1f %7.2f%% %6lu %6lu %7lu %6lu %9lu\n", mode_names[mode],
+               (unsigned long)r->sensor.samples, (unsigned long)r->delivered, corrupt, dups, stamps,
+               r->sensor.transactions / r->seconds, bytes / r->seconds,
+               100.0 * bits / r->seconds / MPU6050_I2C_FREQ, (unsigned long)r->sensor.nacks,
+               (unsigned long)r->sensor.stalls, (unsigned long)r->driver.retries,
+               (unsigned long)r->driver.errors, (unsigned long)r->sensor.fifo_overflows);
+    }
+}
+
+static int usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [--seconds N] [--trace file] [--nack-rate P] [--stall-rate P]\n"
+                    "       %*s [--stretch-us N] [--jitter-us N] [--seed N] [--bus] [--log E|W|I]\n",
+            argv0, (int)strlen(argv0), "");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    double seconds = BENCH_DEFAULT_SECONDS;
+    const char* trace = NULL;
+    bool bus = false;
+    char log_level = 'E';
+    mpu6050_sim_faults_t faults = { .seed = 1 };
+
+    for (int i = 1; i < argc; i++) {
+        const char* opt = argv[i];
+        if (strcmp(opt, "--bus") == 0) {
+            bus = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return usage(argv[0]);
+        }
+        const char* arg = argv[++i];
+        if (strcmp(opt, "--seconds") == 0) {
+            seconds = atof(arg);
+        } else if (strcmp(opt, "--trace") == 0) {
+            trace = arg;
+        } else if (strcmp(opt, "--nack-rate") == 0) {
+            faults.nack_rate = (float)atof(arg);
+        } else if (strcmp(opt, "--stall-rate") == 0) {
+            faults.stall_rate = (float)atof(arg);
+        } else if (strcmp(opt, "--stretch-us") == 0) {
+            faults.stretch_us = (uint32_t)atoi(arg);
+        } else if (strcmp(opt, "--jitter-us") == 0) {
+            faults.stretch_jitter_us = (uint32_t)atoi(arg);
+        } else if (strcmp(opt, "--seed") == 0) {
+            faults.seed = (uint32_t)strtoul(arg, NULL, 0);
+        } else if (strcmp(opt, "--log") == 0 && (arg[0] == 'E' || arg[0] == 'W' || arg[0] == 'I')) {
+            log_level = arg[0];
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (seconds * SAMPLE_RATE_HZ < 1.0 || faults.nack_rate < 0.0f || faults.nack_rate >= 1.0f ||
+        faults.stall_rate < 0.0f || faults.stall_rate >= 1.0f) {
+        return usage(argv[0]);
+    }
+
+    static mpu6050_sim_trace_t source;
+    if (trace != NULL && trace_replay_open(&source.replay, trace, true) != ESP_OK) {
+        return 1;
+    }
+
+    verify = trace == NULL;
+    mpu6050_sim_source_fn source_fn = verify ? ramp_source : mpu6050_sim_trace;
+    void* source_ctx = verify ? (void*)&ramp_count : (void*)&source;
+    esp_err_t ret = bus ? mpu6050_sim_attach(&sensor, source_fn, source_ctx)
+                        : mpu6050_sim_init(&sensor, source_fn, source_ctx);
+    if (ret != ESP_OK) {
+        fprintf(stderr, "cannot start the simulated MPU6050\n");
+        return 1;
+    }
+    mpu6050_sim_set_faults(&sensor, &faults);
+    if (!bus) {
+        mpu6050_transport_t transport;
+        mpu6050_sim_transport(&sensor, &transport);
+        mpu6050_set_transport(&transport);
+    }
+
+    // Bus time only: task CPU time is free, so runs repeat exactly
+    mode_samples = (uint32_t)(seconds * SAMPLE_RATE_HZ + 0.5);
+    int64_t mode_us = (int64_t)(mode_samples + MPU6050_FIFO_BURST_SAMPLES) * (1000000 / SAMPLE_RATE_HZ);
+    osal_config_t config = {
+        .duration_us = MODE_COUNT * (mode_us + 1000000) + 1000000,
+        .cpu_scale = 0.0,
+        .log_level = log_level,
+    };
+    if (osal_run(&config, bench_task, NULL) != ESP_OK) {
+        return 1;
+    }
+    if (init_status != ESP_OK) {
+        fprintf(stderr, "mpu6050_init failed: %s\n", esp_err_to_name(init_status));
+        return 1;
+    }
+
+    printf("MPU6050 at %d Hz, %d kHz I2C through %s, %lu samples (%.0f s) per mode", SAMPLE_RATE_HZ,
+           MPU6050_I2C_FREQ / 1000, bus ? "OSAL command links" : "the sim transport", (unsigned long)mode_samples,
+           seconds);
+    if (trace != NULL) {
+        printf(", trace '%s'", trace);
+    }
+    printf("\n");
+    if (faults.nack_rate > 0.0f || faults.stall_rate > 0.0f || faults.stretch_us > 0 ||
+        faults.stretch_jitter_us > 0) {
+        printf("faults: NACK rate %.3f, stall rate %.4f, stretch %lu + 0..%lu us, seed %lu\n",
+               faults.nack_rate, faults.stall_rate, (unsigned long)faults.stretch_us,
+               (unsigned long)faults.stretch_jitter_us, (unsigned long)faults.seed);
+    }
+    print_results();
+
+    for (int mode = 0; mode < MODE_COUNT; mode++) {
+        if (results[mode].status != ESP_OK || results[mode].delivered == 0 || results[mode].corrupt > 0 ||
+            results[mode].duplicates > 0 ||
+            results[mode].misstamped > 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,216 @@
+#include "spsc_ring.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Stress test of the lock-free ring (spsc_ring.h) with its two ends on two
+// pthreads:
+//
+//   spsc_stress [--items N]
+//
+// The producer pushes sequence-stamped elements as fast as the ring takes
+// them and the consumer pops them as fast as they arrive, so the ring keeps
+// running full and empty. Each element carries its sequence number, a
+// payload derived from it and a check word, so the consumer detects any
+// lost, duplicated, reordered or torn (partly written) element. Every
+// capacity is run twice: from index 0, and with head and tail started just
+// below UINT32_MAX so the free-running indices wrap part way through. Exits
+// 1 on the first bad element or inconsistent count.
+
+#define STRESS_DEFAULT_ITEMS 2000000
+#define STRESS_PAYLOAD_WORDS 12         // 64-byte elements: a torn copy is likely to show
+
+typedef struct {
+    uint64_t seq;
+    uint32_t payload[STRESS_PAYLOAD_WORDS];
+    uint64_t check;
+} stress_elem_t;
+
+typedef struct {
+    spsc_ring_t ring;
+    uint64_t items;
+    uint64_t full_spins;        // pushes rejected because the ring was full
+    uint64_t empty_spins;       // consumer found the ring empty
+    uint64_t received;
+    uint64_t errors;
+    atomic_bool failed;         // either side gave up: the other stops waiting
+    char error[160];
+} stress_run_t;
+
+static uint32_t payload_word(uint64_t seq, int i) {
+    return (uint32_t)(seq * 0x9E3779B97F4A7C15ull >> 32) ^ (uint32_t)(i * 0x85EBCA6Bu);
+}
+
+static uint64_t check_word(uint64_t seq) {
+    return ~seq ^ 0xA5A5A5A5A5A5A5A5ull;
+}
+
+static void* producer(void* arg) {
+    stress_run_t* run = arg;
+    stress_elem_t e;
+    for (uint64_t seq = 0; seq < run->items; seq++) {
+        e.seq = seq;
+        for (int i = 0; i < STRESS_PAYLOAD_WORDS; i++) {
+            e.payload[i] = payload_word(seq, i);
+        }
+        e.check = check_word(seq);
+        while (!spsc_ring_push(&run->ring, &e)) {
+            if ((++run->full_spins & 63) == 0) {
+                if (atomic_load(&run->failed)) {
+                    return NULL;
+                }
+                sched_yield();
+            }
+        }
+        if (spsc_ring_count(&run->ring) > run->ring.capacity) {
+            snprintf(run->error, sizeof(run->error), "producer saw %lu queued in a ring of %lu",
+                     (unsigned long)spsc_ring_count(&run->ring), (unsigned long)run->ring.capacity);
+            run->errors++;
+            atomic_store(&run->failed, true);
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+static bool check_elem(stress_run_t* run, const stress_elem_t* e, uint64_t expected) {
+    if (e->seq != expected) {
+        snprintf(run->error, sizeof(run->error), "expected element %llu, got %llu (%s)",
+                 (unsigned long long)expected, (unsigned long long)e->seq,
+                 e->seq < expected ? "duplicated or reordered" : "lost");
+        return false;
+    }
+    for (int i = 0; i < STRESS_PAYLOAD_WORDS; i++) {
+        if (e->payload[i] != payload_word(expected, i)) {
+            snprintf(run->error, sizeof(run->error), "element %llu torn at payload word %d",
+                     (unsigned long long)expected, i);
+            return false;
+        }
+    }
+    if (e->check != check_word(expected)) {
+        snprintf(run->error, sizeof(run->error), "element %llu torn at the check word",
+                 (unsigned long long)expected);
+        return false;
+    }
+    return true;
+}
+
+static void* consumer(void* arg) {
+    stress_run_t* run = arg;
+    stress_elem_t e;
+    while (run->received < run->items) {
+        if (!spsc_ring_pop(&run->ring, &e)) {
+            if ((++run->empty_spins & 63) == 0) {
+                if (atomic_load(&run->failed)) {
+                    return NULL;
+                }
+                sched_yield();
+            }
+            continue;
+        }
+        if (!check_elem(run, &e, run->received)) {
+            run->errors++;
+            atomic_store(&run->failed, true);
+            return NULL;
+        }
+        run->received++;
+    }
+    // Everything pushed has been popped: the ring must be empty
+    if (spsc_ring_pop(&run->ring, &e)) {
+        snprintf(run->error, sizeof(run->error), "element %llu popped after the last one",
+                 (unsigned long long)e.seq);
+        run->errors++;
+    }
+    return NULL;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// One producer/consumer run; start is the initial value of both indices
+static bool stress(uint32_t capacity, uint32_t start, uint64_t items) {
+    static stress_run_t run;
+    stress_elem_t* storage = malloc((size_t)capacity * sizeof(stress_elem_t));
+    if (storage == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return false;
+    }
+    memset(&run, 0, sizeof(run));
+    atomic_init(&run.failed, false);
+    run.items = items;
+    if (spsc_ring_init(&run.ring, storage, sizeof(stress_elem_t), capacity) != ESP_OK) {
+        fprintf(stderr, "spsc_ring_init(capacity %lu) failed\n", (unsigned long)capacity);
+        free(storage);
+        return false;
+    }
+    // An empty ring whose indices are about to wrap
+    atomic_store(&run.ring.head, start);
+    atomic_store(&run.ring.tail, start);
+    run.ring.tail_cache = start;
+    run.ring.head_cache = start;
+
+    double t0 = now_seconds();
+    pthread_t threads[2];
+    pthread_create(&threads[0], NULL, consumer, &run);
+    pthread_create(&threads[1], NULL, producer, &run);
+    pthread_join(threads[1], NULL);
+    pthread_join(threads[0], NULL);
+    double elapsed = now_seconds() - t0;
+
+    if (run.errors == 0 && run.ring.dropped != run.full_spins) {
+        snprintf(run.error, sizeof(run.error), "dropped counts %lu rejected pushes, expected %llu",
+                 (unsigned long)run.ring.dropped, (unsigned long long)run.full_spins);
+        run.errors++;
+    }
+    if (run.errors == 0 && spsc_ring_count(&run.ring) != 0) {
+        snprintf(run.error, sizeof(run.error), "%lu elements counted in the drained ring",
+                 (unsigned long)spsc_ring_count(&run.ring));
+        run.errors++;
+    }
+
+    printf("capacity %5lu  start 0x%08lx  %9llu items  %6.2f Mitems/s  full %9llu  empty %9llu  %s\n",
+           (unsigned long)capacity, (unsigned long)start, (unsigned long long)run.received,
+           elapsed > 0.0 ? run.received / elapsed / 1e6 : 0.0, (unsigned long long)run.full_spins,
+           (unsigned long long)run.empty_spins, run.errors == 0 ? "OK" : "FAIL");
+    if (run.errors != 0) {
+        printf("  %s\n", run.error);
+    }
+    free(storage);
+    return run.errors == 0;
+}
+
+static int usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [--items N]\n", argv0);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    uint64_t items = STRESS_DEFAULT_ITEMS;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--items") == 0 && i + 1 < argc) {
+            items = strtoull(argv[++i], NULL, 0);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (items == 0) {
+        return usage(argv[0]);
+    }
+
+    // Capacity 1 hands over every element; 1024 rarely fills
+    static const uint32_t capacities[] = { 1, 2, 16, 1024 };
+    bool ok = true;
+    for (size_t c = 0; c < sizeof(capacities) / sizeof(capacities[0]); c++) {
+        ok &= stress(capacities[c], 0, items);
+        ok &= stress(capacities[c], UINT32_MAX - (uint32_t)(items / 2), items);
+    }
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
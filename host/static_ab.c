@@ -0,0 +1,141 @@
+#include "nn_engine.h"
+#include "nn_static.h"
+#include "config.h"
+#include "fall_detection_model.h"
+
+// A/B run of the interpreter (nn_engine) against the generated template
+// kernels (nn_static) on the same windows:
+//
+//   static_ab [windows]
+//
+// Windows alternate between replayed motion and uniform noise over the whole
+// int8 range. Every output must match bit for bit; per-window latency of
+// both paths is reported. Exits non-zero on any difference.
+
+#define AB_DEFAULT_WINDOWS 200
+
+static uint32_t lcg_state = 12345;
+
+static uint32_t lcg_next(void) {
+    lcg_state = lcg_state * 1664525u + 1013904223u;
+    return lcg_state >> 8;
+}
+
+static void make_window(const nn_model_t* model, int w, int8_t* input) {
+    for (int t = 0; t < model->seq_len; t++) {
+        for (int f = 0; f < model->features; f++) {
+            int8_t* q = &input[t * model->features + f];
+            if (w % 2 == 1) {
+                *q = (int8_t)(lcg_next() & 0xFF);
+                continue;
+            }
+            // Scaled sensor units: gravity on z, a swing on x/gyro y, noise
+            float s = (float)t / SAMPLE_RATE_HZ + 0.37f * (float)w;
+            float v = f == 2 ? 0.5f : 0.0f;
+            if (f == 0 || f == 4) {
+                v += 0.4f * sinf(2.0f * (float)M_PI * (0.5f + 0.1f * (float)(w % 7)) * s);
+            }
+            v += 0.02f * (float)((int)(lcg_next() % 201) - 100) / 100.0f;
+            *q = nn_quantize_f32(v, model->input_q);
+        }
+    }
+}
+
+static int compare_s64(const void* a, const void* b) {
+    int64_t x = *(const int64_t*)a;
+    int64_t y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void print_latency(const char* name, int64_t* us, int n) {
+    qsort(us, (size_t)n, sizeof(us[0]), compare_s64);
+    int64_t sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += us[i];
+    }
+    printf("  %-12s median %6lld us, p90 %6lld us, mean %8.1f us\n", name,
+           (long long)us[n / 2], (long long)us[n * 9 / 10], (double)sum / n);
+}
+
+int main(int argc, char** argv) {
+    int windows = argc > 1 ? atoi(argv[1]) : AB_DEFAULT_WINDOWS;
+    if (windows <= 0) {
+        fprintf(stderr, "usage: %s [windows]\n", argv[0]);
+        return 2;
+    }
+
+    static nn_model_t model;
+    if (nn_model_load(&model, fall_detection_model, fall_detection_model_len) != ESP_OK) {
+        return 1;
+    }
+    if (!nn_static_matches(&model)) {
+        fprintf(stderr, "built-in model does not match the generated kernels (%s)\n", nn_static_shape());
+        return 1;
+    }
+
+    size_t engine_arena_size = nn_engine_arena_size(&model);
+    size_t static_arena_size = nn_static_arena_size();
+    uint8_t* engine_arena = aligned_alloc(NN_ARENA_ALIGNMENT, engine_arena_size);
+    uint8_t* static_arena = aligned_alloc(NN_ARENA_ALIGNMENT, static_arena_size);
+    int8_t* input = malloc((size_t)model.seq_len * model.features);
+    int64_t* engine_us = malloc(sizeof(int64_t) * windows);
+    int64_t* static_us = malloc(sizeof(int64_t) * windows);
+    if (engine_arena == NULL || static_arena == NULL || input == NULL || engine_us == NULL || static_us == NULL) {
+        return 1;
+    }
+
+    nn_engine_t engine;
+    nn_static_engine_t fixed;
+    if (nn_engine_init(&engine, &model, engine_arena, engine_arena_size) != ESP_OK ||
+        nn_static_init(&fixed, &model, static_arena, static_arena_size) != ESP_OK) {
+        return 1;
+    }
+
+    int mismatches = 0;
+    for (int w = 0; w < windows; w++) {
+        int8_t a[NN_MAX_CHANNELS];
+        int8_t b[NN_MAX_CHANNELS];
+        make_window(&model, w, input);
+
+        // Alternate which path runs first so cache warmth favours neither
+        for (int pass = 0; pass < 2; pass++) {
+            int64_t start = esp_timer_get_time();
+            if ((pass + w) % 2 == 0) {
+                nn_engine_invoke(&engine, input, a);
+                engine_us[w] = esp_timer_get_time() - start;
+            } else {
+                nn_static_invoke(&fixed, input, b);
+                static_us[w] = esp_timer_get_time() - start;
+            }
+        }
+
+        if (memcmp(a, b, (size_t)model.classes) != 0) {
+            if (mismatches++ < 5) {
+                printf("window %d differs:", w);
+                for (int c = 0; c < model.classes; c++) {
+                    printf(" %d/%d", a[c], b[c]);
+                }
+                printf("\n");
+            }
+        }
+    }
+
+    printf("\nInterpreter vs template kernels (%s), %d windows\n", nn_static_shape(), windows);
+    printf("  arena: interpreter %zu bytes, static %zu bytes\n", engine_arena_size, static_arena_size);
+    int64_t engine_median;
+    int64_t static_median;
+    print_latency("interpreter", engine_us, windows);
+    engine_median = engine_us[windows / 2];
+    print_latency("static", static_us, windows);
+    static_median = static_us[windows / 2];
+    printf("  speedup (median): %.2fx\n", static_median > 0 ? (double)engine_median / static_median : 0.0);
+    printf("  outputs: %d of %d windows differ\n", mismatches, windows);
+    printf("%s\n", mismatches == 0 ? "PASS" : "FAIL");
+
+    free(engine_arena);
+    free(static_arena);
+    free(input);
+    free(engine_us);
+    free(static_us);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -5,14 +5,24 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include "port.h"
+
+#ifdef ESP_PLATFORM
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <esp_system.h>
+#include <driver/i2c.h>
+#include <driver/gpio.h>
+#elif defined(HOST_OSAL)
+// Same services from the host OSAL (host/osal)
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/queue.h>
 #include <esp_system.h>
-#include <esp_log.h>
-#include <esp_timer.h>
 #include <driver/i2c.h>
 #include <driver/gpio.h>
+#endif
 
 // Debug configuration
 #define DEBUG_ENABLE 1
@@ -34,8 +44,26 @@
 #define MPU6050_SDA_PIN 21
 #define MPU6050_SCL_PIN 22
 #define MPU6050_I2C_FREQ 400000
+#define MPU6050_I2C_RETRIES 2           // extra attempts for a NACKed or timed-out transfer
+#define MPU6050_FIFO_MODE 0             // drain the sensor FIFO in bursts instead of one read per sample
+#define MPU6050_FIFO_BURST_SAMPLES 25   // samples per burst (one inference hop, 0.5 s)
+#define MPU6050_FIFO_CHUNK_SAMPLES 2    // samples per FIFO_R_W transfer: a failed one loses only these
+#define MPU6050_INT_MODE 0              // pace acquisition from the DATA_RDY interrupt (needs INT wired)
+#define MPU6050_INT_PIN 10              // MPU6050 INT -> GPIO
 
-// Model Configuration
+// Recorded trace instead of the MPU6050 (trace_replay.h): CSV or packed
+// binary from the spiffs partition on the target, a file on the host
+#define SENSOR_SOURCE_REPLAY 0
+#define TRACE_REPLAY_PARTITION "spiffs"
+#define TRACE_REPLAY_MOUNT "/spiffs"
+#define REPLAY_TRACE_PATH TRACE_REPLAY_MOUNT "/trace.csv"
+#define REPLAY_HOST_PATH "trace.csv"
+#define REPLAY_REALTIME 1               // 1: SAMPLE_RATE_HZ, 0: as fast as inference keeps up
+#define REPLAY_LOOP 1                   // start over at the end of the trace
+
+// Model Configuration. A model image with metadata may use a shorter window
+// and fewer classes; these are the built-in model's values and the buffer
+// capacities.
 #define INPUT_SEQUENCE_LENGTH 301
 #define INPUT_FEATURES 6
 #define NUM_CLASSES 5
@@ -46,39 +74,99 @@
 #define SAMPLE_RATE_HZ 50
 #define SAMPLE_INTERVAL_MS (1000 / SAMPLE_RATE_HZ)
 #define BUFFER_SIZE INPUT_SEQUENCE_LENGTH
+#define INFERENCE_HOP_SIZE 25   // new samples between consecutive windows
+#define SAMPLE_RING_SIZE 64     // sensor -> inference task ring, power of two
+
+#if MPU6050_FIFO_MODE && (MPU6050_FIFO_BURST_SAMPLES * 2 > SAMPLE_RING_SIZE)
+#error "SAMPLE_RING_SIZE must hold two FIFO bursts"
+#endif
+
+// Inference cadence, applied to each ready window
+#define INFERENCE_CADENCE_EVERY_HOP     0   // run the model on every window
+#define INFERENCE_CADENCE_EVERY_N_HOPS  1   // run on every INFERENCE_CADENCE_N-th window
+#define INFERENCE_CADENCE_ON_TRIGGER    2   // run when the motion prefilter fires
+#define INFERENCE_CADENCE INFERENCE_CADENCE_ON_TRIGGER
+#define INFERENCE_CADENCE_N 4
+#define INFERENCE_WAIT_TIMEOUT_MS 1000  // safety wake-up if a notification is missed
+
+// Streaming inference: advance the Conv1D/LSTM front end per sample and run
+// only the attention/Dense head per window. LSTM state then carries over
+// between windows instead of restarting at each window, so results differ
+// slightly from full-window inference. This is also the only build that runs
+// the single-pass online attention; with it off, the full-window paths keep
+// the exported two-pass attention and its [T x 16] top-LSTM buffer.
+#define INFERENCE_STREAMING 0
+
+// Full-window inference through the shape-specialized template kernels
+// (nn_static.h, generated from the built-in model) whenever the loaded model
+// has the same shapes; other models use the interpreter. Outputs are
+// identical either way. Ignored with INFERENCE_STREAMING.
+#define INFERENCE_STATIC_KERNELS 1
+
+// Two-stage pipelined full-window inference (nn_pipeline.h): the conv blocks
+// run in the pipeline task on core 0 and stream pooled chunks to the
+// LSTM/attention/Dense stages on the inference task (core 1). Outputs are
+// identical to the other full-window paths. Takes precedence over
+// INFERENCE_STATIC_KERNELS; ignored with INFERENCE_STREAMING.
+#define INFERENCE_PIPELINED 0
+
+// Print activation table accuracy and cycles/element against libm at boot
+#define NN_LUT_REPORT_AT_BOOT 0
+
+// Time every layer of the loaded model at boot (nn_bench.h) and print the
+// results as a table and as CSV lines host/layer_bench can compare
+#define NN_BENCH_AT_BOOT 0
+#define NN_BENCH_ITERATIONS 50
+
+// Motion prefilter: skip windows without a candidate event or activity change
+#define PREFILTER_ENABLE 1
+#define PREFILTER_FREEFALL_MG 500           // |a| below this is free fall
+#define PREFILTER_FREEFALL_SAMPLES 3        // for at least this many samples
+#define PREFILTER_IMPACT_MG 2000            // |a| above this is an impact
+#define PREFILTER_GYRO_RMS_DPS 60           // window RMS angular rate
+#define PREFILTER_ACTIVITY_DELTA_MG 40      // change in mean dynamic acceleration
+#define PREFILTER_HOLD_WINDOWS 12           // keep inferring after an event (~ one window)
+#define PREFILTER_KEEPALIVE_WINDOWS 20      // infer at least this often
+
+// Memory placement, most preferred region first (mem_placement.h). Weights
+// can stay in flash; the other classes are written and need RAM.
+#define MEM_POLICY_WEIGHTS      MEM_REGION_FLASH
+#define MEM_POLICY_ACTIVATIONS  MEM_REGION_INTERNAL, MEM_REGION_PSRAM
+#define MEM_POLICY_LSTM_STATE   MEM_REGION_INTERNAL, MEM_REGION_PSRAM
+#define MEM_POLICY_SAMPLE_RING  MEM_REGION_INTERNAL, MEM_REGION_PSRAM
+
+// Model image (model_store.h): the "model_a" data partition on the target
+// ("model_b" if A holds no valid image), a file on the host. Without a valid
+// image the compiled-in model is used. Runtime swaps load the partition the
+// active model does not map (tflite_stage_model()).
+#define MODEL_PARTITION_LABEL "model_a"
+#define MODEL_PARTITION_LABEL_B "model_b"
+#define MODEL_PARTITION_SUBTYPE 0x40        // custom data subtype in partitions.csv
+#define MODEL_HOST_PATH "fall_detection_model.bin"
+#define MODEL_EMBEDDED_FALLBACK 1           // src/fall_detection_model.h
+
+// Input scaling of the built-in model and of images without metadata:
+// accel / 2 g and gyro / 250 dps, clamped to [-1, 1]
+#define MODEL_DEFAULT_ACCEL_SCALE_G 2.0f
+#define MODEL_DEFAULT_GYRO_SCALE_DPS 250.0f
 
 // Task priorities
 #define MPU6050_TASK_PRIORITY 5
 #define INFERENCE_TASK_PRIORITY 4
+#define PIPELINE_TASK_PRIORITY 4
 #define DEBUG_TASK_PRIORITY 3
 
 // Task stack sizes
 #define MPU6050_TASK_STACK_SIZE 4096
 #define INFERENCE_TASK_STACK_SIZE 8192
+#define PIPELINE_TASK_STACK_SIZE 4096
 #define DEBUG_TASK_STACK_SIZE 2048
 
 // Queue sizes
 #define MPU6050_QUEUE_SIZE 10
 #define INFERENCE_QUEUE_SIZE 5
 
-// Error codes (only define if not already defined by ESP-IDF)
-#ifndef ESP_OK
-#define ESP_OK 0
-#endif
-
-#ifndef ESP_ERR_INVALID_ARG
-#define ESP_ERR_INVALID_ARG -1
-#endif
-
-#ifndef ESP_ERR_NO_MEM
-#define ESP_ERR_NO_MEM -2
-#endif
-
-#ifndef ESP_ERR_TIMEOUT
-#define ESP_ERR_TIMEOUT -3
-#endif
-
-// Class labels
+// Class labels of the built-in model (model_store.c)
 extern const char* CLASS_LABELS[NUM_CLASSES];
 
 #endif // CONFIG_H
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef MEM_PLACEMENT_H
+#define MEM_PLACEMENT_H
+
+#include "port.h"
+
+// Memory placement policy for the inference buffers.
+// Every buffer belongs to a class, and every class has an ordered list of
+// preferred regions. A buffer goes to the first region on the list that can
+// hold it; falling back to a later region is logged and shown in the boot
+// report together with the measured read cost of each buffer.
+//
+// On the host the regions are simulated: each has a configurable capacity
+// and a per-cache-line read latency, so fallback and reporting behave as on
+// the target.
+
+typedef enum {
+    MEM_REGION_INTERNAL,    // on-chip SRAM
+    MEM_REGION_PSRAM,       // external octal PSRAM, through the data cache
+    MEM_REGION_FLASH,       // read-only data left in the memory-mapped flash image
+    MEM_REGION_COUNT,
+} mem_region_t;
+
+typedef enum {
+    MEM_CLASS_WEIGHTS,      // model flatbuffer (weights are used in place)
+    MEM_CLASS_ACTIVATIONS,  // full-window tensor arena
+    MEM_CLASS_LSTM_STATE,   // streaming arena: LSTM h/c and history kept between samples
+    MEM_CLASS_SAMPLE_RING,  // sensor sample ring and window ring
+    MEM_CLASS_COUNT,
+} mem_class_t;
+
+#define MEM_MAX_PLACEMENTS 8
+#define MEM_COST_LINE_BYTES 64
+
+typedef struct {
+    mem_region_t regions[MEM_REGION_COUNT];     // most preferred first
+    int count;
+} mem_policy_t;
+
+typedef struct {
+    const char* name;
+    mem_class_t cls;
+    mem_region_t region;
+    bool fallback;          // not the policy's first choice
+    bool owned;             // allocated here, as opposed to data left in flash
+    const void* ptr;
+    size_t size;
+    size_t align;
+    uint32_t read_cost;     // per MEM_COST_LINE_BYTES, cycles on target / ns on host
+} mem_placement_t;
+
+// Writable classes cannot use MEM_REGION_FLASH. Weights can always fall back
+// to flash, where the data already is.
+esp_err_t mem_set_policy(mem_class_t cls, const mem_region_t* regions, int count);
+const mem_policy_t* mem_get_policy(mem_class_t cls);
+
+// Writable buffer in the first region of the class policy that can hold it
+void* mem_alloc(mem_class_t cls, const char* name, size_t size, size_t align);
+
+// Read-only data already in flash: copied into the first RAM region the
+// policy prefers over flash, otherwise returned as is
+const void* mem_place_const(mem_class_t cls, const char* name, const void* data, size_t size, size_t align);
+
+void mem_free(const void* ptr);
+
+const mem_placement_t* mem_find(const void* ptr);
+const char* mem_region_name(mem_region_t region);
+const char* mem_class_name(mem_class_t cls);
+
+// Placement, fallbacks, read cost and free space per region
+void mem_report(void);
+
+#ifndef ESP_PLATFORM
+// Host simulation of the target regions
+void mem_sim_configure(mem_region_t region, size_t capacity, uint32_t line_ns);
+void mem_sim_reset(void);
+#endif
+
+#endif // MEM_PLACEMENT_H
@@ -0,0 +1,101 @@
+#ifndef MODEL_STORE_H
+#define MODEL_STORE_H
+
+#include "port.h"
+
+// Model storage outside the firmware image.
+// A model image is a small header, the .tflite flatbuffer and a metadata
+// block describing how to feed the model: window shape, quantization,
+// RobustScaler center/scale per channel and class labels. On the target it is written to its own flash data partition and mapped with
+// esp_partition_mmap(); on the host it is a file mapped with mmap(). Either
+// way the engine runs straight from the mapping, nothing is copied.
+//
+// Images are produced by the host tool model_pack.
+
+#define MODEL_IMAGE_MAGIC   0x4C444D46u     // "FMDL"
+#define MODEL_IMAGE_VERSION 2               // 1: flatbuffer only, 2: adds the metadata block
+#define MODEL_IMAGE_ALIGN   16              // payload offset alignment for the flatbuffer
+#define MODEL_IMAGE_V1_HEADER_BYTES 16
+
+// All fields little endian. The metadata block follows the payload at the
+// next 4-byte boundary.
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;       // payload offset, a multiple of MODEL_IMAGE_ALIGN
+    uint32_t payload_size;
+    uint32_t payload_crc32;     // CRC-32 (IEEE 802.3) of the payload
+    uint32_t meta_size;         // version 2
+    uint32_t meta_crc32;
+} model_image_header_t;
+
+#define MODEL_META_MAGIC        0x4154454Du // "META"
+#define MODEL_META_VERSION      1
+#define MODEL_META_MAX_FEATURES 8
+#define MODEL_META_MAX_CLASSES  8
+#define MODEL_META_LABEL_LEN    16
+
+// Feature f is fed to the model as clamp((x - center[f]) / scale[f], clip_min,
+// clip_max), x in g for accel and deg/s for gyro (sklearn RobustScaler
+// center_ and scale_ of the training data)
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t seq_len;
+    uint8_t features;
+    uint8_t classes;
+    uint16_t sample_rate_hz;
+    float input_scale;          // quantization as exported, checked against the graph
+    int32_t input_zero_point;
+    float output_scale;
+    int32_t output_zero_point;
+    float center[MODEL_META_MAX_FEATURES];
+    float scale[MODEL_META_MAX_FEATURES];
+    float clip_min;
+    float clip_max;
+    char labels[MODEL_META_MAX_CLASSES][MODEL_META_LABEL_LEN];
+} model_meta_t;
+
+typedef enum {
+    MODEL_SOURCE_NONE,
+    MODEL_SOURCE_PARTITION,
+    MODEL_SOURCE_FILE,
+    MODEL_SOURCE_EMBEDDED,
+} model_source_t;
+
+typedef struct {
+    const uint8_t* data;        // flatbuffer inside the mapping
+    size_t size;
+    model_source_t source;
+    const void* map;            // whole mapped image, NULL for embedded data
+    size_t map_size;
+    uint32_t handle;            // esp_partition_mmap_handle_t on the target
+    bool has_meta;              // false: meta holds the model_meta_default() values
+    model_meta_t meta;
+} model_blob_t;
+
+uint32_t model_crc32(uint32_t crc, const void* data, size_t size);
+
+// Metadata of the built-in model, from config.h; also used for version 1
+// images
+void model_meta_default(model_meta_t* meta);
+esp_err_t model_meta_check(const model_meta_t* meta);
+
+// meta may be NULL for a version 1 image. The header is followed by padding
+// up to header_size, the payload, padding to 4 bytes and the metadata.
+void model_image_header_init(model_image_header_t* header, const void* payload, size_t payload_size,
+                             const model_meta_t* meta);
+size_t model_image_meta_offset(const model_image_header_t* header);
+
+// Checks magic, version, bounds and CRCs of an image of `size` bytes and
+// points blob->data at the payload
+esp_err_t model_image_validate(const void* image, size_t size, model_blob_t* blob);
+
+// Maps and validates the model image: location is the partition label on
+// the target and a file path on the host
+esp_err_t model_store_open(const char* location, model_blob_t* blob);
+void model_store_close(model_blob_t* blob);
+
+const char* model_source_name(model_source_t source);
+
+#endif // MODEL_STORE_H
@@ -2,9 +2,11 @@
 #define MPU6050_DRIVER_H
 
 #include "config.h"
+#ifdef ESP_PLATFORM
 #include "esp_err.h"
 #include "driver/i2c.h"
 #include "esp_log.h"
+#endif
 
 // MPU6050 Register addresses
 #define MPU6050_REG_PWR_MGMT_1    0x6B
@@ -16,6 +18,14 @@
 #define MPU6050_REG_GYRO_XOUT_H   0x43
 #define MPU6050_REG_TEMP_OUT_H    0x41
 #define MPU6050_REG_WHO_AM_I      0x75
+#define MPU6050_REG_SMPLRT_DIV    0x19
+#define MPU6050_REG_FIFO_EN       0x23
+#define MPU6050_REG_INT_PIN_CFG   0x37
+#define MPU6050_REG_INT_ENABLE    0x38
+#define MPU6050_REG_INT_STATUS    0x3A
+#define MPU6050_REG_USER_CTRL     0x6A
+#define MPU6050_REG_FIFO_COUNTH   0x72
+#define MPU6050_REG_FIFO_R_W      0x74
 
 // MPU6050 Configuration values
 #define MPU6050_WHO_AM_I_VALUE    0x70
@@ -28,8 +38,46 @@
 #define MPU6050_GYRO_FS_1000      0x10
 #define MPU6050_GYRO_FS_2000      0x18
 
+// Sensitivity for the configured ±2g / ±250°/s ranges
+#define MPU6050_ACCEL_LSB_PER_G   16384.0f
+#define MPU6050_GYRO_LSB_PER_DPS  131.0f
+
+// FIFO configuration
+#define MPU6050_FIFO_EN_ACCEL_GYRO  0x78    // XG | YG | ZG | ACCEL
+#define MPU6050_USER_CTRL_FIFO_EN   0x40
+#define MPU6050_USER_CTRL_FIFO_RST  0x04
+#define MPU6050_INT_FIFO_OFLOW      0x10
+#define MPU6050_FIFO_SIZE           1024
+#define MPU6050_FIFO_SAMPLE_BYTES   12      // accel xyz + gyro xyz, big endian
+#define MPU6050_FIFO_MAX_SAMPLES    (MPU6050_FIFO_SIZE / MPU6050_FIFO_SAMPLE_BYTES)
+#define MPU6050_GYRO_RATE_DLPF_HZ   1000    // gyro output rate with the DLPF enabled
+
+// Interrupt configuration
+#define MPU6050_INT_PIN_CFG_RD_CLEAR 0x10   // active high push-pull 50 us pulse, cleared on any read
+#define MPU6050_INT_DATA_RDY_EN     0x01
+#define MPU6050_INT_DATA_RDY        0x01    // INT_STATUS: data registers updated since last read
+#define MPU6050_INT_TIMESTAMPS      128     // ISR timestamps awaiting their sample, power of two
+
+// Sample interval jitter: |interval - period| in microseconds, binned at
+// 50, 100, 250, 500, 1000, 2000, 5000 and above
+#define MPU6050_JITTER_BINS 8
+
+typedef struct {
+    uint32_t bins[MPU6050_JITTER_BINS];
+    uint32_t intervals;
+    uint32_t max_us;
+    uint64_t last_timestamp;
+} mpu6050_jitter_t;
+
+// Raw register values, 12 bytes per sample
+typedef struct {
+    int16_t accel[3];
+    int16_t gyro[3];
+} mpu6050_raw_t;
+
 // Data structure for MPU6050 readings
 typedef struct {
+    mpu6050_raw_t raw;
     float accel_x;
     float accel_y;
     float accel_z;
@@ -40,8 +88,46 @@ typedef struct {
     uint64_t timestamp;
 } mpu6050_data_t;
 
+static inline int16_t mpu6050_saturate_s16(float v) {
+    long r = lrintf(v);
+    return (int16_t)(r < INT16_MIN ? INT16_MIN : (r > INT16_MAX ? INT16_MAX : r));
+}
+
+// Fills raw from the physical units, for samples that did not come from the
+// sensor registers (replayed or synthetic data)
+static inline void mpu6050_encode_raw(mpu6050_data_t* data) {
+    data->raw.accel[0] = mpu6050_saturate_s16(data->accel_x * MPU6050_ACCEL_LSB_PER_G);
+    data->raw.accel[1] = mpu6050_saturate_s16(data->accel_y * MPU6050_ACCEL_LSB_PER_G);
+    data->raw.accel[2] = mpu6050_saturate_s16(data->accel_z * MPU6050_ACCEL_LSB_PER_G);
+    data->raw.gyro[0] = mpu6050_saturate_s16(data->gyro_x * MPU6050_GYRO_LSB_PER_DPS);
+    data->raw.gyro[1] = mpu6050_saturate_s16(data->gyro_y * MPU6050_GYRO_LSB_PER_DPS);
+    data->raw.gyro[2] = mpu6050_saturate_s16(data->gyro_z * MPU6050_GYRO_LSB_PER_DPS);
+}
+
+// Register access underneath the driver. The default transport is the IDF
+// I2C master on MPU6050_I2C_PORT; a simulator or a test double can take its
+// place. read and write move len bytes from/to consecutive registers
+// starting at reg; init is optional and runs from mpu6050_init().
+typedef struct {
+    esp_err_t (*init)(void* ctx);
+    esp_err_t (*read)(void* ctx, uint8_t reg, uint8_t* data, size_t len);
+    esp_err_t (*write)(void* ctx, uint8_t reg, const uint8_t* data, size_t len);
+    void* ctx;
+} mpu6050_transport_t;
+
+// Transfers as the driver saw them. A NACKed or timed-out transfer is
+// retried up to MPU6050_I2C_RETRIES times before the error is returned,
+// except FIFO_R_W reads, which mpu6050_read_fifo() recovers from by finding
+// the sample boundaries again.
+typedef struct {
+    uint32_t transactions;      // attempts, retries included
+    uint32_t retries;
+    uint32_t errors;            // transfers that failed every attempt
+} mpu6050_bus_stats_t;
+
 // Function declarations
 esp_err_t mpu6050_init(void);
+// ESP_ERR_NOT_FOUND: the sensor has not taken a sample since the last read
 esp_err_t mpu6050_read_data(mpu6050_data_t* data);
 esp_err_t mpu6050_configure(void);
 esp_err_t mpu6050_reset(void);
@@ -49,7 +135,31 @@ esp_err_t mpu6050_wake_up(void);
 esp_err_t mpu6050_sleep(void);
 bool mpu6050_is_connected(void);
 
-// I2C helper functions
+// FIFO burst mode
+esp_err_t mpu6050_fifo_enable(void);
+esp_err_t mpu6050_fifo_disable(void);
+esp_err_t mpu6050_fifo_reset(void);
+esp_err_t mpu6050_fifo_count(uint16_t* samples);
+// On an error *count still holds the samples read before it, which are
+// valid; the samples after them may be missing.
+esp_err_t mpu6050_read_fifo(mpu6050_data_t* samples, size_t max_samples, size_t* count);
+
+// DATA_RDY interrupt mode: the ISR timestamps every sample and notifies
+// task once per samples_per_wake samples (the MPU6050 has no FIFO
+// watermark interrupt, so the burst size is counted in the ISR)
+esp_err_t mpu6050_int_enable(TaskHandle_t task, uint32_t samples_per_wake);
+esp_err_t mpu6050_int_disable(void);
+
+// Timestamp jitter of the samples delivered by the driver
+void mpu6050_get_jitter(mpu6050_jitter_t* jitter);
+void mpu6050_print_jitter(void);
+
+// Replaces the transport (copied; NULL restores the I2C master). Call before
+// mpu6050_init().
+void mpu6050_set_transport(const mpu6050_transport_t* transport);
+void mpu6050_get_bus_stats(mpu6050_bus_stats_t* stats);
+
+// I2C helper functions, through the transport
 esp_err_t mpu6050_i2c_init(void);
 esp_err_t mpu6050_i2c_read_byte(uint8_t reg, uint8_t* data);
 esp_err_t mpu6050_i2c_write_byte(uint8_t reg, uint8_t data);
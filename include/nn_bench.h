@@ -0,0 +1,75 @@
+#ifndef NN_BENCH_H
+#define NN_BENCH_H
+
+#include "port.h"
+#include "nn_model.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Per-layer latency of the int8 engine on the shapes of a bound model.
+// Each kernel is timed on its own, on the activations a real window
+// produces, and then the whole model through the interpreter and (when the
+// shapes match) the generated template kernels:
+//
+//   conv1, conv2   Conv1D + BN + ReLU + MaxPool block (fused when the model is)
+//   lstm1, lstm2   hoisted input GEMM and all time steps of one layer
+//   attention      attention over the last LSTM layer (online or two-pass)
+//   dense          Dense layers and softmax on the attention context
+//   model          nn_engine_invoke()
+//   model_static   nn_static_invoke()
+//
+// Times are CPU cycles on the target and nanoseconds on the host; results
+// carry their unit and are only compared against results in the same unit.
+
+#define NN_BENCH_MAX_CASES  8
+#define NN_BENCH_NAME_LEN   16
+#define NN_BENCH_SHAPE_LEN  32
+#define NN_BENCH_UNIT_LEN   8
+#define NN_BENCH_WARMUP     3           // untimed runs before each case
+
+typedef struct {
+    char name[NN_BENCH_NAME_LEN];
+    char shape[NN_BENCH_SHAPE_LEN];     // e.g. "301x6->16 k3 pool2"
+    uint32_t iterations;
+    uint32_t min;
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+    uint32_t max;
+    uint32_t mean;
+} nn_bench_result_t;
+
+typedef struct {
+    char unit[NN_BENCH_UNIT_LEN];       // "cycles" or "ns"
+    int count;
+    nn_bench_result_t cases[NN_BENCH_MAX_CASES];
+} nn_bench_report_t;
+
+// Times every case iterations times. Buffers are allocated for the run and
+// freed before returning.
+esp_err_t nn_bench_run(const nn_model_t* model, int iterations, nn_bench_report_t* report);
+
+// Human-readable table on the log
+void nn_bench_print(const nn_bench_report_t* report);
+
+// Machine-readable results, one header line then one line per case:
+//   case,shape,unit,iterations,min,p50,p90,p99,max,mean
+void nn_bench_write_csv(const nn_bench_report_t* report, FILE* out);
+
+// Reads results written by nn_bench_write_csv(). Lines that are not results
+// are skipped, so a captured serial log can be read as is.
+esp_err_t nn_bench_load_csv(const char* path, nn_bench_report_t* report);
+
+// Compares the median of every case present in both reports and prints one
+// line per case. A case more than threshold_pct percent slower than the
+// baseline counts as a regression. ESP_ERR_INVALID_ARG when the units differ.
+esp_err_t nn_bench_compare(const nn_bench_report_t* baseline, const nn_bench_report_t* current,
+                           float threshold_pct, int* regressions);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NN_BENCH_H
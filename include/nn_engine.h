@@ -0,0 +1,119 @@
+#ifndef NN_ENGINE_H
+#define NN_ENGINE_H
+
+#include "port.h"
+#include "nn_model.h"
+#include "nn_planner.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Native int8 executor for a bound nn_model_t.
+// All intermediate tensors live in a caller-provided arena; nothing is
+// allocated after nn_engine_init(). The arena layout comes from the lifetime
+// planner (nn_planner.h), so tensors that are never live together share
+// storage.
+
+#define NN_ARENA_ALIGNMENT 16
+
+// Compute W_x * x_t for the whole sequence as one GEMM before the recurrence
+// (costs steps * 4 * units bytes of arena); 0 keeps it inside every step
+#ifndef NN_LSTM_HOIST_INPUT
+#define NN_LSTM_HOIST_INPUT 1
+#endif
+
+// Scratch for one LSTM step: x and h projections, pre-activations and
+// activations for the four gates, then forget/update/cell/tanh(cell)
+#define NN_LSTM_SCRATCH_ROWS (4 * NN_GATES + 4)
+
+// Buffers for the attention + Dense head; scores, weights and weighted are
+// only placed for the reference (two-pass) attention
+typedef struct {
+    int8_t* scores;
+    int8_t* weights;
+    int8_t* weighted;
+    int8_t* context;
+    int8_t* hidden;
+    int8_t* logits;
+} nn_head_buffers_t;
+
+// Single-pass softmax attention: running maximum score, running sum of
+// exp(score_t - max) and running exp-weighted sum of h_t, all rescaled by
+// exp(old max - new max) when the maximum moves
+typedef struct {
+    int steps;
+    int8_t max_score;
+    int32_t sum;                        // Q0.15
+    int32_t acc[NN_MAX_CHANNELS];       // Q0.15 * (h - zero point)
+} nn_attention_state_t;
+
+typedef struct {
+    const nn_model_t* model;
+    uint8_t* arena;
+    size_t arena_size;
+
+    // Intermediate tensors inside the arena
+    int8_t* conv_out[NN_CONV_BLOCKS];      // reference path only
+    int8_t* pool_out[NN_CONV_BLOCKS];
+    int8_t* lstm_out[NN_LSTM_LAYERS];  // online attention: last layer keeps two rows
+    int8_t* lstm_scratch;       // gate projections and activations for one step
+    int8_t* lstm_xproj;         // hoisted input projections [steps][4 * units]
+    int8_t* lstm_cell;          // c_{t-1}
+    int8_t* lstm_h0;            // initial hidden state
+    nn_head_buffers_t head;
+    nn_attention_state_t attention;
+
+    nn_plan_report_t plan;
+} nn_engine_t;
+
+size_t nn_engine_arena_size(const nn_model_t* model);
+void nn_engine_print_plan(const nn_model_t* model);
+esp_err_t nn_engine_init(nn_engine_t* engine, const nn_model_t* model, uint8_t* arena, size_t arena_size);
+
+// input: [seq_len][features] int8 quantized with model->input_q
+// output: [classes] int8 quantized with model->output_q
+esp_err_t nn_engine_invoke(nn_engine_t* engine, const int8_t* input, int8_t* output);
+
+// Building blocks shared with the streaming executor (nn_stream.h)
+int nn_lstm_max_units(const nn_model_t* model);
+size_t nn_head_buffers_size(const nn_model_t* model);
+void nn_head_buffers_place(const nn_model_t* model, uint8_t* base, nn_head_buffers_t* buffers);
+
+// BatchNorm MUL + ADD of a conv block, in place over n elements
+void nn_conv_block_bn(const nn_conv_block_t* block, int8_t* x, int n);
+
+// Zero h/c state in each tensor's own quantization
+void nn_lstm_reset_state(const nn_lstm_layer_t* layer, int8_t* h, int8_t* cell);
+
+// One LSTM time step. cell is updated in place; h_out may alias h_prev.
+// scratch holds NN_LSTM_SCRATCH_ROWS * units bytes.
+void nn_lstm_step(const nn_lstm_layer_t* layer, const int8_t* x, const int8_t* h_prev,
+                  int8_t* cell, int8_t* scratch, int8_t* h_out);
+
+// Same, with the input projection W_x * x_t + b ([i|f|g|o], 4 * units) already computed
+void nn_lstm_step_projected(const nn_lstm_layer_t* layer, const int8_t* proj_x, const int8_t* h_prev,
+                            int8_t* cell, int8_t* scratch, int8_t* h_out);
+
+// Online attention, one LSTM output row at a time, in window order
+void nn_attention_begin(nn_attention_state_t* state);
+void nn_attention_push(const nn_attention_layer_t* att, nn_attention_state_t* state, const int8_t* h);
+// context: [units] quantized with att->out_q
+void nn_attention_finish(const nn_attention_layer_t* att, const nn_attention_state_t* state, int8_t* context);
+
+// Attention over seq [steps][units] into buffers->context, single pass or
+// as exported depending on model->online_attention
+void nn_run_attention(const nn_model_t* model, const int8_t* seq, const nn_head_buffers_t* buffers);
+
+// Dense layers and softmax over buffers->context
+void nn_run_dense(const nn_model_t* model, const nn_head_buffers_t* buffers, int8_t* output);
+
+// Attention over seq [steps][units] followed by the Dense layers and softmax
+void nn_run_head(const nn_model_t* model, const int8_t* seq, const nn_head_buffers_t* buffers,
+                 int8_t* output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NN_ENGINE_H
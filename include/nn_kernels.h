@@ -0,0 +1,207 @@
+#ifndef NN_KERNELS_H
+#define NN_KERNELS_H
+
+#include "port.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Integer kernels for the int8 fall detection graph.
+// Arithmetic follows the TensorFlow Lite int8 reference kernels (fixed point
+// requantization with a Q31 multiplier and power-of-two shift) so results
+// stay within one quantization step of the TFLite interpreter.
+
+#define NN_MAX_CHANNELS 64
+#define NN_MAX_KERNEL   8
+
+// Affine quantization parameters: real = scale * (q - zero_point)
+typedef struct {
+    float scale;
+    int32_t zero_point;
+} nn_qparam_t;
+
+// Fixed point multiplier: real ~= multiplier * 2^(shift - 31)
+typedef struct {
+    int32_t multiplier;
+    int32_t shift;
+} nn_requant_t;
+
+typedef struct {
+    int kernel;
+    int cin;
+    int cout;
+    const int8_t* weights;              // [cout][kernel][cin]
+    int32_t bias[NN_MAX_CHANNELS];
+    nn_requant_t rq[NN_MAX_CHANNELS];
+    int32_t input_offset;               // -input zero point
+    int32_t output_offset;              // output zero point
+    int32_t act_min;
+    int32_t act_max;
+} nn_conv1d_params_t;
+
+typedef struct {
+    int in;
+    int out;
+    const int8_t* weights;              // [out][in]
+    bool has_bias;
+    int32_t bias[NN_MAX_CHANNELS];
+    nn_requant_t rq;
+    int32_t input_offset;
+    int32_t output_offset;
+    int32_t act_min;
+    int32_t act_max;
+} nn_fc_params_t;
+
+// Several FC layers over the same input stacked into one [out][in] matrix.
+// Rows come in equal segments, each with its own requantization; the input
+// offset is folded into the bias so the inner loop is a plain int8 MAC.
+#define NN_GEMM_MAX_ROWS     128
+#define NN_GEMM_MAX_SEGMENTS 4
+
+typedef struct {
+    int in;
+    int out;
+    int segment_rows;
+    const int8_t* weights;                      // [out][in]
+    int32_t bias[NN_GEMM_MAX_ROWS];             // bias + input_offset * sum(row)
+    nn_requant_t rq[NN_GEMM_MAX_SEGMENTS];
+    int32_t output_offset[NN_GEMM_MAX_SEGMENTS];
+    int32_t act_min;
+    int32_t act_max;
+} nn_gemm_params_t;
+
+typedef struct {
+    int32_t input1_offset;
+    int32_t input2_offset;
+    int32_t output_offset;
+    int32_t left_shift;
+    nn_requant_t input1_rq;
+    nn_requant_t input2_rq;
+    nn_requant_t output_rq;
+} nn_add_params_t;
+
+typedef struct {
+    int32_t input1_offset;
+    int32_t input2_offset;
+    int32_t output_offset;
+    nn_requant_t rq;
+} nn_mul_params_t;
+
+// Conv1D(ReLU) -> BN -> MaxPool1D block run as one pass. With a
+// non-negative BN scale every step after the conv accumulator (conv
+// requantization and ReLU, BN MUL, BN ADD) is non-decreasing, so the pool
+// max is taken over accumulators and the exported int8 chain runs once per
+// pooled row, bit-identical to the op-by-op path.
+typedef struct {
+    int channels;
+    int pool;
+    nn_requant_t conv_rq[NN_MAX_CHANNELS];
+    int32_t conv_offset;                    // conv output zero point
+    int32_t act_min;                        // conv ReLU
+    int32_t act_max;
+    int32_t scale[NN_MAX_CHANNELS];         // BN scale with its offset applied, >= 0
+    nn_mul_params_t mul;
+    int32_t offset[NN_MAX_CHANNELS];        // BN offset rescaled by the ADD, per channel
+    nn_add_params_t add;
+} nn_bn_fold_t;
+
+// Per-channel int16 -> int8 input affine. The real input is
+// x = clamp(gain * raw + offset, lo, hi), quantized to the model input; all
+// of it is folded into an integer accumulator and one requantization.
+#define NN_INPUT_AFFINE_FRAC_BITS 8
+
+typedef struct {
+    int channels;
+    int32_t acc_offset[NN_MAX_CHANNELS];    // offset / gain in 2^-FRAC_BITS raw units
+    int32_t acc_min[NN_MAX_CHANNELS];
+    int32_t acc_max[NN_MAX_CHANNELS];
+    nn_requant_t rq[NN_MAX_CHANNELS];
+    int32_t output_offset;
+} nn_input_affine_t;
+
+typedef enum {
+    NN_ACT_SIGMOID,
+    NN_ACT_TANH,
+} nn_act_fn_t;
+
+// Sigmoid/tanh resolved for every int8 input at load time from the
+// constexpr tables in nn_lut.h
+typedef struct {
+    nn_act_fn_t fn;
+    nn_qparam_t in_q;
+    nn_qparam_t out_q;
+    int8_t lut[256];                        // indexed by input - INT8_MIN
+} nn_act_params_t;
+
+// Softmax over int8 logits: exp(beta * scale * (x - max)) for every distance
+// from the row maximum, Q0.15
+typedef struct {
+    int16_t exp_lut[256];
+    nn_qparam_t out_q;
+} nn_softmax_params_t;
+
+// Quantization helpers
+void nn_quantize_multiplier(double real, nn_requant_t* out);
+int32_t nn_requantize(int32_t acc, nn_requant_t rq);
+int8_t nn_quantize_f32(float value, nn_qparam_t q);
+float nn_dequantize_s8(int8_t value, nn_qparam_t q);
+bool nn_qparam_equal(nn_qparam_t a, nn_qparam_t b);
+
+static inline int8_t nn_clamp_s8(int32_t v, int32_t lo, int32_t hi) {
+    return (int8_t)(v < lo ? lo : (v > hi ? hi : v));
+}
+
+// Parameter setup
+void nn_add_params_init(nn_add_params_t* p, nn_qparam_t a, nn_qparam_t b, nn_qparam_t out);
+void nn_mul_params_init(nn_mul_params_t* p, nn_qparam_t a, nn_qparam_t b, nn_qparam_t out);
+void nn_act_params_init(nn_act_params_t* p, nn_act_fn_t fn, nn_qparam_t in_q, nn_qparam_t out_q);
+void nn_softmax_params_init(nn_softmax_params_t* p, nn_qparam_t in_q, float beta, nn_qparam_t out_q);
+// Stacks FC layers that share input and activation into one GEMM; weights
+// are copied into packed ([count * out][in])
+esp_err_t nn_gemm_params_pack(nn_gemm_params_t* p, const nn_fc_params_t* fcs, int count, int8_t* packed);
+esp_err_t nn_input_affine_init(nn_input_affine_t* p, int channels, const float* gain,
+                               const float* offset, float lo, float hi, nn_qparam_t out_q);
+
+// Kernels. Sequences are row-major [time][channels].
+void nn_conv1d_s8(const nn_conv1d_params_t* p, const int8_t* in, int len, int8_t* out);
+// One output position from kernel input rows; NULL taps are padding
+void nn_conv1d_step_s8(const nn_conv1d_params_t* p, const int8_t* const* taps, int8_t* out);
+// Same, stopping at the int32 accumulators (bias included)
+void nn_conv1d_acc_s8(const nn_conv1d_params_t* p, const int8_t* const* taps, int32_t* acc);
+// Fused Conv1D + ReLU + folded BN + MaxPool1D: writes only the len / pool
+// pooled rows, conv activations are never stored
+void nn_conv_bn_relu_pool_s8(const nn_conv1d_params_t* conv, const nn_bn_fold_t* fold,
+                             const int8_t* in, int len, int8_t* out);
+// Same, for pooled rows [first, first + count) only; they land at their own
+// positions in out, and in must hold every input row they read
+void nn_conv_bn_relu_pool_rows_s8(const nn_conv1d_params_t* conv, const nn_bn_fold_t* fold,
+                                  const int8_t* in, int len, int first, int count, int8_t* out);
+// Conv requantization, ReLU and BN of one row of pooled accumulators
+void nn_bn_fold_apply_s8(const nn_bn_fold_t* fold, const int32_t* acc, int8_t* out);
+void nn_fc_s8(const nn_fc_params_t* p, const int8_t* in, int8_t* out);
+// FC over `rows` input rows at once: in [rows][p->in] -> out [rows][p->out]
+void nn_gemm_s8(const nn_gemm_params_t* p, const int8_t* in, int rows, int8_t* out);
+void nn_maxpool1d_s8(const int8_t* in, int len, int channels, int pool, int8_t* out);
+// One sample of p->channels raw values
+void nn_input_affine_s16(const nn_input_affine_t* p, const int16_t* raw, int8_t* out);
+
+// Element-wise ops; b is broadcast with period b_len (b_len == n for plain vectors)
+void nn_add_s8(const nn_add_params_t* p, const int8_t* a, const int8_t* b, int b_len,
+               int n, int8_t* out);
+void nn_mul_s8(const nn_mul_params_t* p, const int8_t* a, const int8_t* b, int b_len,
+               int n, int8_t* out);
+
+void nn_activation_s8(const nn_act_params_t* p, const int8_t* in, int n, int8_t* out);
+// in Q3.12, out Q0.15
+void nn_activation_s16(nn_act_fn_t fn, const int16_t* in, int n, int16_t* out);
+void nn_softmax_s8(const nn_softmax_params_t* p, const int8_t* in, int n, int8_t* out);
+void nn_sum_rows_s8(nn_qparam_t in_q, nn_qparam_t out_q, const int8_t* in, int rows,
+                    int cols, int8_t* out);
+void nn_requant_s8(nn_qparam_t in_q, nn_qparam_t out_q, const int8_t* in, int n, int8_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NN_KERNELS_H
@@ -0,0 +1,64 @@
+#ifndef NN_LUT_H
+#define NN_LUT_H
+
+#include "port.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Table-driven sigmoid, tanh and exp for the int8/int16 kernels.
+// The tables are computed at compile time (constexpr, nn_lut.cpp) and live
+// in flash; lookups interpolate linearly between entries, so no libm call
+// is made at run time.
+//
+//   sigmoid, tanh: input Q3.12 (saturates outside [-8, 8)), output Q0.15
+//   exp:           input Q4.11, x <= 0 (exp(x) for x < -16 is 0), output Q0.15
+//
+// Outputs of 1.0 saturate to 32767.
+
+#define NN_LUT_ENTRIES          513     // 512 segments plus the end point
+#define NN_LUT_SEGMENT_BITS     9
+#define NN_LUT_INPUT_FRAC_BITS  12      // sigmoid / tanh input
+#define NN_LUT_EXP_FRAC_BITS    11      // exp input
+#define NN_LUT_OUTPUT_FRAC_BITS 15
+
+typedef struct {
+    int16_t v[NN_LUT_ENTRIES];
+} nn_lut_table_t;
+
+extern const nn_lut_table_t nn_lut_sigmoid;    // x in [-8, 8]
+extern const nn_lut_table_t nn_lut_tanh;       // x in [-8, 8]
+extern const nn_lut_table_t nn_lut_exp;        // x in [-16, 0]
+
+// index: 16-bit position in the table range, 7 fraction bits between entries
+static inline int16_t nn_lut_interp(const nn_lut_table_t* t, uint32_t index) {
+    const uint32_t frac_bits = 16 - NN_LUT_SEGMENT_BITS;
+    uint32_t i = index >> frac_bits;
+    int32_t frac = (int32_t)(index & ((1u << frac_bits) - 1));
+    int32_t a = t->v[i];
+    int32_t b = t->v[i + 1];
+    return (int16_t)(a + (((b - a) * frac + (1 << (frac_bits - 1))) >> frac_bits));
+}
+
+static inline int16_t nn_sigmoid_s16(int16_t x) {
+    return nn_lut_interp(&nn_lut_sigmoid, (uint32_t)((int32_t)x + 32768));
+}
+
+static inline int16_t nn_tanh_s16(int16_t x) {
+    return nn_lut_interp(&nn_lut_tanh, (uint32_t)((int32_t)x + 32768));
+}
+
+static inline int16_t nn_exp_s16(int16_t x) {
+    return x >= 0 ? INT16_MAX : nn_lut_interp(&nn_lut_exp, (uint32_t)((int32_t)x + 32768) << 1);
+}
+
+// Prints the error of every table function against libm over its whole
+// int16 input range, and per-element timings of table vs libm
+void nn_lut_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NN_LUT_H
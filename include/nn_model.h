@@ -0,0 +1,131 @@
+#ifndef NN_MODEL_H
+#define NN_MODEL_H
+
+#include "port.h"
+#include "nn_kernels.h"
+#include "tflite_model.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bound CNN-LSTM-Attention graph.
+// nn_model_load() walks the TFLite flatbuffer once, checks that it has the
+// Conv1D/BN/MaxPool x2 -> LSTM x2 -> Attention -> Dense x2 structure exported
+// by the training notebook and resolves every weight, bias and quantization
+// parameter into the structures below. Weight tensors are referenced in place.
+// The main-subgraph index of each layer's output tensor is kept as well, so
+// activations dumped from the TFLite interpreter can be lined up with the
+// engine's (host/golden_check).
+
+#define NN_CONV_BLOCKS  2
+#define NN_LSTM_LAYERS  2
+#define NN_DENSE_LAYERS 2
+#define NN_LSTM_MAX_UNITS 32
+#define NN_LSTM_MAX_INPUT 32
+
+typedef enum {
+    NN_GATE_INPUT = 0,
+    NN_GATE_FORGET,
+    NN_GATE_CELL,
+    NN_GATE_OUTPUT,
+    NN_GATES
+} nn_lstm_gate_t;
+
+// Conv1D (fused ReLU) -> BatchNorm (MUL, ADD) -> MaxPool1D
+typedef struct {
+    int in_len;
+    int out_len;
+    int pool;
+    nn_conv1d_params_t conv;
+    nn_qparam_t conv_q;
+    const int8_t* bn_scale;
+    nn_mul_params_t bn_mul;
+    nn_qparam_t bn_mul_q;
+    const int8_t* bn_offset;
+    nn_add_params_t bn_add;
+    nn_qparam_t out_q;
+    nn_bn_fold_t fold;                      // the block as one pass over pooled rows
+    bool foldable;                          // every BN scale >= 0
+    int32_t out_tensor;                     // MaxPool output in the flatbuffer
+} nn_conv_block_t;
+
+typedef struct {
+    int input_size;
+    int units;
+    int steps;
+    nn_qparam_t input_q;
+    nn_fc_params_t input_fc[NN_GATES];      // W_x * x_t + b
+    nn_fc_params_t recurrent_fc[NN_GATES];  // U * h_{t-1}
+    nn_gemm_params_t input_gemm;            // all four W_x * x_t + b, rows [i|f|g|o]
+    int8_t input_packed[NN_GATES * NN_LSTM_MAX_UNITS * NN_LSTM_MAX_INPUT];
+    nn_qparam_t input_fc_q[NN_GATES];
+    nn_qparam_t recurrent_fc_q[NN_GATES];
+    nn_add_params_t gate_add[NN_GATES];
+    nn_act_params_t gate_act[NN_GATES];
+    nn_mul_params_t forget_mul;             // f * c_{t-1}
+    nn_mul_params_t update_mul;             // i * g
+    nn_add_params_t cell_add;
+    nn_act_params_t cell_act;               // tanh(c_t)
+    nn_mul_params_t output_mul;             // o * tanh(c_t)
+    nn_qparam_t gate_q[NN_GATES];
+    nn_qparam_t forget_q;
+    nn_qparam_t update_q;
+    nn_qparam_t cell_q;                     // c_t as produced by cell_add
+    nn_qparam_t cell_state_q;               // c_{t-1} as consumed by forget_mul
+    nn_qparam_t cell_tanh_q;
+    nn_qparam_t hidden_q;
+    int32_t out_tensor;                     // int8 [steps][units] sequence after the WHILE loop, -1 if absent
+} nn_lstm_layer_t;
+
+// Online attention keeps exp(score - max) sums in int32 (Q0.15 times int8)
+#define NN_ATTENTION_MAX_STEPS 256
+
+// score_t = tanh(W * h_t + b_t), a = softmax(score), context = sum_t a_t * h_t
+typedef struct {
+    int steps;
+    int units;
+    nn_qparam_t input_q;
+    nn_fc_params_t score_fc;
+    nn_qparam_t score_fc_q;
+    const int8_t* bias;                     // one entry per time step
+    nn_add_params_t bias_add;
+    nn_act_params_t score_act;
+    nn_qparam_t score_q;
+    float softmax_beta;
+    nn_qparam_t weight_q;
+    nn_softmax_params_t softmax;
+    nn_mul_params_t weight_mul;
+    nn_qparam_t weighted_q;
+    nn_qparam_t out_q;
+    int32_t out_tensor;                     // context (SUM output) in the flatbuffer
+} nn_attention_layer_t;
+
+typedef struct {
+    tfl_model_t tfl;
+    int seq_len;
+    int features;
+    int classes;
+    nn_qparam_t input_q;
+    nn_qparam_t output_q;
+    nn_conv_block_t blocks[NN_CONV_BLOCKS];
+    nn_lstm_layer_t lstm[NN_LSTM_LAYERS];
+    nn_attention_layer_t attention;
+    nn_fc_params_t dense[NN_DENSE_LAYERS];
+    nn_qparam_t dense_q[NN_DENSE_LAYERS];
+    int32_t dense_tensor[NN_DENSE_LAYERS];
+    int32_t output_tensor;
+    float softmax_beta;
+    nn_softmax_params_t softmax;
+    bool fuse_conv_blocks;                  // run conv blocks fused; clear for the reference path
+    bool online_attention;                  // single-pass attention; off (as exported) by default
+} nn_model_t;
+
+esp_err_t nn_model_load(nn_model_t* model, const uint8_t* data, size_t size);
+void nn_model_print_summary(const nn_model_t* model);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NN_MODEL_H
@@ -0,0 +1,117 @@
+#ifndef NN_PIPELINE_H
+#define NN_PIPELINE_H
+
+#include "port.h"
+#include "nn_engine.h"
+#include "spsc_ring.h"
+
+#include <stdatomic.h>
+
+// Two-stage pipelined executor for a bound nn_model_t, one stage per core.
+// The front stage runs the fused conv blocks and publishes the pooled rows of
+// the last block in chunks through a lock-free SPSC ring (spsc_ring.h). The
+// back stage starts on the first chunk: it projects the chunk into the first
+// LSTM, advances the whole LSTM stack one time step per row and feeds the top
+// layer straight into the online attention (or keeps its rows for the
+// two-pass attention), then runs the head once the last chunk is in. Each kernel sees exactly the rows and state it sees in
+// nn_engine_invoke(), so outputs are bit-identical.
+//
+//   back  (inference task)      nn_pipeline_begin() -> nn_pipeline_finish()
+//   front (worker on the other core, woken by the notify hook)
+//                               while (nn_pipeline_front_step()) {}
+//
+// Without a front worker nn_pipeline_finish() runs the front stage inline.
+// One window is in flight at a time; the feature rows are owned by the
+// front stage until their chunk is published.
+
+#define NN_PIPELINE_CHUNK_ROWS 5        // pooled rows per chunk (minimum)
+#define NN_PIPELINE_QUEUE_DEPTH 16      // chunks; a whole window always fits
+#define NN_PIPELINE_TIMEOUT_US 1000000  // back stage gives up on a stalled front worker
+
+// Published by the front stage: rows [first_row, first_row + rows) of the
+// last conv block are final
+typedef struct {
+    uint32_t window;
+    uint16_t first_row;
+    uint16_t rows;
+} nn_pipeline_chunk_t;
+
+typedef struct {
+    uint64_t busy_us;           // computing
+    uint64_t wait_us;           // back stage: blocked on an empty queue
+    uint32_t chunks;
+    uint32_t windows;
+} nn_pipeline_stage_stats_t;
+
+typedef struct {
+    nn_pipeline_stage_stats_t front;    // written by the front stage only
+    nn_pipeline_stage_stats_t back;     // written by the back stage only
+    uint64_t window_us;         // nn_pipeline_begin() to the end of nn_pipeline_finish(), summed
+    int64_t started_us;         // first nn_pipeline_begin()
+} nn_pipeline_stats_t;
+
+typedef void (*nn_pipeline_notify_fn_t)(void* ctx);
+
+typedef struct {
+    const nn_model_t* model;
+    uint8_t* arena;
+    size_t arena_size;
+    int chunk_rows;
+    int steps;                          // pooled rows of the last conv block = LSTM steps
+
+    // Front stage
+    const int8_t* input;
+    int8_t* block_out[NN_CONV_BLOCKS];  // pooled rows of every block, whole window
+    int block_rows[NN_CONV_BLOCKS];     // rows of the current window computed so far
+    uint32_t front_window;
+    _Atomic uint32_t front_done;        // last window whose chunks are all published
+
+    // Back stage
+    int8_t* xproj;                      // first LSTM input projections of one chunk
+    int8_t* proj;                       // input projection of one row, upper layers
+    int8_t* lstm_h[NN_LSTM_LAYERS];
+    int8_t* lstm_cell[NN_LSTM_LAYERS];
+    int8_t* lstm_scratch;
+    int8_t* top_seq;                    // top LSTM rows, two-pass attention only
+    nn_attention_state_t attention;
+    nn_head_buffers_t head;
+    int back_rows;                      // rows consumed in the current window
+    int64_t window_start_us;
+
+    // Front -> back
+    _Atomic uint32_t submitted;         // window sequence, written by nn_pipeline_begin()
+    spsc_ring_t queue;
+    nn_pipeline_chunk_t queue_storage[NN_PIPELINE_QUEUE_DEPTH];
+
+    nn_pipeline_notify_fn_t front_notify;
+    void* front_ctx;
+
+    nn_pipeline_stats_t stats;
+} nn_pipeline_t;
+
+// Fused conv blocks are required
+bool nn_pipeline_supported(const nn_model_t* model);
+size_t nn_pipeline_arena_size(const nn_model_t* model);
+esp_err_t nn_pipeline_init(nn_pipeline_t* pipeline, const nn_model_t* model, uint8_t* arena, size_t arena_size);
+
+// notify is called by nn_pipeline_begin() to wake the front worker; NULL
+// makes nn_pipeline_finish() run the front stage on the calling task
+void nn_pipeline_set_front_worker(nn_pipeline_t* pipeline, nn_pipeline_notify_fn_t notify, void* ctx);
+
+// Back stage. input ([seq_len][features], model->input_q) must stay valid
+// until nn_pipeline_finish() returns.
+esp_err_t nn_pipeline_begin(nn_pipeline_t* pipeline, const int8_t* input);
+// output: [classes] int8 quantized with model->output_q
+esp_err_t nn_pipeline_finish(nn_pipeline_t* pipeline, int8_t* output);
+
+// Front stage: convolves and publishes one chunk of the submitted window.
+// False when there is nothing left to do.
+bool nn_pipeline_front_step(nn_pipeline_t* pipeline);
+
+// nn_pipeline_begin() + nn_pipeline_finish()
+esp_err_t nn_pipeline_invoke(nn_pipeline_t* pipeline, const int8_t* input, int8_t* output);
+
+void nn_pipeline_reset_stats(nn_pipeline_t* pipeline);
+void nn_pipeline_print_stats(const nn_pipeline_t* pipeline);
+
+#endif // NN_PIPELINE_H
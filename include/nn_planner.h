@@ -0,0 +1,44 @@
+#ifndef NN_PLANNER_H
+#define NN_PLANNER_H
+
+#include "port.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Lifetime-based tensor arena planner.
+// Each buffer is live from the step that produces it (first) to the last step
+// that reads it (last), inclusive. Buffers are placed largest first at the
+// lowest offset that does not overlap any already placed buffer with an
+// intersecting lifetime. A buffer may name an `inplace` predecessor whose
+// storage it overwrites (element-wise or down-sampling ops); both then share
+// one slot covering the union of their lifetimes.
+
+#define NN_PLAN_MAX_BUFFERS 32
+#define NN_PLAN_NONE        (-1)
+
+typedef struct {
+    const char* name;
+    size_t size;
+    int first;
+    int last;
+    int inplace;        // index of the buffer this one overwrites, or NN_PLAN_NONE
+    size_t offset;      // filled in by nn_plan_arena()
+} nn_plan_buffer_t;
+
+typedef struct {
+    size_t arena_size;  // bytes needed by the plan
+    size_t peak_live;   // largest sum of simultaneously live buffers (lower bound)
+    size_t naive_size;  // bytes needed without any reuse
+    int buffers;
+} nn_plan_report_t;
+
+esp_err_t nn_plan_arena(nn_plan_buffer_t* buffers, int count, size_t alignment, nn_plan_report_t* report);
+void nn_plan_print(const nn_plan_buffer_t* buffers, int count, const nn_plan_report_t* report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NN_PLANNER_H
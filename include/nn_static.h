@@ -0,0 +1,54 @@
+#ifndef NN_STATIC_H
+#define NN_STATIC_H
+
+#include "port.h"
+#include "nn_model.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Shape-specialized executor for the model the firmware was generated from.
+// host/model_codegen reads the model shapes and writes src/nn_static_model.h,
+// which instantiates the templates of nn_static.hpp; this is the C side of
+// that instantiation. Any model with the same shapes can be bound (weights are
+// read from the nn_model_t as usual); other models stay on nn_engine.
+
+// Derived from the bound model by nn_static_init(). Input offsets are folded
+// into the biases: bias + input_offset * sum of the row's weights.
+typedef struct {
+    int32_t conv_bias[NN_CONV_BLOCKS][NN_MAX_CHANNELS];
+    int32_t recurrent_bias[NN_LSTM_LAYERS][NN_GATES * NN_LSTM_MAX_UNITS];
+    int32_t score_bias;
+    int32_t dense_bias[NN_DENSE_LAYERS][NN_MAX_CHANNELS];
+    int8_t cell_requant[NN_LSTM_LAYERS][256];   // c_t -> c_{t-1}, by c_t - INT8_MIN
+} nn_static_tables_t;
+
+typedef struct {
+    const nn_model_t* model;
+    uint8_t* arena;             // activations only
+    size_t arena_size;
+    nn_static_tables_t tables;
+} nn_static_engine_t;
+
+// Shapes of the generated graph, e.g. "301x6 k3/3 16/32 lstm 32/16 att 75 dense 32 -> 5"
+const char* nn_static_shape(void);
+
+// True when the bound model has exactly the generated shapes and runs with
+// fused conv blocks; attention follows model->online_attention
+bool nn_static_matches(const nn_model_t* model);
+
+// Constant, planned at compile time
+size_t nn_static_arena_size(void);
+
+// ESP_ERR_NOT_SUPPORTED when !nn_static_matches(model)
+esp_err_t nn_static_init(nn_static_engine_t* engine, const nn_model_t* model, uint8_t* arena, size_t arena_size);
+
+// Same tensors and quantization as nn_engine_invoke(), bit-identical output
+esp_err_t nn_static_invoke(nn_static_engine_t* engine, const int8_t* input, int8_t* output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NN_STATIC_H
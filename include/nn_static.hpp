@@ -0,0 +1,574 @@
+#ifndef NN_STATIC_HPP
+#define NN_STATIC_HPP
+
+#include <math.h>
+#include <string.h>
+#include <type_traits>
+
+#include "nn_engine.h"
+#include "nn_static.h"
+
+// Shape-specialized int8 kernels for the CNN-LSTM-Attention graph.
+// Every dimension is a template parameter: loops have constant trip counts
+// the compiler can unroll, SAME padding is resolved at compile time for all
+// but the edge rows, and the arena layout is a set of constants checked by
+// static_assert. Weights and quantization parameters stay in the bound
+// nn_model_t; bind() derives a few tables from them (nn_static_tables_t).
+// Every result is the interpreter's (nn_kernels.c, nn_engine.c) integer for
+// integer, so outputs are bit-identical: input offsets are folded into the
+// biases, which is exact in int32.
+//
+// A model instantiates Graph<> from a header generated by host/model_codegen
+// (src/nn_static_model.h); nn_static.h is the C interface.
+
+namespace nn_static {
+
+constexpr size_t align_up(size_t v) {
+    return (v + NN_ARENA_ALIGNMENT - 1) & ~(size_t)(NN_ARENA_ALIGNMENT - 1);
+}
+
+constexpr int max_of(int a, int b) {
+    return a > b ? a : b;
+}
+
+// Fixed point arithmetic as in nn_kernels.c, inlined into the kernels
+
+inline int32_t requantize(int32_t acc, nn_requant_t rq) {
+    int left = rq.shift > 0 ? rq.shift : 0;
+    int right = rq.shift > 0 ? 0 : -rq.shift;
+
+    int32_t a = acc * (1 << left);
+    int32_t high;
+    if (a == INT32_MIN && rq.multiplier == INT32_MIN) {
+        high = INT32_MAX;
+    } else {
+        int64_t ab = (int64_t)a * (int64_t)rq.multiplier;
+        int32_t nudge = ab >= 0 ? (1 << 30) : (1 - (1 << 30));
+        high = (int32_t)((ab + nudge) / (1LL << 31));
+    }
+
+    int32_t mask = (int32_t)((1LL << right) - 1);
+    int32_t remainder = high & mask;
+    int32_t threshold = (mask >> 1) + (high < 0 ? 1 : 0);
+    return (high >> right) + (remainder > threshold ? 1 : 0);
+}
+
+inline int8_t add(const nn_add_params_t& p, int8_t a, int8_t b) {
+    int32_t x1 = ((int32_t)a + p.input1_offset) * (1 << p.left_shift);
+    int32_t x2 = ((int32_t)b + p.input2_offset) * (1 << p.left_shift);
+    int32_t sum = requantize(x1, p.input1_rq) + requantize(x2, p.input2_rq);
+    return nn_clamp_s8(requantize(sum, p.output_rq) + p.output_offset, INT8_MIN, INT8_MAX);
+}
+
+inline int8_t mul(const nn_mul_params_t& p, int8_t a, int8_t b) {
+    int32_t prod = ((int32_t)a + p.input1_offset) * ((int32_t)b + p.input2_offset);
+    return nn_clamp_s8(requantize(prod, p.rq) + p.output_offset, INT8_MIN, INT8_MAX);
+}
+
+inline int8_t lookup(const int8_t* lut, int8_t x) {
+    return lut[(int32_t)x - INT8_MIN];
+}
+
+// Bias of fully connected row o with the input offset folded in
+template <int In>
+inline int32_t folded_bias(const nn_fc_params_t& p, int o) {
+    const int8_t* w = p.weights + (size_t)o * In;
+    int32_t sum = 0;
+    for (int i = 0; i < In; i++) {
+        sum += w[i];
+    }
+    return (p.has_bias ? p.bias[o] : 0) + p.input_offset * sum;
+}
+
+// One fully connected output row over In inputs
+template <int In>
+inline int8_t fc_row(const nn_fc_params_t& p, int32_t bias, const int8_t* in, int o) {
+    const int8_t* w = p.weights + (size_t)o * In;
+    int32_t acc = bias;
+    for (int i = 0; i < In; i++) {
+        acc += in[i] * (int32_t)w[i];
+    }
+    return nn_clamp_s8(requantize(acc, p.rq) + p.output_offset, p.act_min, p.act_max);
+}
+
+// Conv1D, SAME padding, stride 1; weights [Cout][K][Cin]
+template <typename T, int K, int Cin, int Cout>
+struct Conv1D {
+    static_assert(std::is_same<T, int8_t>::value, "only int8 kernels are implemented");
+    static_assert(K % 2 == 1 && K <= NN_MAX_KERNEL, "odd kernel up to NN_MAX_KERNEL");
+    static_assert(Cin <= NN_MAX_CHANNELS && Cout <= NN_MAX_CHANNELS, "channels up to NN_MAX_CHANNELS");
+
+    static constexpr int kernel = K;
+    static constexpr int cin = Cin;
+    static constexpr int cout = Cout;
+    static constexpr int pad = (K - 1) / 2;
+
+    static bool matches(const nn_conv1d_params_t& p) {
+        return p.kernel == K && p.cin == Cin && p.cout == Cout;
+    }
+
+    static void bind(const nn_conv1d_params_t& p, int32_t* bias) {
+        for (int oc = 0; oc < Cout; oc++) {
+            const int8_t* w = p.weights + (size_t)oc * K * Cin;
+            int32_t sum = 0;
+            for (int i = 0; i < K * Cin; i++) {
+                sum += w[i];
+            }
+            bias[oc] = p.bias[oc] + p.input_offset * sum;
+        }
+    }
+
+    // Accumulators at position pos with every tap inside the input; bias
+    // from bind()
+    static inline void acc(const nn_conv1d_params_t& p, const int32_t* bias, const T* in, int pos,
+                           int32_t* out) {
+        const T* x = in + (size_t)(pos - pad) * Cin;
+        for (int oc = 0; oc < Cout; oc++) {
+            const int8_t* w = p.weights + (size_t)oc * K * Cin;
+            int32_t a = bias[oc];
+            for (int i = 0; i < K * Cin; i++) {
+                a += x[i] * (int32_t)w[i];
+            }
+            out[oc] = a;
+        }
+    }
+
+    // Same for an edge position: padded taps are skipped, so the offset
+    // stays in the inner loop
+    static void acc_edge(const nn_conv1d_params_t& p, const T* in, int len, int pos, int32_t* out) {
+        int first = pos < pad ? pad - pos : 0;
+        int last = pos + pad >= len ? len - pos + pad : K;
+        const T* x = in + (size_t)(pos - pad + first) * Cin;
+        for (int oc = 0; oc < Cout; oc++) {
+            const int8_t* w = p.weights + ((size_t)oc * K + first) * Cin;
+            int32_t a = p.bias[oc];
+            for (int i = 0; i < (last - first) * Cin; i++) {
+                a += ((int32_t)x[i] + p.input_offset) * (int32_t)w[i];
+            }
+            out[oc] = a;
+        }
+    }
+};
+
+// Conv1D + ReLU + folded BatchNorm + MaxPool1D over Len input rows, writing
+// only the pooled rows (nn_conv_bn_relu_pool_s8)
+template <class Conv, int Len, int Pool>
+struct ConvBlock {
+    using T = int8_t;
+
+    static constexpr int in_len = Len;
+    static constexpr int pool = Pool;
+    static constexpr int out_len = Len / Pool;
+    static constexpr int cin = Conv::cin;
+    static constexpr int cout = Conv::cout;
+    static constexpr size_t out_bytes = (size_t)out_len * cout;
+
+    static_assert(Pool > 0 && out_len > 0 && Len >= Conv::kernel, "window shorter than the block");
+
+    // Pooled rows [0, head) and [tail, out_len) read padding
+    static constexpr int head = (Conv::pad + Pool - 1) / Pool;
+    static constexpr int tail = (Len - Conv::pad - Pool) / Pool + 1;
+    static_assert(head <= tail && tail <= out_len, "padding covers the whole block");
+
+    static bool matches(const nn_conv_block_t& b) {
+        return Conv::matches(b.conv) && b.in_len == Len && b.pool == Pool && b.out_len == out_len &&
+               b.fold.pool == Pool && b.fold.channels == cout;
+    }
+
+    static inline void apply_fold(const nn_bn_fold_t& fold, const int32_t* acc, T* out) {
+        const nn_mul_params_t& m = fold.mul;
+        const nn_add_params_t& a = fold.add;
+        for (int c = 0; c < cout; c++) {
+            int32_t x = nn_clamp_s8(requantize(acc[c], fold.conv_rq[c]) + fold.conv_offset, fold.act_min,
+                                    fold.act_max);
+            int32_t y = nn_clamp_s8(requantize((x + m.input1_offset) * fold.scale[c], m.rq) + m.output_offset,
+                                    INT8_MIN, INT8_MAX);
+            int32_t x1 = requantize((y + a.input1_offset) * (1 << a.left_shift), a.input1_rq);
+            out[c] = nn_clamp_s8(requantize(x1 + fold.offset[c], a.output_rq) + a.output_offset, INT8_MIN,
+                                 INT8_MAX);
+        }
+    }
+
+    template <bool Edge>
+    static inline void row(const nn_conv_block_t& b, const int32_t* bias, const T* in, int t, T* out) {
+        int32_t best[cout];
+        int32_t acc[cout];
+        for (int p = 0; p < Pool; p++) {
+            int32_t* dst = p == 0 ? best : acc;
+            if (Edge) {
+                Conv::acc_edge(b.conv, in, Len, t * Pool + p, dst);
+            } else {
+                Conv::acc(b.conv, bias, in, t * Pool + p, dst);
+            }
+            for (int c = 0; p > 0 && c < cout; c++) {
+                best[c] = acc[c] > best[c] ? acc[c] : best[c];
+            }
+        }
+        apply_fold(b.fold, best, out + (size_t)t * cout);
+    }
+
+    static void bind(const nn_conv_block_t& b, int32_t* bias) {
+        Conv::bind(b.conv, bias);
+    }
+
+    static void run(const nn_conv_block_t& b, const int32_t* bias, const T* in, T* out) {
+        for (int t = 0; t < head; t++) {
+            row<true>(b, bias, in, t, out);
+        }
+        for (int t = head; t < tail; t++) {
+            row<false>(b, bias, in, t, out);
+        }
+        for (int t = tail; t < out_len; t++) {
+            row<true>(b, bias, in, t, out);
+        }
+    }
+};
+
+// LSTM layer with the input projection hoisted out of the recurrence
+// (NN_LSTM_HOIST_INPUT). bind() folds the recurrent input offset into the
+// biases and turns the c_t -> c_{t-1} requantization into a 256-entry table.
+template <typename T, int In, int Units>
+struct Lstm {
+    static_assert(std::is_same<T, int8_t>::value, "only int8 kernels are implemented");
+    static_assert(In <= NN_LSTM_MAX_INPUT && Units <= NN_LSTM_MAX_UNITS, "LSTM wider than nn_model_t holds");
+
+    static constexpr int in = In;
+    static constexpr int units = Units;
+    static constexpr int proj = NN_GATES * Units;
+
+    static bool matches(const nn_lstm_layer_t& l, int steps) {
+        bool ok = l.input_size == In && l.units == Units && l.steps == steps &&
+                  l.input_gemm.in == In && l.input_gemm.out == proj && l.input_gemm.segment_rows == Units;
+        for (int g = 0; g < NN_GATES; g++) {
+            ok = ok && l.recurrent_fc[g].in == Units && l.recurrent_fc[g].out == Units;
+        }
+        return ok;
+    }
+
+    static void bind(const nn_lstm_layer_t& l, int32_t* recurrent_bias, int8_t* cell_lut) {
+        for (int g = 0; g < NN_GATES; g++) {
+            for (int o = 0; o < Units; o++) {
+                recurrent_bias[g * Units + o] = folded_bias<Units>(l.recurrent_fc[g], o);
+            }
+        }
+        for (int q = INT8_MIN; q <= INT8_MAX; q++) {
+            int8_t x = (int8_t)q;
+            nn_requant_s8(l.cell_q, l.cell_state_q, &x, 1, &cell_lut[q - INT8_MIN]);
+        }
+    }
+
+    // W_x * x_t + b for Rows consecutive steps, each weight row loaded once
+    template <int Rows>
+    static inline void project_rows(const nn_gemm_params_t& g, const T* x, T* y) {
+        for (int o = 0; o < proj; o++) {
+            const int8_t* w = g.weights + (size_t)o * In;
+            int32_t acc[Rows];
+            for (int r = 0; r < Rows; r++) {
+                acc[r] = g.bias[o];
+            }
+            for (int i = 0; i < In; i++) {
+                int32_t wi = w[i];
+                for (int r = 0; r < Rows; r++) {
+                    acc[r] += x[r * In + i] * wi;
+                }
+            }
+            int seg = o / Units;
+            for (int r = 0; r < Rows; r++) {
+                y[r * proj + o] = nn_clamp_s8(requantize(acc[r], g.rq[seg]) + g.output_offset[seg],
+                                              g.act_min, g.act_max);
+            }
+        }
+    }
+
+    // [Steps][In] -> [Steps][proj]
+    template <int Steps>
+    static void project(const nn_gemm_params_t& g, const T* x, T* out) {
+        constexpr int block = 4;
+        int t = 0;
+        for (; t + block <= Steps; t += block) {
+            project_rows<block>(g, x + (size_t)t * In, out + (size_t)t * proj);
+        }
+        for (; t < Steps; t++) {
+            project_rows<1>(g, x + (size_t)t * In, out + (size_t)t * proj);
+        }
+    }
+
+    // One time step; h_prev is fully read before h_out is written, so they may alias
+    static inline void step(const nn_lstm_layer_t& l, const int32_t* recurrent_bias, const int8_t* cell_lut,
+                            const T* px, const T* h_prev, T* cell, T* h_out) {
+        T gate[NN_GATES][Units];
+        for (int g = 0; g < NN_GATES; g++) {
+            for (int o = 0; o < Units; o++) {
+                T ph = fc_row<Units>(l.recurrent_fc[g], recurrent_bias[g * Units + o], h_prev, o);
+                gate[g][o] = lookup(l.gate_act[g].lut, add(l.gate_add[g], px[g * Units + o], ph));
+            }
+        }
+        for (int o = 0; o < Units; o++) {
+            T forget = mul(l.forget_mul, gate[NN_GATE_FORGET][o], cell[o]);
+            T update = mul(l.update_mul, gate[NN_GATE_INPUT][o], gate[NN_GATE_CELL][o]);
+            T c = add(l.cell_add, forget, update);
+            h_out[o] = mul(l.output_mul, gate[NN_GATE_OUTPUT][o], lookup(l.cell_act.lut, c));
+            cell[o] = lookup(cell_lut, c);
+        }
+    }
+
+    // Runs the sequence into h_seq, which holds Rows rows used round robin;
+    // sink(t, h_t) sees every output row
+    template <int Steps, int Rows, class Sink>
+    static void run(const nn_lstm_layer_t& l, const int32_t* recurrent_bias, const int8_t* cell_lut,
+                    const T* x, T* xproj, T* cell, T* h0, T* h_seq, Sink&& sink) {
+        static_assert(Rows == Steps || Rows == 2, "full sequence or h_{t-1} and h_t");
+        memset(h0, (int8_t)l.hidden_q.zero_point, Units);
+        memset(cell, (int8_t)l.cell_state_q.zero_point, Units);
+
+        project<Steps>(l.input_gemm, x, xproj);
+        for (int t = 0; t < Steps; t++) {
+            const T* h_prev = t > 0 ? h_seq + (size_t)((t - 1) % Rows) * Units : h0;
+            T* h = h_seq + (size_t)(t % Rows) * Units;
+            step(l, recurrent_bias, cell_lut, xproj + (size_t)t * proj, h_prev, cell, h);
+            sink(t, h);
+        }
+    }
+};
+
+template <int N>
+inline void softmax(const nn_softmax_params_t& p, const int8_t* in, int8_t* out) {
+    int8_t max_val = in[0];
+    for (int i = 1; i < N; i++) {
+        max_val = in[i] > max_val ? in[i] : max_val;
+    }
+    int32_t sum = 0;
+    for (int i = 0; i < N; i++) {
+        sum += p.exp_lut[max_val - in[i]];
+    }
+    float inv_sum = 1.0f / ((float)sum * p.out_q.scale);
+    for (int i = 0; i < N; i++) {
+        int32_t v = (int32_t)((float)p.exp_lut[max_val - in[i]] * inv_sum + 0.5f) + p.out_q.zero_point;
+        out[i] = nn_clamp_s8(v, INT8_MIN, INT8_MAX);
+    }
+}
+
+// Temporal attention, either single pass (nn_attention_push/finish) or
+// two-pass as exported (run_attention in nn_engine.c)
+template <typename T, int Steps, int Units>
+struct Attention {
+    static_assert(std::is_same<T, int8_t>::value, "only int8 kernels are implemented");
+    static_assert(Steps <= NN_ATTENTION_MAX_STEPS && Units <= NN_MAX_CHANNELS, "attention too large");
+
+    static constexpr int steps = Steps;
+    static constexpr int units = Units;
+
+    struct State {
+        int8_t max_score;
+        int32_t sum;
+        int32_t acc[Units];
+    };
+
+    static bool matches(const nn_attention_layer_t& a) {
+        return a.steps == Steps && a.units == Units && a.score_fc.in == Units && a.score_fc.out == 1;
+    }
+
+    static int32_t bind(const nn_attention_layer_t& a) {
+        return folded_bias<Units>(a.score_fc, 0);
+    }
+
+    static void begin(State& s) {
+        memset(&s, 0, sizeof(s));
+        s.max_score = INT8_MIN;
+    }
+
+    static inline int32_t scale_q15(int32_t v, int32_t factor) {
+        return (int32_t)(((int64_t)v * factor + (1 << 14)) >> 15);
+    }
+
+    static inline T score(const nn_attention_layer_t& a, int32_t score_bias, int t, const T* h) {
+        T score = fc_row<Units>(a.score_fc, score_bias, h, 0);
+        return lookup(a.score_act.lut, add(a.bias_add, score, a.bias[t]));
+    }
+
+    static inline void push(const nn_attention_layer_t& a, int32_t score_bias, State& s, int t, const T* h) {
+        T score = Attention::score(a, score_bias, t, h);
+
+        if (score > s.max_score) {
+            int32_t factor = a.softmax.exp_lut[score - s.max_score];
+            s.sum = scale_q15(s.sum, factor);
+            for (int i = 0; i < Units; i++) {
+                s.acc[i] = scale_q15(s.acc[i], factor);
+            }
+            s.max_score = score;
+        }
+
+        int32_t e = a.softmax.exp_lut[s.max_score - score];
+        s.sum += e;
+        for (int i = 0; i < Units; i++) {
+            s.acc[i] += e * ((int32_t)h[i] - a.input_q.zero_point);
+        }
+    }
+
+    static void finish(const nn_attention_layer_t& a, const State& s, T* context) {
+        float scale = s.sum > 0 ? a.input_q.scale / (a.out_q.scale * (float)s.sum) : 0.0f;
+        for (int i = 0; i < Units; i++) {
+            int32_t v = (int32_t)roundf((float)s.acc[i] * scale) + a.out_q.zero_point;
+            context[i] = nn_clamp_s8(v, INT8_MIN, INT8_MAX);
+        }
+    }
+
+    // Quantized softmax weights, then the weighted rows summed per unit
+    // without storing them; scratch holds 2 * Steps bytes
+    static void run(const nn_attention_layer_t& a, int32_t score_bias, const T* seq, T* scratch, T* context) {
+        T* scores = scratch;
+        T* weights = scratch + Steps;
+        for (int t = 0; t < Steps; t++) {
+            scores[t] = score(a, score_bias, t, seq + (size_t)t * Units);
+        }
+        softmax<Steps>(a.softmax, scores, weights);
+
+        float scale = a.weighted_q.scale / a.out_q.scale;
+        float bias = -(float)a.weighted_q.zero_point * scale * (float)Steps;
+        for (int i = 0; i < Units; i++) {
+            int32_t sum = 0;
+            for (int t = 0; t < Steps; t++) {
+                sum += mul(a.weight_mul, seq[(size_t)t * Units + i], weights[t]);
+            }
+            int32_t v = (int32_t)roundf((float)sum * scale + bias) + a.out_q.zero_point;
+            context[i] = nn_clamp_s8(v, INT8_MIN, INT8_MAX);
+        }
+    }
+};
+
+template <int In, int Out>
+struct Dense {
+    static_assert(In <= NN_MAX_CHANNELS && Out <= NN_MAX_CHANNELS, "dense wider than NN_MAX_CHANNELS");
+
+    static constexpr int in = In;
+    static constexpr int out = Out;
+
+    static bool matches(const nn_fc_params_t& p) {
+        return p.in == In && p.out == Out;
+    }
+
+    static void bind(const nn_fc_params_t& p, int32_t* bias) {
+        for (int o = 0; o < Out; o++) {
+            bias[o] = folded_bias<In>(p, o);
+        }
+    }
+
+    static inline void run(const nn_fc_params_t& p, const int32_t* bias, const int8_t* x, int8_t* y) {
+        for (int o = 0; o < Out; o++) {
+            y[o] = fc_row<In>(p, bias[o], x, o);
+        }
+    }
+};
+
+// The whole graph: two conv blocks, two LSTM layers, attention and two
+// Dense layers. ArenaLimit is the interpreter's planned arena for the same
+// model; the static plan must not need more.
+//
+// Arena, with the lifetimes of nn_engine_invoke():
+//   x        block 0 out, then the hoisted projections of the running LSTM
+//            (block 0 out is dead once block 1 has run), then the scores
+//            and weights of the two-pass attention
+//   seq      block 1 out, then LSTM 0 out in place (every row is projected
+//            before the recurrence writes the first h_t), then LSTM 1 out
+//            in place for the two-pass attention
+//   rows     h_{t-1} and h_t of LSTM 1, consumed by the online attention
+//   cell, h0, context, hidden, logits
+template <class Block0, class Block1, class Lstm0, class Lstm1, class Att, class Dense0, class Dense1,
+          size_t ArenaLimit>
+struct Graph {
+    using T = int8_t;
+
+    static constexpr int seq_len = Block0::in_len;
+    static constexpr int features = Block0::cin;
+    static constexpr int steps = Block1::out_len;
+    static constexpr int classes = Dense1::out;
+
+    static_assert(Block1::in_len == Block0::out_len && Block1::cin == Block0::cout, "conv block chain");
+    static_assert(Lstm0::in == Block1::cout && Lstm1::in == Lstm0::units, "LSTM input widths");
+    static_assert(Att::steps == steps && Att::units == Lstm1::units, "attention over the last LSTM");
+    static_assert(Dense0::in == Att::units && Dense1::in == Dense0::out, "dense chain");
+    static_assert(classes <= NN_MAX_CHANNELS, "too many classes");
+
+    static constexpr int max_units = max_of(Lstm0::units, Lstm1::units);
+    static constexpr size_t x_bytes = (size_t)max_of((int)Block0::out_bytes, steps * NN_GATES * max_units);
+    static constexpr size_t seq_bytes =
+        (size_t)max_of((int)Block1::out_bytes, steps * max_of(Lstm0::units, Lstm1::units));
+    static constexpr size_t rows_bytes = (size_t)2 * Lstm1::units;
+
+    static constexpr size_t x_offset = 0;
+    static constexpr size_t seq_offset = x_offset + align_up(x_bytes);
+    static constexpr size_t rows_offset = seq_offset + align_up(seq_bytes);
+    static constexpr size_t cell_offset = rows_offset + align_up(rows_bytes);
+    static constexpr size_t h0_offset = cell_offset + align_up(max_units);
+    static constexpr size_t context_offset = h0_offset + align_up(max_units);
+    static constexpr size_t hidden_offset = context_offset + align_up(Att::units);
+    static constexpr size_t logits_offset = hidden_offset + align_up(Dense0::out);
+    static constexpr size_t arena_size = logits_offset + align_up(Dense1::out);
+
+    static_assert(Block0::out_bytes <= x_bytes && (size_t)steps * Lstm0::proj <= x_bytes &&
+                  (size_t)steps * Lstm1::proj <= x_bytes, "x region too small");
+    static_assert(Block1::out_bytes <= seq_bytes && (size_t)steps * max_units <= seq_bytes,
+                  "seq region too small");
+    static_assert((size_t)2 * steps <= x_bytes, "no room for the attention scores and weights");
+    static_assert(arena_size <= ArenaLimit, "static plan needs more arena than the interpreter");
+
+    static bool matches(const nn_model_t& m) {
+        return m.seq_len == seq_len && m.features == features && m.classes == classes &&
+               m.fuse_conv_blocks &&
+               Block0::matches(m.blocks[0]) && Block1::matches(m.blocks[1]) &&
+               Lstm0::matches(m.lstm[0], steps) && Lstm1::matches(m.lstm[1], steps) &&
+               Att::matches(m.attention) && Dense0::matches(m.dense[0]) && Dense1::matches(m.dense[1]);
+    }
+
+    static_assert(Block0::cout <= NN_MAX_CHANNELS && Block1::cout <= NN_MAX_CHANNELS &&
+                  Dense0::out <= NN_MAX_CHANNELS && Dense1::out <= NN_MAX_CHANNELS, "bias tables too small");
+
+    static void bind(const nn_model_t& m, nn_static_tables_t& tab) {
+        Block0::bind(m.blocks[0], tab.conv_bias[0]);
+        Block1::bind(m.blocks[1], tab.conv_bias[1]);
+        Lstm0::bind(m.lstm[0], tab.recurrent_bias[0], tab.cell_requant[0]);
+        Lstm1::bind(m.lstm[1], tab.recurrent_bias[1], tab.cell_requant[1]);
+        tab.score_bias = Att::bind(m.attention);
+        Dense0::bind(m.dense[0], tab.dense_bias[0]);
+        Dense1::bind(m.dense[1], tab.dense_bias[1]);
+    }
+
+    static void invoke(const nn_model_t& m, const nn_static_tables_t& tab, uint8_t* arena,
+                       const T* input, T* output) {
+        T* x = (T*)(arena + x_offset);
+        T* seq = (T*)(arena + seq_offset);
+        T* rows = (T*)(arena + rows_offset);
+        T* cell = (T*)(arena + cell_offset);
+        T* h0 = (T*)(arena + h0_offset);
+        T* context = (T*)(arena + context_offset);
+        T* hidden = (T*)(arena + hidden_offset);
+        T* logits = (T*)(arena + logits_offset);
+
+        Block0::run(m.blocks[0], tab.conv_bias[0], input, x);
+        Block1::run(m.blocks[1], tab.conv_bias[1], x, seq);
+
+        Lstm0::template run<steps, steps>(m.lstm[0], tab.recurrent_bias[0], tab.cell_requant[0],
+                                          seq, x, cell, h0, seq, [](int, const T*) {});
+
+        if (m.online_attention) {
+            typename Att::State state;
+            Att::begin(state);
+            Lstm1::template run<steps, 2>(m.lstm[1], tab.recurrent_bias[1], tab.cell_requant[1],
+                                          seq, x, cell, h0, rows,
+                                          [&](int t, const T* h) { Att::push(m.attention, tab.score_bias, state, t, h); });
+            Att::finish(m.attention, state, context);
+        } else {
+            Lstm1::template run<steps, steps>(m.lstm[1], tab.recurrent_bias[1], tab.cell_requant[1],
+                                              seq, x, cell, h0, seq, [](int, const T*) {});
+            Att::run(m.attention, tab.score_bias, seq, x, context);
+        }
+
+        Dense0::run(m.dense[0], tab.dense_bias[0], context, hidden);
+        Dense1::run(m.dense[1], tab.dense_bias[1], hidden, logits);
+        softmax<classes>(m.softmax, logits, output);
+    }
+};
+
+} // namespace nn_static
+
+#endif // NN_STATIC_HPP
@@ -0,0 +1,63 @@
+#ifndef NN_STREAM_H
+#define NN_STREAM_H
+
+#include "port.h"
+#include "nn_engine.h"
+
+// Streaming (per-sample) executor for a bound nn_model_t.
+// Instead of re-running the whole window, every pushed sample advances the
+// Conv1D/BN/MaxPool front end by one position and, once per pooled step, the
+// LSTM stack by one time step. Conv receptive-field tails, MaxPool phase and
+// LSTM h/c are kept between calls; the last attention.steps LSTM outputs are
+// kept in a mirrored ring so the attention/Dense head can run on a contiguous
+// view whenever a decision is due.
+//
+// The LSTM state is carried across windows rather than reset at each window
+// start, so results approximate (but are not identical to) nn_engine_invoke()
+// on the same samples. The head follows model->online_attention, which the
+// firmware sets for streaming.
+
+typedef struct {
+    const nn_model_t* model;
+    uint8_t* arena;
+    size_t arena_size;
+
+    // Conv front end
+    int8_t* conv_history[NN_CONV_BLOCKS];   // last `kernel` input rows, oldest first
+    uint32_t conv_rows[NN_CONV_BLOCKS];     // input rows seen by each block
+    int8_t* conv_out[NN_CONV_BLOCKS];       // one conv output row
+    int8_t* pool_max[NN_CONV_BLOCKS];       // running max over the pool window
+    int32_t* pool_acc[NN_CONV_BLOCKS];      // same over conv accumulators (fused blocks)
+    int pool_phase[NN_CONV_BLOCKS];
+
+    // LSTM stack
+    int8_t* lstm_h[NN_LSTM_LAYERS];
+    int8_t* lstm_cell[NN_LSTM_LAYERS];
+    int8_t* lstm_scratch;
+
+    // Last attention.steps outputs of the top LSTM, written twice
+    int8_t* history;
+    uint32_t history_pos;                   // next row to write, also the oldest row
+    uint32_t history_count;
+
+    nn_head_buffers_t head;
+
+    uint32_t samples;                       // samples pushed since reset
+    uint32_t steps;                         // LSTM steps since reset
+} nn_stream_t;
+
+size_t nn_stream_arena_size(const nn_model_t* model);
+esp_err_t nn_stream_init(nn_stream_t* stream, const nn_model_t* model, uint8_t* arena, size_t arena_size);
+void nn_stream_reset(nn_stream_t* stream);
+
+// sample: [features] int8 quantized with model->input_q
+esp_err_t nn_stream_push(nn_stream_t* stream, const int8_t* sample);
+
+// True once attention.steps LSTM outputs are available
+bool nn_stream_ready(const nn_stream_t* stream);
+
+// Runs the attention/Dense head over the latest steps.
+// output: [classes] int8 quantized with model->output_q
+esp_err_t nn_stream_evaluate(nn_stream_t* stream, int8_t* output);
+
+#endif // NN_STREAM_H
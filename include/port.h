@@ -0,0 +1,62 @@
+#ifndef PORT_H
+#define PORT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// Platform portability layer.
+// On ESP-IDF (ESP_PLATFORM defined by the IDF build) this simply pulls in the
+// native headers. On a plain host build it provides the handful of IDF types
+// and services the portable modules rely on (error codes, logging, timer).
+
+#ifdef ESP_PLATFORM
+
+#include <esp_err.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
+
+#else
+
+typedef int esp_err_t;
+
+#define ESP_OK                  0
+#define ESP_FAIL                -1
+#define ESP_ERR_NO_MEM          0x101
+#define ESP_ERR_INVALID_ARG     0x102
+#define ESP_ERR_INVALID_STATE   0x103
+#define ESP_ERR_INVALID_SIZE    0x104
+#define ESP_ERR_NOT_FOUND       0x105
+#define ESP_ERR_NOT_SUPPORTED   0x106
+#define ESP_ERR_TIMEOUT         0x107
+#define ESP_ERR_INVALID_RESPONSE 0x108
+#define ESP_ERR_INVALID_CRC     0x109
+#define ESP_ERR_INVALID_VERSION 0x10A
+
+const char* esp_err_to_name(esp_err_t code);
+int64_t esp_timer_get_time(void);
+
+#ifdef HOST_OSAL
+// Full pipeline on the host OSAL (host/osal): stamped with the virtual clock
+#ifdef __cplusplus
+extern "C"
+#endif
+void osal_log(char level, const char* tag, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
+#define ESP_LOGE(tag, fmt, ...) osal_log('E', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) osal_log('W', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) osal_log('I', tag, fmt, ##__VA_ARGS__)
+#else
+#define ESP_LOGE(tag, fmt, ...) fprintf(stderr, "E (%s) " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) fprintf(stderr, "W (%s) " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) fprintf(stdout, "I (%s) " fmt "\n", tag, ##__VA_ARGS__)
+#endif
+#define ESP_LOGD(tag, fmt, ...) do { } while (0)
+
+// Opaque FreeRTOS handle, for declarations shared with the target
+typedef struct tskTaskControlBlock* TaskHandle_t;
+
+#endif // ESP_PLATFORM
+
+#endif // PORT_H
@@ -0,0 +1,79 @@
+#ifndef PREFILTER_H
+#define PREFILTER_H
+
+#include "config.h"
+
+// Motion prefilter that gates the CNN-LSTM.
+// Runs per sample in integer arithmetic (accel in mg, gyro in 0.1 dps) next
+// to the sample buffer and decides once per window whether the full model is
+// worth running: on free-fall dips, impact peaks, high gyro energy or a change
+// in activity level, for a hold period after any of those, and periodically
+// as a keep-alive so the last classification never goes stale.
+
+typedef enum {
+    PREFILTER_TRIGGER_NONE      = 0,
+    PREFILTER_TRIGGER_FREEFALL  = 1 << 0,
+    PREFILTER_TRIGGER_IMPACT    = 1 << 1,
+    PREFILTER_TRIGGER_GYRO      = 1 << 2,
+    PREFILTER_TRIGGER_ACTIVITY  = 1 << 3,
+    PREFILTER_TRIGGER_HOLD      = 1 << 4,
+    PREFILTER_TRIGGER_KEEPALIVE = 1 << 5,
+    PREFILTER_TRIGGER_ALWAYS    = 1 << 6,   // prefilter disabled
+} prefilter_trigger_t;
+
+#define PREFILTER_EVENT_MASK (PREFILTER_TRIGGER_FREEFALL | PREFILTER_TRIGGER_IMPACT | \
+                              PREFILTER_TRIGGER_GYRO | PREFILTER_TRIGGER_ACTIVITY)
+
+typedef struct {
+    uint32_t samples;
+    uint32_t windows;
+    uint32_t executed;              // gated windows passed to the model
+    uint32_t skipped;               // gated windows held back
+    uint32_t freefall_events;
+    uint32_t impact_events;
+    uint32_t gyro_windows;
+    uint32_t activity_windows;
+    uint32_t keepalive_windows;
+} prefilter_stats_t;
+
+typedef struct {
+    // Per-sample detectors
+    uint16_t freefall_run;          // consecutive samples below the free-fall threshold
+    bool in_impact;
+    uint32_t pending;               // event bits seen since the last window
+
+    // Per-window accumulators
+    uint32_t hop_samples;
+    uint32_t dynamic_sum_mg;        // sum of | |a| - 1 g |
+    uint64_t gyro_energy;           // sum of |w|^2 in (0.1 dps)^2
+    uint32_t last_activity_mg;
+
+    uint16_t hold_windows;
+    uint16_t idle_windows;
+
+    // Whether the inference cadence runs the model on these decisions;
+    // executed and skipped only count windows closed while it does
+    bool gating;
+
+    prefilter_stats_t stats;
+} prefilter_t;
+
+void prefilter_init(prefilter_t* pf);
+
+// One sample: acceleration in mg, angular rate in 0.1 dps
+void prefilter_push(prefilter_t* pf, int32_t ax_mg, int32_t ay_mg, int32_t az_mg,
+                    int32_t gx_ddps, int32_t gy_ddps, int32_t gz_ddps);
+
+// Closes the current window. Returns the trigger bits that schedule the
+// model, PREFILTER_TRIGGER_NONE if the window can be skipped.
+uint32_t prefilter_end_window(prefilter_t* pf);
+
+// Set by the inference cadence: true (the default) when it runs the model
+// only on a trigger, false when it runs on every hop or every N-th
+void prefilter_set_gating(prefilter_t* pf, bool gating);
+
+void prefilter_print_stats(const prefilter_t* pf);
+
+extern prefilter_t g_prefilter;
+
+#endif // PREFILTER_H
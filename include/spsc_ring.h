@@ -0,0 +1,45 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include "port.h"
+#include <stdatomic.h>
+
+// Lock-free single-producer/single-consumer ring of fixed-size elements.
+// head is only written by the producer and tail only by the consumer; each
+// side publishes with a release store and observes the other with an acquire
+// load, so a popped element is always completely written. Producer state,
+// consumer state and the read-only description live on separate cache lines
+// to avoid false sharing between the two cores.
+
+#define SPSC_CACHE_LINE 64
+
+typedef struct {
+    // Producer side
+    _Alignas(SPSC_CACHE_LINE) _Atomic uint32_t head;
+    uint32_t tail_cache;                // last tail seen by the producer
+    uint32_t dropped;                   // pushes rejected because the ring was full
+
+    // Consumer side
+    _Alignas(SPSC_CACHE_LINE) _Atomic uint32_t tail;
+    uint32_t head_cache;                // last head seen by the consumer
+
+    // Shared, read-only after init
+    _Alignas(SPSC_CACHE_LINE) uint8_t* storage;
+    uint32_t elem_size;
+    uint32_t capacity;                  // power of two
+    uint32_t mask;
+} spsc_ring_t;
+
+// storage must hold capacity * elem_size bytes; capacity must be a power of two
+esp_err_t spsc_ring_init(spsc_ring_t* ring, void* storage, uint32_t elem_size, uint32_t capacity);
+
+// Producer: false (and dropped++) if the ring is full
+bool spsc_ring_push(spsc_ring_t* ring, const void* elem);
+
+// Consumer: false if the ring is empty
+bool spsc_ring_pop(spsc_ring_t* ring, void* elem);
+
+// Elements currently queued (exact for either side, approximate for others)
+uint32_t spsc_ring_count(const spsc_ring_t* ring);
+
+#endif // SPSC_RING_H
@@ -4,15 +4,16 @@
 #include "config.h"
 #include "mpu6050_driver.h"
 
-// TensorFlow Lite Micro includes (placeholder for now)
-// In a full implementation, you would include the actual TensorFlow Lite headers
-#include "tensorflow/lite/micro/all_ops_resolver.h"
-#include "tensorflow/lite/micro/micro_error_reporter.h"
-#include "tensorflow/lite/micro/micro_interpreter.h"
-#include "tensorflow/lite/schema/schema_generated.h"
+#include "nn_engine.h"
+#include "nn_stream.h"
+#include "nn_static.h"
+#include "nn_pipeline.h"
+#include "prefilter.h"
+#include "spsc_ring.h"
+#include "mem_placement.h"
+#include "model_store.h"
 
 // Model configuration
-#define TENSOR_ARENA_SIZE (1024 * 1024)  // 1MB for tensor arena
 #define MAX_INFERENCE_TIME_MS 1000
 
 // Inference result structure
@@ -24,14 +25,71 @@ typedef struct {
     bool is_valid;
 } inference_result_t;
 
-// Data buffer structure
+// Sliding window ring buffer.
+// Samples cross from the sensor task to the inference task through the
+// lock-free g_sample_ring; the window ring itself is only touched by the
+// inference task, so a window view can never tear.
+#define DATA_RING_CAPACITY INPUT_SEQUENCE_LENGTH
+
+// Element of g_sample_ring: raw registers only, converted to int8 model input
+// by one fixed-point affine per channel
+typedef struct {
+    mpu6050_raw_t raw;
+    uint64_t timestamp;
+} sensor_sample_t;
+
 typedef struct {
-    float data[MODEL_INPUT_SIZE];
-    uint32_t index;
-    bool is_full;
+    int16_t* data;              // [DATA_RING_CAPACITY][INPUT_FEATURES] raw accel xyz, gyro xyz
+    uint32_t index;             // next row to write
+    uint32_t count;             // valid rows, saturates at INPUT_SEQUENCE_LENGTH
+    uint32_t hop_count;         // samples since the last window
+    uint32_t window_start;      // oldest row of the ready window
+    uint32_t windows_emitted;
+    uint32_t windows_dropped;   // windows replaced before being consumed
+    uint32_t total_samples;
+    bool is_full;               // ring holds at least one full window
+    bool window_ready;
+    uint32_t window_trigger;    // prefilter_trigger_t bits of the ready window
     uint64_t last_update;
 } data_buffer_t;
 
+// Read-only view of one window in chronological order. The window wraps at
+// most once, so it is described by two contiguous runs of rows.
+typedef struct {
+    const int16_t* first;
+    uint32_t first_rows;
+    const int16_t* second;
+    uint32_t second_rows;
+    uint32_t sequence;          // windows_emitted when the view was taken
+} data_window_t;
+
+static inline const int16_t* data_window_row(const data_window_t* window, uint32_t t) {
+    if (t < window->first_rows) {
+        return window->first + t * INPUT_FEATURES;
+    }
+    return window->second + (t - window->first_rows) * INPUT_FEATURES;
+}
+
+typedef enum {
+    CADENCE_EVERY_HOP = INFERENCE_CADENCE_EVERY_HOP,
+    CADENCE_EVERY_N_HOPS = INFERENCE_CADENCE_EVERY_N_HOPS,
+    CADENCE_ON_TRIGGER = INFERENCE_CADENCE_ON_TRIGGER,
+} inference_cadence_t;
+
+// Inference task wake-up and scheduling counters
+typedef struct {
+    uint32_t notifications;     // window notifications sent by the sensor task
+    uint32_t wakes;             // inference task wake-ups
+    uint32_t timeouts;          // wake-ups without a notification
+    uint32_t idle_wakes;        // wake-ups that found no window
+    uint32_t windows;           // windows seen by the scheduler
+    uint32_t inferences;        // windows passed to the model
+    uint32_t skipped;           // windows skipped by the cadence policy
+} inference_metrics_t;
+
+// Called from the sensor task whenever a new window is due
+typedef void (*window_notify_fn_t)(void* ctx);
+
 // Function declarations
 esp_err_t tflite_init(void);
 esp_err_t tflite_inference_init(void);
@@ -39,7 +97,25 @@ esp_err_t tflite_load_model(void);
 esp_err_t tflite_setup_interpreter(void);
 
 // Data processing functions
-esp_err_t add_sensor_data_to_buffer(const mpu6050_data_t* sensor_data);
+esp_err_t add_sensor_data_to_buffer(const mpu6050_data_t* sensor_data);   // sensor task
+esp_err_t add_sensor_data_block_to_buffer(const mpu6050_data_t* samples, size_t count);   // sensor task
+esp_err_t process_sensor_samples(void);                                     // inference task
+esp_err_t get_data_window(data_window_t* window);
+void release_data_window(const data_window_t* window);
+esp_err_t skip_inference_window(void);
+
+// Event-driven scheduling
+void set_window_notify_callback(window_notify_fn_t callback, void* ctx);
+esp_err_t set_inference_cadence(inference_cadence_t cadence, uint32_t every_n);
+void record_inference_wake(bool notified);
+bool inference_window_due(void);
+void print_inference_metrics(void);
+
+// Pipelined inference (INFERENCE_PIPELINED): callback wakes the task that
+// runs the conv front end, which then calls run_pipeline_front(). Without a
+// worker the inference task runs both stages.
+void set_pipeline_worker_callback(window_notify_fn_t callback, void* ctx);
+void run_pipeline_front(void);
 esp_err_t prepare_input_tensor(float* input_data);
 esp_err_t normalize_sensor_data(float* data, size_t size);
 
@@ -49,9 +125,22 @@ esp_err_t process_inference_result(inference_result_t* result);
 int get_predicted_class(const float* probabilities);
 float get_confidence(const float* probabilities);
 
-// Memory management
-void* tflite_allocate_tensor_arena(size_t size);
-esp_err_t tflite_free_tensor_arena(void);
+// Shapes, input scaler and labels of the loaded model
+const model_meta_t* tflite_model_meta(void);
+// Bound graph of the active model (benchmarks, reports)
+const nn_model_t* tflite_active_model(void);
+const char* tflite_class_label(int index);
+
+// Model hot swap. tflite_stage_model() loads, binds, plans and warms up the
+// image at location (partition label, or file on the host) in the standby
+// slot on the calling task while the active model keeps serving; the
+// inference task switches to it at the next window boundary. The staged
+// model must use the running window length, and location must not be the
+// image the active model maps. One staging task at a time.
+esp_err_t tflite_stage_model(const char* location);
+bool tflite_model_swap_pending(void);
+const char* tflite_active_model_location(void);
+uint32_t tflite_model_swaps(void);
 
 // Debug functions
 void print_inference_result(const inference_result_t* result);
@@ -60,6 +149,8 @@ void print_data_buffer_status(void);
 
 // Global variables
 extern data_buffer_t g_data_buffer;
+extern spsc_ring_t g_sample_ring;
 extern inference_result_t g_last_result;
+extern inference_metrics_t g_inference_metrics;
 
 #endif // TFLITE_INFERENCE_H
\ No newline at end of file
@@ -0,0 +1,116 @@
+#ifndef TFLITE_MODEL_H
+#define TFLITE_MODEL_H
+
+#include "port.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Minimal read-only accessor for TensorFlow Lite flatbuffers.
+// All accessors work in place on the serialized model, nothing is copied and
+// every offset is bounds-checked, so the model may live in flash or in an
+// untrusted buffer.
+
+#define TFL_MAX_DIMS 4
+
+// Subset of tflite::TensorType
+typedef enum {
+    TFL_TYPE_FLOAT32 = 0,
+    TFL_TYPE_INT32 = 2,
+    TFL_TYPE_UINT8 = 3,
+    TFL_TYPE_INT64 = 4,
+    TFL_TYPE_INT16 = 7,
+    TFL_TYPE_INT8 = 9,
+} tfl_type_t;
+
+// Subset of tflite::BuiltinOperator used by the fall detection graph
+typedef enum {
+    TFL_OP_ADD = 0,
+    TFL_OP_CONV_2D = 3,
+    TFL_OP_DEQUANTIZE = 6,
+    TFL_OP_FULLY_CONNECTED = 9,
+    TFL_OP_LOGISTIC = 14,
+    TFL_OP_MAX_POOL_2D = 17,
+    TFL_OP_MUL = 18,
+    TFL_OP_RESHAPE = 22,
+    TFL_OP_SOFTMAX = 25,
+    TFL_OP_TANH = 28,
+    TFL_OP_TRANSPOSE = 39,
+    TFL_OP_SUM = 74,
+    TFL_OP_QUANTIZE = 114,
+    TFL_OP_WHILE = 119,
+} tfl_builtin_t;
+
+// Builtin option field indices (position in the options table)
+#define TFL_CONV_OPT_PADDING        0
+#define TFL_CONV_OPT_STRIDE_W       1
+#define TFL_CONV_OPT_ACTIVATION     3
+#define TFL_POOL_OPT_PADDING        0
+#define TFL_POOL_OPT_STRIDE_H       2
+#define TFL_POOL_OPT_FILTER_H       4
+#define TFL_FC_OPT_ACTIVATION       0
+#define TFL_SOFTMAX_OPT_BETA        0
+#define TFL_WHILE_OPT_BODY          1
+
+#define TFL_PADDING_SAME            0
+#define TFL_PADDING_VALID           1
+#define TFL_ACTIVATION_NONE         0
+#define TFL_ACTIVATION_RELU         1
+
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    uint32_t root;
+    uint32_t opcodes;
+    uint32_t num_opcodes;
+    uint32_t subgraphs;
+    uint32_t num_subgraphs;
+    uint32_t buffers;
+    uint32_t num_buffers;
+} tfl_model_t;
+
+typedef struct {
+    tfl_type_t type;
+    int ndim;
+    int32_t dims[TFL_MAX_DIMS];
+    const char* name;
+    size_t name_len;
+    const uint8_t* data;        // NULL for activations
+    size_t data_size;
+    const uint8_t* scales;      // raw little-endian float32 vector
+    size_t num_scales;
+    int32_t zero_point;         // first zero point (int8 models are symmetric per channel)
+} tfl_tensor_t;
+
+// Model access
+esp_err_t tfl_model_open(tfl_model_t* model, const uint8_t* data, size_t size);
+int tfl_subgraph_count(const tfl_model_t* model);
+int tfl_subgraph_input(const tfl_model_t* model, int sg, int index);
+int tfl_subgraph_output(const tfl_model_t* model, int sg, int index);
+
+// Operator access
+int tfl_op_count(const tfl_model_t* model, int sg);
+int32_t tfl_op_builtin(const tfl_model_t* model, int sg, int op);
+int tfl_op_inputs(const tfl_model_t* model, int sg, int op, int32_t* tensors, int max);
+int tfl_op_outputs(const tfl_model_t* model, int sg, int op, int32_t* tensors, int max);
+int32_t tfl_op_option_int(const tfl_model_t* model, int sg, int op, int field, int32_t def);
+uint8_t tfl_op_option_byte(const tfl_model_t* model, int sg, int op, int field, uint8_t def);
+float tfl_op_option_float(const tfl_model_t* model, int sg, int op, int field, float def);
+
+// Tensor access
+esp_err_t tfl_tensor_get(const tfl_model_t* model, int sg, int tensor, tfl_tensor_t* out);
+float tfl_tensor_scale(const tfl_tensor_t* tensor, size_t channel);
+// -1 if a dimension is negative or the count overflows
+int32_t tfl_tensor_elements(const tfl_tensor_t* tensor);
+
+// Graph walking helpers, return -1 when nothing matches
+int tfl_find_op(const tfl_model_t* model, int sg, int32_t builtin, int start);
+int tfl_find_consumer(const tfl_model_t* model, int sg, int32_t tensor, int32_t builtin);
+int tfl_find_producer(const tfl_model_t* model, int sg, int32_t tensor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TFLITE_MODEL_H
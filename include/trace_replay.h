@@ -0,0 +1,68 @@
+#ifndef TRACE_REPLAY_H
+#define TRACE_REPLAY_H
+
+#include "config.h"
+#include "mpu6050_driver.h"
+
+// Recorded sensor traces as a sample source in place of the MPU6050.
+// trace_replay_read() fills an mpu6050_data_t exactly like
+// mpu6050_read_data(), so samples go through add_sensor_data_to_buffer()
+// and the rest of the pipeline unchanged.
+//
+// Two formats, told apart by the first bytes:
+//  - CSV as used by the training notebook: a header row naming the columns,
+//    AccX, AccY, AccZ (g) and GyroX, GyroY, GyroZ (deg/s) in any order, other
+//    columns ignored, sampled at SAMPLE_RATE_HZ
+//  - packed binary: trace_header_t and then one mpu6050_raw_t per sample at
+//    the ±2 g / ±250 deg/s register scale (host tool replay_bench --pack)
+//
+// On the target, traces are files on the spiffs partition
+// (TRACE_REPLAY_MOUNT, mounted by trace_replay_mount()); on the host, any
+// file.
+
+#define TRACE_MAGIC   0x43525446u       // "FTRC"
+#define TRACE_VERSION 1
+#define TRACE_CSV_LINE_MAX 512
+
+// All fields little endian
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t sample_rate_hz;
+    uint32_t samples;
+    uint32_t reserved;
+} trace_header_t;
+
+typedef enum {
+    TRACE_FORMAT_CSV,
+    TRACE_FORMAT_BINARY,
+} trace_format_t;
+
+typedef struct {
+    FILE* file;
+    trace_format_t format;
+    bool loop;                  // rewind at the end instead of reporting it
+    uint16_t sample_rate_hz;
+    int columns[INPUT_FEATURES];  // CSV column of AccX..GyroZ
+    long data_offset;           // first sample
+    uint32_t line;              // CSV line, for error messages
+    uint32_t samples;           // delivered since open
+    uint32_t passes;            // completed passes over the file
+    uint32_t bad_rows;          // unparsable CSV rows, skipped
+    int64_t start_us;           // esp_timer_get_time() of the first sample
+} trace_replay_t;
+
+// Mounts the spiffs partition at TRACE_REPLAY_MOUNT; nothing to do on the host
+esp_err_t trace_replay_mount(void);
+
+esp_err_t trace_replay_open(trace_replay_t* replay, const char* path, bool loop);
+void trace_replay_close(trace_replay_t* replay);
+
+// Next sample, timestamped start_us + index / sample rate. ESP_ERR_NOT_FOUND
+// at the end of a non-looping trace.
+esp_err_t trace_replay_read(trace_replay_t* replay, mpu6050_data_t* data);
+
+// Samples/s and inferences/s since the first sample
+void trace_replay_print_stats(const trace_replay_t* replay, uint32_t inferences);
+
+#endif // TRACE_REPLAY_H
@@ -1,20 +1,33 @@
 #include "config.h"
 #include "mpu6050_driver.h"
 #include "tflite_inference.h"
+#include "trace_replay.h"
+#include "nn_lut.h"
+#include "nn_bench.h"
 
 // Task handles
 static TaskHandle_t mpu6050_task_handle = NULL;
 static TaskHandle_t inference_task_handle = NULL;
 static TaskHandle_t debug_task_handle = NULL;
+#if INFERENCE_PIPELINED
+static TaskHandle_t pipeline_task_handle = NULL;
+#endif
 
 // Queue handles
 static QueueHandle_t mpu6050_queue = NULL;
 static QueueHandle_t inference_queue = NULL;
 
+#if SENSOR_SOURCE_REPLAY
+static trace_replay_t replay;
+#endif
+
 // Task functions
 void mpu6050_task(void* pvParameters);
 void inference_task(void* pvParameters);
 void debug_task(void* pvParameters);
+#if INFERENCE_PIPELINED
+void pipeline_task(void* pvParameters);
+#endif
 
 // System initialization
 esp_err_t system_init(void);
@@ -65,12 +78,29 @@ void app_main(void) {
 esp_err_t system_init(void) {
     DEBUG_PRINT("Initializing system components...");
     
+#if SENSOR_SOURCE_REPLAY
+    // Recorded trace in place of the sensor
+    esp_err_t ret = trace_replay_mount();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+#ifdef ESP_PLATFORM
+    ret = trace_replay_open(&replay, REPLAY_TRACE_PATH, REPLAY_LOOP);
+#else
+    ret = trace_replay_open(&replay, REPLAY_HOST_PATH, REPLAY_LOOP);
+#endif
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Trace replay initialization failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+#else
     // Initialize MPU6050
     esp_err_t ret = mpu6050_init();
     if (ret != ESP_OK) {
         DEBUG_ERROR("MPU6050 initialization failed: %s", esp_err_to_name(ret));
         return ret;
     }
+#endif
     
     // Initialize TensorFlow Lite
     ret = tflite_init();
@@ -79,6 +109,18 @@ esp_err_t system_init(void) {
         return ret;
     }
     
+#if NN_LUT_REPORT_AT_BOOT
+    nn_lut_report();
+#endif
+    
+#if NN_BENCH_AT_BOOT
+    static nn_bench_report_t bench;
+    if (nn_bench_run(tflite_active_model(), NN_BENCH_ITERATIONS, &bench) == ESP_OK) {
+        nn_bench_print(&bench);
+        nn_bench_write_csv(&bench, stdout);
+    }
+#endif
+    
     DEBUG_PRINT("System components initialized successfully");
     return ESP_OK;
 }
@@ -139,6 +181,24 @@ esp_err_t create_tasks(void) {
         return ESP_ERR_NO_MEM;
     }
     
+#if INFERENCE_PIPELINED
+    // Conv front end of each window, next to acquisition on core 0
+    ret = xTaskCreatePinnedToCore(
+        pipeline_task,
+        "Pipeline_Task",
+        PIPELINE_TASK_STACK_SIZE,
+        NULL,
+        PIPELINE_TASK_PRIORITY,
+        &pipeline_task_handle,
+        0  // Run on Core 0
+    );
+    
+    if (ret != pdPASS) {
+        DEBUG_ERROR("Failed to create pipeline task");
+        return ESP_ERR_NO_MEM;
+    }
+    
+#endif
     // Create debug task
     ret = xTaskCreatePinnedToCore(
         debug_task,
@@ -159,15 +219,114 @@ esp_err_t create_tasks(void) {
     return ESP_OK;
 }
 
+#if SENSOR_SOURCE_REPLAY
 void mpu6050_task(void* pvParameters) {
-    DEBUG_PRINT("MPU6050 task started");
+    DEBUG_PRINT("MPU6050 task started (trace replay)");
     
+    TickType_t last_wake_time = xTaskGetTickCount();
     mpu6050_data_t sensor_data;
+    
+    while (1) {
+        if (REPLAY_REALTIME) {
+            vTaskDelayUntil(&last_wake_time, pdMS_TO_TICKS(SAMPLE_INTERVAL_MS));
+        }
+        
+        esp_err_t ret = trace_replay_read(&replay, &sensor_data);
+        if (ret != ESP_OK) {
+            DEBUG_PRINT("Trace replay finished");
+            trace_replay_print_stats(&replay, g_inference_metrics.inferences);
+            trace_replay_close(&replay);
+            while (1) {
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            }
+        }
+        
+        // Unthrottled, wait for the inference task rather than drop samples
+        while (!REPLAY_REALTIME && spsc_ring_count(&g_sample_ring) >= g_sample_ring.capacity) {
+            vTaskDelay(1);
+        }
+        
+        ret = add_sensor_data_to_buffer(&sensor_data);
+        if (ret != ESP_OK) {
+            DEBUG_ERROR("Failed to add data to buffer: %s", esp_err_to_name(ret));
+        }
+        
+        if (xQueueSend(mpu6050_queue, &sensor_data, 0) != pdTRUE) {
+            DEBUG_WARN("MPU6050 queue full, dropping data");
+        }
+    }
+}
+#else
+// Blocks until the next sample or burst is due, from the sensor's own
+// data-ready interrupt when available and the tick otherwise
+static void wait_for_sensor(TickType_t* last_wake_time, uint32_t period_ms, bool int_paced) {
+    if (!int_paced) {
+        vTaskDelayUntil(last_wake_time, pdMS_TO_TICKS(period_ms));
+        return;
+    }
+    
+    if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(period_ms * 2)) == 0) {
+        DEBUG_WARN("No MPU6050 data-ready interrupt");
+    }
+}
+
+void mpu6050_task(void* pvParameters) {
+    DEBUG_PRINT("MPU6050 task started");
+    
     TickType_t last_wake_time = xTaskGetTickCount();
+    bool int_paced = false;
+    
+#if MPU6050_INT_MODE
+    esp_err_t int_ret = mpu6050_int_enable(xTaskGetCurrentTaskHandle(),
+                                           MPU6050_FIFO_MODE ? MPU6050_FIFO_BURST_SAMPLES : 1);
+    if (int_ret == ESP_OK) {
+        int_paced = true;
+    } else {
+        DEBUG_WARN("Data-ready interrupt unavailable, falling back to timed sampling");
+    }
+#endif
+    
+#if MPU6050_FIFO_MODE
+    // The sensor samples into its FIFO; drain it once per burst
+    static mpu6050_data_t samples[MPU6050_FIFO_MAX_SAMPLES];
     
     while (1) {
+        wait_for_sensor(&last_wake_time, MPU6050_FIFO_BURST_SAMPLES * SAMPLE_INTERVAL_MS, int_paced);
+        
+        size_t count = 0;
+        esp_err_t ret = mpu6050_read_fifo(samples, MPU6050_FIFO_MAX_SAMPLES, &count);
+        if (ret != ESP_OK) {
+            // The samples read before the failure are still good
+            DEBUG_ERROR("Failed to read MPU6050 FIFO: %s", esp_err_to_name(ret));
+        }
+        if (count == 0) {
+            continue;
+        }
+        
+        // Hand the whole burst to the inference buffer
+        ret = add_sensor_data_block_to_buffer(samples, count);
+        if (ret != ESP_OK) {
+            DEBUG_ERROR("Failed to add data to buffer: %s", esp_err_to_name(ret));
+        }
+        
+        // Send the newest sample to the queue (for other tasks if needed)
+        if (xQueueSend(mpu6050_queue, &samples[count - 1], 0) != pdTRUE) {
+            DEBUG_WARN("MPU6050 queue full, dropping data");
+        }
+    }
+#else
+    mpu6050_data_t sensor_data;
+    
+    while (1) {
+        // Wait for next sample
+        wait_for_sensor(&last_wake_time, SAMPLE_INTERVAL_MS, int_paced);
+        
         // Read sensor data
         esp_err_t ret = mpu6050_read_data(&sensor_data);
+        if (ret == ESP_ERR_NOT_FOUND) {
+            // Woke before the sample: the next wake picks it up
+            continue;
+        }
         if (ret != ESP_OK) {
             DEBUG_ERROR("Failed to read MPU6050 data: %s", esp_err_to_name(ret));
             vTaskDelay(pdMS_TO_TICKS(100));
@@ -184,10 +343,13 @@ void mpu6050_task(void* pvParameters) {
         if (xQueueSend(mpu6050_queue, &sensor_data, 0) != pdTRUE) {
             DEBUG_WARN("MPU6050 queue full, dropping data");
         }
-        
-        // Wait for next sample
-        vTaskDelayUntil(&last_wake_time, pdMS_TO_TICKS(SAMPLE_INTERVAL_MS));
     }
+#endif
+}
+#endif
+
+static void notify_inference_task(void* ctx) {
+    xTaskNotifyGive((TaskHandle_t)ctx);
 }
 
 void inference_task(void* pvParameters) {
@@ -195,37 +357,68 @@ void inference_task(void* pvParameters) {
     
     inference_result_t result;
     
+    // The sensor task wakes this task once per hop instead of it polling
+    set_window_notify_callback(notify_inference_task, xTaskGetCurrentTaskHandle());
+    
     while (1) {
-        // Wait for data buffer to be full
-        if (!g_data_buffer.is_full) {
-            vTaskDelay(pdMS_TO_TICKS(100));
-            continue;
-        }
+        // Block until a window is due; the timeout only covers missed notifications
+        uint32_t notified = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(INFERENCE_WAIT_TIMEOUT_MS));
         
-        // Run inference
-        esp_err_t ret = run_inference(&result);
-        if (ret != ESP_OK) {
-            DEBUG_ERROR("Inference failed: %s", esp_err_to_name(ret));
-            vTaskDelay(pdMS_TO_TICKS(100));
-            continue;
-        }
+        // Move queued samples into the window ring
+        process_sensor_samples();
+        record_inference_wake(notified > 0);
         
-        // Process results
-        ret = process_inference_result(&result);
-        if (ret != ESP_OK) {
-            DEBUG_ERROR("Failed to process inference result: %s", esp_err_to_name(ret));
-        }
-        
-        // Send result to queue (for other tasks if needed)
-        if (xQueueSend(inference_queue, &result, 0) != pdTRUE) {
-            DEBUG_WARN("Inference queue full, dropping result");
+        // Several windows may be pending if the previous inference ran long
+        while (g_data_buffer.window_ready) {
+            // Skip windows the cadence policy does not schedule
+            if (!inference_window_due()) {
+                skip_inference_window();
+                process_sensor_samples();
+                continue;
+            }
+            
+            // Run inference
+            esp_err_t ret = run_inference(&result);
+            if (ret != ESP_OK) {
+                DEBUG_ERROR("Inference failed: %s", esp_err_to_name(ret));
+                break;
+            }
+            
+            // Process results
+            ret = process_inference_result(&result);
+            if (ret != ESP_OK) {
+                DEBUG_ERROR("Failed to process inference result: %s", esp_err_to_name(ret));
+            }
+            
+            // Send result to queue (for other tasks if needed)
+            if (xQueueSend(inference_queue, &result, 0) != pdTRUE) {
+                DEBUG_WARN("Inference queue full, dropping result");
+            }
+            
+            process_sensor_samples();
         }
-        
-        // Wait a bit before next inference
-        vTaskDelay(pdMS_TO_TICKS(500));
     }
 }
 
+#if INFERENCE_PIPELINED
+static void notify_pipeline_task(void* ctx) {
+    xTaskNotifyGive((TaskHandle_t)ctx);
+}
+
+void pipeline_task(void* pvParameters) {
+    DEBUG_PRINT("Pipeline task started");
+    
+    // run_inference() wakes this task once the window is quantized; the
+    // inference task meanwhile consumes the chunks as they are published
+    set_pipeline_worker_callback(notify_pipeline_task, xTaskGetCurrentTaskHandle());
+    
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        run_pipeline_front();
+    }
+}
+
+#endif
 void debug_task(void* pvParameters) {
     DEBUG_PRINT("Debug task started");
     
@@ -238,17 +431,24 @@ void debug_task(void* pvParameters) {
         // Print system status every 10 seconds
         if (debug_counter % 10 == 0) {
             DEBUG_PRINT("=== System Status ===");
-            DEBUG_PRINT("Uptime: %lu seconds", debug_counter);
-            DEBUG_PRINT("Free heap: %lu bytes", esp_get_free_heap_size());
-            DEBUG_PRINT("Minimum free heap: %lu bytes", esp_get_minimum_free_heap_size());
+            DEBUG_PRINT("Uptime: %lu seconds", (unsigned long)debug_counter);
+            DEBUG_PRINT("Free heap: %lu bytes", (unsigned long)esp_get_free_heap_size());
+            DEBUG_PRINT("Minimum free heap: %lu bytes", (unsigned long)esp_get_minimum_free_heap_size());
             
             // Print data buffer status
             print_data_buffer_status();
+            prefilter_print_stats(&g_prefilter);
+            print_inference_metrics();
+#if SENSOR_SOURCE_REPLAY
+            trace_replay_print_stats(&replay, g_inference_metrics.inferences);
+#else
+            mpu6050_print_jitter();
+#endif
             
             // Print last inference result if available
             if (g_last_result.is_valid) {
                 DEBUG_PRINT("Last inference: %s (%.3f)", 
-                           CLASS_LABELS[g_last_result.predicted_class], 
+                           tflite_class_label(g_last_result.predicted_class), 
                            g_last_result.confidence);
             }
             
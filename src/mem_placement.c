@@ -0,0 +1,272 @@
+#include "mem_placement.h"
+#include "config.h"
+
+#ifdef ESP_PLATFORM
+#include <esp_cpu.h>
+#define CLOCK_NOW() ((uint32_t)esp_cpu_get_cycle_count())
+#define CLOCK_UNIT "cycles"
+#else
+#define CLOCK_NOW() ((uint32_t)(esp_timer_get_time() * 1000))
+#define CLOCK_UNIT "ns"
+#endif
+
+// Bytes read when measuring the cost of a placed buffer
+#define MEM_COST_SAMPLE_BYTES 4096
+
+#define POLICY(...) { { __VA_ARGS__ }, sizeof((mem_region_t[]){ __VA_ARGS__ }) / sizeof(mem_region_t) }
+
+static mem_policy_t policies[MEM_CLASS_COUNT] = {
+    [MEM_CLASS_WEIGHTS] = POLICY(MEM_POLICY_WEIGHTS),
+    [MEM_CLASS_ACTIVATIONS] = POLICY(MEM_POLICY_ACTIVATIONS),
+    [MEM_CLASS_LSTM_STATE] = POLICY(MEM_POLICY_LSTM_STATE),
+    [MEM_CLASS_SAMPLE_RING] = POLICY(MEM_POLICY_SAMPLE_RING),
+};
+
+static mem_placement_t placements[MEM_MAX_PLACEMENTS];
+static int placement_count = 0;
+static volatile uint32_t cost_sink;
+
+#ifndef ESP_PLATFORM
+// Rough ESP32-S3 figures: SRAM is single cycle, a cache miss to octal PSRAM
+// or quad flash at 80 MHz costs on the order of 100 ns per line
+typedef struct {
+    size_t capacity;
+    size_t used;
+    uint32_t line_ns;
+} sim_region_t;
+
+#define SIM_DEFAULTS { \
+        [MEM_REGION_INTERNAL] = { 320 * 1024, 0, 2 }, \
+        [MEM_REGION_PSRAM] = { 8 * 1024 * 1024, 0, 100 }, \
+        [MEM_REGION_FLASH] = { 0, 0, 120 }, \
+    }
+
+static const sim_region_t sim_defaults[MEM_REGION_COUNT] = SIM_DEFAULTS;
+static sim_region_t sim[MEM_REGION_COUNT] = SIM_DEFAULTS;
+
+void mem_sim_configure(mem_region_t region, size_t capacity, uint32_t line_ns) {
+    if (region < MEM_REGION_COUNT) {
+        sim[region].capacity = capacity;
+        sim[region].line_ns = line_ns;
+    }
+}
+
+void mem_sim_reset(void) {
+    for (int r = 0; r < MEM_REGION_COUNT; r++) {
+        size_t used = sim[r].used;
+        sim[r] = sim_defaults[r];
+        sim[r].used = used;
+    }
+}
+#endif
+
+const char* mem_region_name(mem_region_t region) {
+    switch (region) {
+        case MEM_REGION_INTERNAL: return "internal RAM";
+        case MEM_REGION_PSRAM:    return "PSRAM";
+        case MEM_REGION_FLASH:    return "flash";
+        default:                  return "?";
+    }
+}
+
+const char* mem_class_name(mem_class_t cls) {
+    switch (cls) {
+        case MEM_CLASS_WEIGHTS:     return "weights";
+        case MEM_CLASS_ACTIVATIONS: return "activations";
+        case MEM_CLASS_LSTM_STATE:  return "LSTM state";
+        case MEM_CLASS_SAMPLE_RING: return "sample ring";
+        default:                    return "?";
+    }
+}
+
+esp_err_t mem_set_policy(mem_class_t cls, const mem_region_t* regions, int count) {
+    if (cls >= MEM_CLASS_COUNT || regions == NULL || count <= 0 || count > MEM_REGION_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < count; i++) {
+        if (regions[i] >= MEM_REGION_COUNT) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (regions[i] == MEM_REGION_FLASH && cls != MEM_CLASS_WEIGHTS) {
+            DEBUG_ERROR("%s buffers are written and cannot live in flash", mem_class_name(cls));
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    memcpy(policies[cls].regions, regions, (size_t)count * sizeof(regions[0]));
+    policies[cls].count = count;
+    return ESP_OK;
+}
+
+const mem_policy_t* mem_get_policy(mem_class_t cls) {
+    return cls < MEM_CLASS_COUNT ? &policies[cls] : NULL;
+}
+
+static void* region_alloc(mem_region_t region, size_t size, size_t align) {
+    size = (size + align - 1) & ~(align - 1);
+#ifdef ESP_PLATFORM
+    uint32_t caps = MALLOC_CAP_8BIT | (region == MEM_REGION_INTERNAL ? MALLOC_CAP_INTERNAL : MALLOC_CAP_SPIRAM);
+    return heap_caps_aligned_alloc(align, size, caps);
+#else
+    if (sim[region].used + size > sim[region].capacity) {
+        return NULL;
+    }
+    void* ptr = aligned_alloc(align, size);
+    if (ptr != NULL) {
+        sim[region].used += size;
+    }
+    return ptr;
+#endif
+}
+
+static void region_free(const mem_placement_t* p) {
+#ifdef ESP_PLATFORM
+    heap_caps_free((void*)p->ptr);
+#else
+    sim[p->region].used -= (p->size + p->align - 1) & ~(p->align - 1);
+    free((void*)p->ptr);
+#endif
+}
+
+// Reads the start of the buffer once, touching every line
+static uint32_t measure_read_cost(const void* ptr, size_t size, mem_region_t region) {
+    size_t bytes = size < MEM_COST_SAMPLE_BYTES ? size : MEM_COST_SAMPLE_BYTES;
+    size_t lines = bytes / MEM_COST_LINE_BYTES;
+    if (lines == 0) {
+        return 0;
+    }
+
+    const volatile uint8_t* p = (const volatile uint8_t*)ptr;
+    uint32_t sum = 0;
+    uint32_t start = CLOCK_NOW();
+    for (size_t i = 0; i < lines * MEM_COST_LINE_BYTES; i += 4) {
+        sum += p[i];
+    }
+    uint32_t cost = (CLOCK_NOW() - start) / (uint32_t)lines;
+    cost_sink = sum;
+
+#ifndef ESP_PLATFORM
+    cost += sim[region].line_ns;
+#endif
+    return cost;
+}
+
+static esp_err_t record(const char* name, mem_class_t cls, mem_region_t region, bool fallback,
+                        bool owned, const void* ptr, size_t size, size_t align) {
+    if (placement_count >= MEM_MAX_PLACEMENTS) {
+        DEBUG_ERROR("Too many placed buffers (%d)", MEM_MAX_PLACEMENTS);
+        return ESP_ERR_NO_MEM;
+    }
+
+    mem_placement_t* p = &placements[placement_count++];
+    p->name = name;
+    p->cls = cls;
+    p->region = region;
+    p->fallback = fallback;
+    p->owned = owned;
+    p->ptr = ptr;
+    p->size = size;
+    p->align = align;
+    p->read_cost = measure_read_cost(ptr, size, region);
+
+    if (fallback) {
+        DEBUG_WARN("%s (%zu bytes) placed in %s, not the preferred %s", name, size,
+                   mem_region_name(region), mem_region_name(policies[cls].regions[0]));
+    }
+    return ESP_OK;
+}
+
+void* mem_alloc(mem_class_t cls, const char* name, size_t size, size_t align) {
+    if (cls >= MEM_CLASS_COUNT || size == 0 || align == 0 || (align & (align - 1)) != 0) {
+        return NULL;
+    }
+
+    const mem_policy_t* policy = &policies[cls];
+    for (int i = 0; i < policy->count; i++) {
+        mem_region_t region = policy->regions[i];
+        if (region == MEM_REGION_FLASH) {
+            continue;
+        }
+        void* ptr = region_alloc(region, size, align);
+        if (ptr == NULL) {
+            continue;
+        }
+        if (record(name, cls, region, i > 0, true, ptr, size, align) != ESP_OK) {
+            mem_placement_t p = { .region = region, .ptr = ptr, .size = size, .align = align };
+            region_free(&p);
+            return NULL;
+        }
+        return ptr;
+    }
+
+    DEBUG_ERROR("No %s region can hold %s (%zu bytes)", mem_class_name(cls), name, size);
+    return NULL;
+}
+
+const void* mem_place_const(mem_class_t cls, const char* name, const void* data, size_t size, size_t align) {
+    if (cls >= MEM_CLASS_COUNT || data == NULL || size == 0 || align == 0 || (align & (align - 1)) != 0) {
+        return NULL;
+    }
+
+    const mem_policy_t* policy = &policies[cls];
+    for (int i = 0; i < policy->count; i++) {
+        mem_region_t region = policy->regions[i];
+        if (region == MEM_REGION_FLASH) {
+            return record(name, cls, region, i > 0, false, data, size, align) == ESP_OK ? data : NULL;
+        }
+        void* copy = region_alloc(region, size, align);
+        if (copy == NULL) {
+            continue;
+        }
+        memcpy(copy, data, size);
+        if (record(name, cls, region, i > 0, true, copy, size, align) != ESP_OK) {
+            mem_placement_t p = { .region = region, .ptr = copy, .size = size, .align = align };
+            region_free(&p);
+            return NULL;
+        }
+        return copy;
+    }
+
+    // Nothing in RAM could take it; the flash copy is always there
+    return record(name, cls, MEM_REGION_FLASH, true, false, data, size, align) == ESP_OK ? data : NULL;
+}
+
+const mem_placement_t* mem_find(const void* ptr) {
+    for (int i = 0; i < placement_count; i++) {
+        if (placements[i].ptr == ptr) {
+            return &placements[i];
+        }
+    }
+    return NULL;
+}
+
+void mem_free(const void* ptr) {
+    const mem_placement_t* p = mem_find(ptr);
+    if (p == NULL) {
+        return;
+    }
+    if (p->owned) {
+        region_free(p);
+    }
+    int i = (int)(p - placements);
+    placements[i] = placements[--placement_count];
+}
+
+void mem_report(void) {
+    DEBUG_PRINT("Memory placement (read cost per %d-byte line):", MEM_COST_LINE_BYTES);
+    for (int i = 0; i < placement_count; i++) {
+        const mem_placement_t* p = &placements[i];
+        DEBUG_PRINT("  %-14s %7zu bytes  %-11s -> %-12s %4lu " CLOCK_UNIT "%s",
+                    p->name, p->size, mem_class_name(p->cls), mem_region_name(p->region),
+                    (unsigned long)p->read_cost, p->fallback ? "  (fallback)" : "");
+    }
+
+#ifdef ESP_PLATFORM
+    size_t internal_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    size_t psram_free = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+#else
+    size_t internal_free = sim[MEM_REGION_INTERNAL].capacity - sim[MEM_REGION_INTERNAL].used;
+    size_t psram_free = sim[MEM_REGION_PSRAM].capacity - sim[MEM_REGION_PSRAM].used;
+#endif
+    DEBUG_PRINT("  Free: internal RAM %zu bytes, PSRAM %zu bytes", internal_free, psram_free);
+}
@@ -0,0 +1,250 @@
+#include "model_store.h"
+#include "config.h"
+
+#ifdef ESP_PLATFORM
+#include <esp_partition.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Class labels
+const char* CLASS_LABELS[NUM_CLASSES] = {
+    "Normal",
+    "Fall",
+    "Near Fall",
+    "Sitting",
+    "Walking"
+};
+
+uint32_t model_crc32(uint32_t crc, const void* data, size_t size) {
+    // Reflected polynomial 0xEDB88320, four bits per step
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    const uint8_t* p = (const uint8_t*)data;
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = (crc >> 4) ^ table[(crc ^ p[i]) & 0x0F];
+        crc = (crc >> 4) ^ table[(crc ^ (p[i] >> 4)) & 0x0F];
+    }
+    return ~crc;
+}
+
+void model_meta_default(model_meta_t* meta) {
+    memset(meta, 0, sizeof(*meta));
+    meta->magic = MODEL_META_MAGIC;
+    meta->version = MODEL_META_VERSION;
+    meta->seq_len = INPUT_SEQUENCE_LENGTH;
+    meta->features = INPUT_FEATURES;
+    meta->classes = NUM_CLASSES;
+    meta->sample_rate_hz = SAMPLE_RATE_HZ;
+    for (int f = 0; f < INPUT_FEATURES; f++) {
+        meta->scale[f] = f < 3 ? MODEL_DEFAULT_ACCEL_SCALE_G : MODEL_DEFAULT_GYRO_SCALE_DPS;
+    }
+    meta->clip_min = -1.0f;
+    meta->clip_max = 1.0f;
+    for (int c = 0; c < NUM_CLASSES; c++) {
+        strncpy(meta->labels[c], CLASS_LABELS[c], MODEL_META_LABEL_LEN - 1);
+    }
+}
+
+esp_err_t model_meta_check(const model_meta_t* meta) {
+    if (meta->magic != MODEL_META_MAGIC) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (meta->version != MODEL_META_VERSION) {
+        DEBUG_ERROR("Model metadata version %u, expected %u", meta->version, MODEL_META_VERSION);
+        return ESP_ERR_INVALID_VERSION;
+    }
+    if (meta->seq_len == 0 || meta->features == 0 || meta->features > MODEL_META_MAX_FEATURES ||
+        meta->classes == 0 || meta->classes > MODEL_META_MAX_CLASSES || !(meta->clip_min < meta->clip_max)) {
+        DEBUG_ERROR("Model metadata inconsistent: [%u x %u] -> %u, clip [%g, %g]",
+                    meta->seq_len, meta->features, meta->classes, meta->clip_min, meta->clip_max);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    for (int f = 0; f < meta->features; f++) {
+        if (!(meta->scale[f] > 0.0f) || !isfinite(meta->center[f])) {
+            DEBUG_ERROR("Model metadata: bad scaler for feature %d (%g, %g)", f, meta->center[f], meta->scale[f]);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    for (int c = 0; c < meta->classes; c++) {
+        if (memchr(meta->labels[c], '\0', MODEL_META_LABEL_LEN) == NULL) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    return ESP_OK;
+}
+
+size_t model_image_meta_offset(const model_image_header_t* header) {
+    return header->header_size + (((size_t)header->payload_size + 3) & ~(size_t)3);
+}
+
+void model_image_header_init(model_image_header_t* header, const void* payload, size_t payload_size,
+                             const model_meta_t* meta) {
+    memset(header, 0, sizeof(*header));
+    header->magic = MODEL_IMAGE_MAGIC;
+    header->version = meta != NULL ? MODEL_IMAGE_VERSION : 1;
+    size_t fixed = meta != NULL ? sizeof(*header) : MODEL_IMAGE_V1_HEADER_BYTES;
+    header->header_size = (fixed + MODEL_IMAGE_ALIGN - 1) & ~(MODEL_IMAGE_ALIGN - 1);
+    header->payload_size = (uint32_t)payload_size;
+    header->payload_crc32 = model_crc32(0, payload, payload_size);
+    if (meta != NULL) {
+        header->meta_size = sizeof(*meta);
+        header->meta_crc32 = model_crc32(0, meta, sizeof(*meta));
+    }
+}
+
+esp_err_t model_image_validate(const void* image, size_t size, model_blob_t* blob) {
+    if (image == NULL || blob == NULL || size < MODEL_IMAGE_V1_HEADER_BYTES) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    // Version 1 headers end before the metadata fields
+    model_image_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(&header, image, MODEL_IMAGE_V1_HEADER_BYTES);
+    if (header.magic != MODEL_IMAGE_MAGIC) {
+        // An erased partition reads as 0xFF
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (header.version < 1 || header.version > MODEL_IMAGE_VERSION) {
+        DEBUG_ERROR("Model image version %u, expected 1..%u", header.version, MODEL_IMAGE_VERSION);
+        return ESP_ERR_INVALID_VERSION;
+    }
+    size_t fixed = header.version >= 2 ? sizeof(header) : MODEL_IMAGE_V1_HEADER_BYTES;
+    if (size < fixed) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(&header, image, fixed);
+    if (header.header_size < fixed || header.header_size % MODEL_IMAGE_ALIGN != 0 ||
+        header.payload_size == 0 || header.payload_size > size - header.header_size) {
+        DEBUG_ERROR("Model image header inconsistent: %u + %lu bytes in %zu",
+                    header.header_size, (unsigned long)header.payload_size, size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    const uint8_t* data = (const uint8_t*)image + header.header_size;
+    uint32_t crc = model_crc32(0, data, header.payload_size);
+    if (crc != header.payload_crc32) {
+        DEBUG_ERROR("Model image CRC mismatch: %08lx, expected %08lx",
+                    (unsigned long)crc, (unsigned long)header.payload_crc32);
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    blob->data = data;
+    blob->size = header.payload_size;
+    blob->has_meta = false;
+    model_meta_default(&blob->meta);
+    if (header.version < 2 || header.meta_size == 0) {
+        return ESP_OK;
+    }
+
+    size_t offset = model_image_meta_offset(&header);
+    if (header.meta_size != sizeof(model_meta_t) || offset > size || header.meta_size > size - offset) {
+        DEBUG_ERROR("Model metadata does not fit: %lu bytes at %zu in %zu",
+                    (unsigned long)header.meta_size, offset, size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    const uint8_t* meta = (const uint8_t*)image + offset;
+    crc = model_crc32(0, meta, header.meta_size);
+    if (crc != header.meta_crc32) {
+        DEBUG_ERROR("Model metadata CRC mismatch: %08lx, expected %08lx",
+                    (unsigned long)crc, (unsigned long)header.meta_crc32);
+        return ESP_ERR_INVALID_CRC;
+    }
+    memcpy(&blob->meta, meta, header.meta_size);
+    esp_err_t ret = model_meta_check(&blob->meta);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    blob->has_meta = true;
+    return ESP_OK;
+}
+
+esp_err_t model_store_open(const char* location, model_blob_t* blob) {
+    if (location == NULL || blob == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(blob, 0, sizeof(*blob));
+
+#ifdef ESP_PLATFORM
+    const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           (esp_partition_subtype_t)MODEL_PARTITION_SUBTYPE,
+                                                           location);
+    if (part == NULL) {
+        DEBUG_WARN("No model partition '%s'", location);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const void* map;
+    esp_partition_mmap_handle_t handle;
+    esp_err_t ret = esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &map, &handle);
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Failed to map model partition: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = model_image_validate(map, part->size, blob);
+    if (ret != ESP_OK) {
+        esp_partition_munmap(handle);
+        return ret;
+    }
+    blob->source = MODEL_SOURCE_PARTITION;
+    blob->map = map;
+    blob->map_size = part->size;
+    blob->handle = (uint32_t)handle;
+#else
+    int fd = open(location, O_RDONLY);
+    if (fd < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return ESP_FAIL;
+    }
+
+    esp_err_t ret = model_image_validate(map, (size_t)st.st_size, blob);
+    if (ret != ESP_OK) {
+        munmap(map, (size_t)st.st_size);
+        return ret;
+    }
+    blob->source = MODEL_SOURCE_FILE;
+    blob->map = map;
+    blob->map_size = (size_t)st.st_size;
+#endif
+
+    return ESP_OK;
+}
+
+void model_store_close(model_blob_t* blob) {
+    if (blob == NULL || blob->map == NULL) {
+        return;
+    }
+#ifdef ESP_PLATFORM
+    esp_partition_munmap((esp_partition_mmap_handle_t)blob->handle);
+#else
+    munmap((void*)blob->map, blob->map_size);
+#endif
+    memset(blob, 0, sizeof(*blob));
+}
+
+const char* model_source_name(model_source_t source) {
+    switch (source) {
+        case MODEL_SOURCE_PARTITION: return "flash partition";
+        case MODEL_SOURCE_FILE:      return "file";
+        case MODEL_SOURCE_EMBEDDED:  return "built-in array";
+        default:                     return "none";
+    }
+}
@@ -1,7 +1,88 @@
 #include "mpu6050_driver.h"
+#include "spsc_ring.h"
+#include "esp_attr.h"
 
 // static const char* TAG = "MPU6050";
 
+// All bus traffic comes from init and then the sensor task only, so a single
+// statically allocated command link is reused for every transaction
+static uint8_t i2c_link_buffer[I2C_LINK_RECOMMENDED_SIZE(2)] __attribute__((aligned(4)));
+
+// Data registers of the last polled sample
+static uint8_t last_raw[14];
+
+// Raw FIFO burst, sized for the whole FIFO
+static uint8_t fifo_raw[MPU6050_FIFO_MAX_SAMPLES * MPU6050_FIFO_SAMPLE_BYTES];
+static float fifo_temperature = 0.0f;
+static uint32_t fifo_overflows = 0;
+static bool fifo_enabled = false;
+static bool fifo_reset_pending = false;
+
+// DATA_RDY interrupt: the ISR queues one timestamp per sample
+static spsc_ring_t isr_timestamps;
+static uint64_t isr_timestamp_storage[MPU6050_INT_TIMESTAMPS];
+static TaskHandle_t int_task = NULL;
+static uint32_t int_samples_per_wake = 1;
+static uint32_t int_pending = 0;
+static volatile bool int_active = false;
+// Stamps still to come for samples already delivered without one: the ISR
+// had not pushed them yet when the sample was read
+static uint32_t stale_stamps = 0;
+// Stamps taken before the last FIFO reset completed belong to samples that
+// never reached the FIFO
+static uint64_t stamps_since = 0;
+
+// Written by the ISR in interrupt mode; the 64-bit last_timestamp cannot be
+// copied atomically, so readers take the lock
+static portMUX_TYPE jitter_lock = portMUX_INITIALIZER_UNLOCKED;
+static mpu6050_jitter_t jitter = {0};
+static const uint32_t jitter_edges_us[MPU6050_JITTER_BINS - 1] = {50, 100, 250, 500, 1000, 2000, 5000};
+
+static void jitter_record(uint64_t timestamp) {
+    if (jitter.last_timestamp != 0) {
+        int64_t deviation = (int64_t)(timestamp - jitter.last_timestamp) - 1000000 / SAMPLE_RATE_HZ;
+        uint32_t dev_us = (uint32_t)(deviation < 0 ? -deviation : deviation);
+        int bin = 0;
+        while (bin < MPU6050_JITTER_BINS - 1 && dev_us >= jitter_edges_us[bin]) {
+            bin++;
+        }
+        jitter.bins[bin]++;
+        jitter.intervals++;
+        if (dev_us > jitter.max_us) {
+            jitter.max_us = dev_us;
+        }
+    }
+    jitter.last_timestamp = timestamp;
+}
+
+// Pops up to count of the oldest ISR timestamps
+static uint32_t drop_stamps(uint32_t count) {
+    uint64_t timestamp;
+    uint32_t dropped = 0;
+    while (dropped < count && spsc_ring_pop(&isr_timestamps, &timestamp)) {
+        dropped++;
+    }
+    return dropped;
+}
+
+static void IRAM_ATTR mpu6050_isr(void* arg) {
+    // Timestamp as close to the sensor's sample clock as possible
+    uint64_t now = esp_timer_get_time();
+    spsc_ring_push(&isr_timestamps, &now);
+    portENTER_CRITICAL_ISR(&jitter_lock);
+    jitter_record(now);
+    portEXIT_CRITICAL_ISR(&jitter_lock);
+    
+    if (++int_pending >= int_samples_per_wake) {
+        int_pending = 0;
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(int_task, &woken);
+        if (woken == pdTRUE) {
+            portYIELD_FROM_ISR();
+        }
+    }
+}
+
 esp_err_t mpu6050_i2c_init(void) {
     i2c_config_t conf = {
         .mode = I2C_MODE_MASTER,
@@ -28,52 +109,125 @@ esp_err_t mpu6050_i2c_init(void) {
     return ESP_OK;
 }
 
-esp_err_t mpu6050_i2c_read_byte(uint8_t reg, uint8_t* data) {
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+static i2c_cmd_handle_t i2c_cmd_begin(void) {
+    return i2c_cmd_link_create_static(i2c_link_buffer, sizeof(i2c_link_buffer));
+}
+
+static esp_err_t i2c_cmd_finish(i2c_cmd_handle_t cmd) {
+    esp_err_t ret = i2c_master_cmd_begin(MPU6050_I2C_PORT, cmd, pdMS_TO_TICKS(100));
+    i2c_cmd_link_delete_static(cmd);
+    return ret;
+}
+
+// Default transport: the IDF I2C master
+static esp_err_t i2c_transport_init(void* ctx) {
+    return mpu6050_i2c_init();
+}
+
+static esp_err_t i2c_transport_read(void* ctx, uint8_t reg, uint8_t* data, size_t len) {
+    i2c_cmd_handle_t cmd = i2c_cmd_begin();
+    if (cmd == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
     i2c_master_start(cmd);
     i2c_master_write_byte(cmd, (MPU6050_I2C_ADDR << 1) | I2C_MASTER_WRITE, true);
     i2c_master_write_byte(cmd, reg, true);
     i2c_master_start(cmd);
     i2c_master_write_byte(cmd, (MPU6050_I2C_ADDR << 1) | I2C_MASTER_READ, true);
-    i2c_master_read_byte(cmd, data, I2C_MASTER_NACK);
+    i2c_master_read(cmd, data, len, I2C_MASTER_LAST_NACK);
     i2c_master_stop(cmd);
     
-    esp_err_t ret = i2c_master_cmd_begin(MPU6050_I2C_PORT, cmd, pdMS_TO_TICKS(100));
-    i2c_cmd_link_delete(cmd);
-    
-    return ret;
+    return i2c_cmd_finish(cmd);
 }
 
-esp_err_t mpu6050_i2c_write_byte(uint8_t reg, uint8_t data) {
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+static esp_err_t i2c_transport_write(void* ctx, uint8_t reg, const uint8_t* data, size_t len) {
+    i2c_cmd_handle_t cmd = i2c_cmd_begin();
+    if (cmd == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
     i2c_master_start(cmd);
     i2c_master_write_byte(cmd, (MPU6050_I2C_ADDR << 1) | I2C_MASTER_WRITE, true);
     i2c_master_write_byte(cmd, reg, true);
-    i2c_master_write_byte(cmd, data, true);
+    i2c_master_write(cmd, data, len, true);
     i2c_master_stop(cmd);
     
-    esp_err_t ret = i2c_master_cmd_begin(MPU6050_I2C_PORT, cmd, pdMS_TO_TICKS(100));
-    i2c_cmd_link_delete(cmd);
-    
-    return ret;
+    return i2c_cmd_finish(cmd);
+}
+
+static const mpu6050_transport_t i2c_transport = {
+    .init = i2c_transport_init,
+    .read = i2c_transport_read,
+    .write = i2c_transport_write,
+};
+
+static mpu6050_transport_t custom_transport;
+static const mpu6050_transport_t* transport = &i2c_transport;
+static mpu6050_bus_stats_t bus_stats = {0};
+
+void mpu6050_set_transport(const mpu6050_transport_t* t) {
+    if (t == NULL) {
+        transport = &i2c_transport;
+        return;
+    }
+    custom_transport = *t;
+    transport = &custom_transport;
+}
+
+void mpu6050_get_bus_stats(mpu6050_bus_stats_t* stats) {
+    if (stats != NULL) {
+        *stats = bus_stats;
+    }
+}
+
+// A NACK (ESP_FAIL) or a busy bus (ESP_ERR_TIMEOUT) is usually transient:
+// try the transfer again before giving up. Not for FIFO_R_W: a transfer that
+// failed part way has already drained bytes from the FIFO, and a second
+// attempt would read from the middle of a sample
+static bool bus_retryable(uint8_t reg, esp_err_t ret, int attempt) {
+    if (ret == ESP_OK || reg == MPU6050_REG_FIFO_R_W || attempt >= MPU6050_I2C_RETRIES) {
+        return false;
+    }
+    return ret == ESP_FAIL || ret == ESP_ERR_TIMEOUT;
 }
 
 esp_err_t mpu6050_i2c_read_bytes(uint8_t reg, uint8_t* data, size_t len) {
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (MPU6050_I2C_ADDR << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(cmd, reg, true);
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (MPU6050_I2C_ADDR << 1) | I2C_MASTER_READ, true);
-    i2c_master_read(cmd, data, len, I2C_MASTER_LAST_NACK);
-    i2c_master_stop(cmd);
+    esp_err_t ret;
+    int attempt = 0;
+    do {
+        if (attempt > 0) {
+            bus_stats.retries++;
+        }
+        bus_stats.transactions++;
+        ret = transport->read(transport->ctx, reg, data, len);
+    } while (bus_retryable(reg, ret, attempt++));
     
-    esp_err_t ret = i2c_master_cmd_begin(MPU6050_I2C_PORT, cmd, pdMS_TO_TICKS(100));
-    i2c_cmd_link_delete(cmd);
+    if (ret != ESP_OK) {
+        bus_stats.errors++;
+    }
+    return ret;
+}
+
+esp_err_t mpu6050_i2c_write_byte(uint8_t reg, uint8_t data) {
+    esp_err_t ret;
+    int attempt = 0;
+    do {
+        if (attempt > 0) {
+            bus_stats.retries++;
+        }
+        bus_stats.transactions++;
+        ret = transport->write(transport->ctx, reg, &data, 1);
+    } while (bus_retryable(reg, ret, attempt++));
     
+    if (ret != ESP_OK) {
+        bus_stats.errors++;
+    }
     return ret;
 }
 
+esp_err_t mpu6050_i2c_read_byte(uint8_t reg, uint8_t* data) {
+    return mpu6050_i2c_read_bytes(reg, data, 1);
+}
+
 bool mpu6050_is_connected(void) {
     uint8_t who_am_i;
     esp_err_t ret = mpu6050_i2c_read_byte(MPU6050_REG_WHO_AM_I, &who_am_i);
@@ -162,6 +316,23 @@ esp_err_t mpu6050_configure(void) {
         return ret;
     }
     
+    // Let the sensor pace sampling: 1 kHz / (1 + div) = SAMPLE_RATE_HZ, so
+    // DATA_RDY and the FIFO run at the model's rate
+    ret = mpu6050_i2c_write_byte(MPU6050_REG_SMPLRT_DIV,
+                                 MPU6050_GYRO_RATE_DLPF_HZ / SAMPLE_RATE_HZ - 1);
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Failed to set sample rate divider: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
+    // Without the interrupt enabled INT_STATUS never flags new data, and
+    // polled reads go by that flag; the pin only matters once an ISR is in
+    ret = mpu6050_i2c_write_byte(MPU6050_REG_INT_ENABLE, MPU6050_INT_DATA_RDY_EN);
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Failed to enable data-ready status: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
     DEBUG_PRINT("MPU6050 configured successfully");
     return ESP_OK;
 }
@@ -169,8 +340,8 @@ esp_err_t mpu6050_configure(void) {
 esp_err_t mpu6050_init(void) {
     DEBUG_PRINT("Initializing MPU6050...");
     
-    // Initialize I2C
-    esp_err_t ret = mpu6050_i2c_init();
+    // Initialize the bus (the I2C master unless another transport is set)
+    esp_err_t ret = transport->init != NULL ? transport->init(transport->ctx) : ESP_OK;
     if (ret != ESP_OK) {
         DEBUG_ERROR("Failed to initialize I2C: %s", esp_err_to_name(ret));
         return ret;
@@ -203,46 +374,439 @@ esp_err_t mpu6050_init(void) {
         return ret;
     }
     
+#if MPU6050_FIFO_MODE
+    ret = mpu6050_fifo_enable();
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Failed to enable MPU6050 FIFO: %s", esp_err_to_name(ret));
+        return ret;
+    }
+#endif
+    
     DEBUG_PRINT("MPU6050 initialized successfully");
     return ESP_OK;
 }
 
+// Accel and gyro registers are 16-bit big endian, ±2g and ±250°/s ranges
+static void convert_motion(const uint8_t* accel, const uint8_t* gyro, mpu6050_data_t* data) {
+    for (int i = 0; i < 3; i++) {
+        data->raw.accel[i] = (int16_t)((accel[2 * i] << 8) | accel[2 * i + 1]);
+        data->raw.gyro[i] = (int16_t)((gyro[2 * i] << 8) | gyro[2 * i + 1]);
+    }
+    
+    data->accel_x = data->raw.accel[0] / MPU6050_ACCEL_LSB_PER_G;
+    data->accel_y = data->raw.accel[1] / MPU6050_ACCEL_LSB_PER_G;
+    data->accel_z = data->raw.accel[2] / MPU6050_ACCEL_LSB_PER_G;
+    data->gyro_x = data->raw.gyro[0] / MPU6050_GYRO_LSB_PER_DPS;
+    data->gyro_y = data->raw.gyro[1] / MPU6050_GYRO_LSB_PER_DPS;
+    data->gyro_z = data->raw.gyro[2] / MPU6050_GYRO_LSB_PER_DPS;
+}
+
 esp_err_t mpu6050_read_data(mpu6050_data_t* data) {
     if (data == NULL) {
         DEBUG_ERROR("Invalid data pointer");
         return ESP_ERR_INVALID_ARG;
     }
     
-    uint8_t raw_data[14];
-    esp_err_t ret = mpu6050_i2c_read_bytes(MPU6050_REG_ACCEL_XOUT_H, raw_data, 14);
+    // INT_STATUS comes right before the data registers: its DATA_RDY bit
+    // tells whether they changed since the last read, so a read that comes
+    // early does not hand out the same sample twice. Reading the bit clears
+    // it, so after a retry a clear bit may be the failed attempt's doing;
+    // then only a sample equal to the last one is a repeat.
+    uint8_t raw_data[15];
+    uint32_t retries = bus_stats.retries;
+    esp_err_t ret = mpu6050_i2c_read_bytes(MPU6050_REG_INT_STATUS, raw_data, 15);
     if (ret != ESP_OK) {
         DEBUG_ERROR("Failed to read sensor data: %s", esp_err_to_name(ret));
         return ret;
     }
+    bool fresh = (raw_data[0] & MPU6050_INT_DATA_RDY) != 0;
+    if (!fresh && bus_stats.retries != retries) {
+        fresh = memcmp(&raw_data[1], last_raw, sizeof(last_raw)) != 0;
+    }
+    if (!fresh) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    memcpy(last_raw, &raw_data[1], sizeof(last_raw));
+    
+    // Convert raw data to physical units
+    convert_motion(&raw_data[1], &raw_data[9], data);
+    int16_t temp = (raw_data[7] << 8) | raw_data[8];
+    data->temperature = temp / 340.0f + 36.53f;  // Temperature conversion
     
-    // Convert raw data to float values
-    // Accelerometer data (16-bit, ±2g range)
-    int16_t accel_x = (raw_data[0] << 8) | raw_data[1];
-    int16_t accel_y = (raw_data[2] << 8) | raw_data[3];
-    int16_t accel_z = (raw_data[4] << 8) | raw_data[5];
+    if (int_active) {
+        // The data registers hold the newest sample: use the newest ISR timestamp
+        uint64_t timestamp;
+        data->timestamp = esp_timer_get_time();
+        while (spsc_ring_pop(&isr_timestamps, &timestamp)) {
+            data->timestamp = timestamp;
+        }
+    } else {
+        data->timestamp = esp_timer_get_time();
+        portENTER_CRITICAL(&jitter_lock);
+        jitter_record(data->timestamp);
+        portEXIT_CRITICAL(&jitter_lock);
+    }
+    
+    return ESP_OK;
+}
+
+esp_err_t mpu6050_fifo_reset(void) {
+    // The queued stamps belong to samples about to be discarded
+    if (int_active) {
+        drop_stamps(spsc_ring_count(&isr_timestamps));
+    }
+    stale_stamps = 0;
     
-    // Temperature data
-    int16_t temp = (raw_data[6] << 8) | raw_data[7];
+    // Resetting clears FIFO_EN in USER_CTRL, so re-enable afterwards
+    esp_err_t ret = mpu6050_i2c_write_byte(MPU6050_REG_USER_CTRL, MPU6050_USER_CTRL_FIFO_RST);
+    if (ret == ESP_OK) {
+        ret = mpu6050_i2c_write_byte(MPU6050_REG_USER_CTRL, MPU6050_USER_CTRL_FIFO_EN);
+    }
+    // Samples taken before FIFO_EN lands are not in the FIFO
+    stamps_since = esp_timer_get_time();
+    // Until both writes land the FIFO may be stopped: the next read tries again
+    fifo_reset_pending = ret != ESP_OK;
+    return ret;
+}
+
+esp_err_t mpu6050_fifo_enable(void) {
+    DEBUG_PRINT("Enabling MPU6050 FIFO...");
     
-    // Gyroscope data (16-bit, ±250°/s range)
-    int16_t gyro_x = (raw_data[8] << 8) | raw_data[9];
-    int16_t gyro_y = (raw_data[10] << 8) | raw_data[11];
-    int16_t gyro_z = (raw_data[12] << 8) | raw_data[13];
+    // Sampled at the rate mpu6050_configure() set
+    esp_err_t ret = mpu6050_i2c_write_byte(MPU6050_REG_FIFO_EN, MPU6050_FIFO_EN_ACCEL_GYRO);
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Failed to select FIFO sources: %s", esp_err_to_name(ret));
+        return ret;
+    }
     
-    // Convert to physical units
-    data->accel_x = accel_x / 16384.0f;  // ±2g range
-    data->accel_y = accel_y / 16384.0f;
-    data->accel_z = accel_z / 16384.0f;
-    data->temperature = temp / 340.0f + 36.53f;  // Temperature conversion
-    data->gyro_x = gyro_x / 131.0f;  // ±250°/s range
-    data->gyro_y = gyro_y / 131.0f;
-    data->gyro_z = gyro_z / 131.0f;
-    data->timestamp = esp_timer_get_time();
+    ret = mpu6050_fifo_reset();
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Failed to reset FIFO: %s", esp_err_to_name(ret));
+        return ret;
+    }
     
+    fifo_enabled = true;
+    DEBUG_PRINT("MPU6050 FIFO enabled (%d Hz, %d samples per burst)",
+               SAMPLE_RATE_HZ, MPU6050_FIFO_BURST_SAMPLES);
+    return ESP_OK;
+}
+
+esp_err_t mpu6050_fifo_disable(void) {
+    fifo_enabled = false;
+    fifo_reset_pending = false;
+    esp_err_t ret = mpu6050_i2c_write_byte(MPU6050_REG_FIFO_EN, 0x00);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return mpu6050_i2c_write_byte(MPU6050_REG_USER_CTRL, 0x00);
+}
+
+static esp_err_t fifo_count_bytes(uint16_t* bytes) {
+    uint8_t raw[2];
+    esp_err_t ret = mpu6050_i2c_read_bytes(MPU6050_REG_FIFO_COUNTH, raw, 2);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    *bytes = (uint16_t)((raw[0] << 8) | raw[1]);
     return ESP_OK;
-}
\ No newline at end of file
+}
+
+esp_err_t mpu6050_fifo_count(uint16_t* samples) {
+    if (samples == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    uint16_t bytes;
+    esp_err_t ret = fifo_count_bytes(&bytes);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    *samples = bytes / MPU6050_FIFO_SAMPLE_BYTES;
+    return ESP_OK;
+}
+
+// After a FIFO_R_W transfer failed part way, skip what is left of the sample
+// it broke off in. Whole samples enter the FIFO, so the count modulo the
+// sample size is that remainder; the samples behind it stay for the next
+// read. The skip itself can fail part way, hence the loop. Resets the FIFO
+// if the boundaries cannot be found again, and returns false then.
+static bool fifo_resync(void) {
+    uint8_t skip[MPU6050_FIFO_SAMPLE_BYTES];
+    for (int attempt = 0; attempt <= MPU6050_I2C_RETRIES; attempt++) {
+        uint16_t bytes;
+        if (fifo_count_bytes(&bytes) != ESP_OK || bytes > MPU6050_FIFO_MAX_SAMPLES * MPU6050_FIFO_SAMPLE_BYTES) {
+            break;
+        }
+        size_t partial = bytes % MPU6050_FIFO_SAMPLE_BYTES;
+        if (partial == 0) {
+            return true;
+        }
+        mpu6050_i2c_read_bytes(MPU6050_REG_FIFO_R_W, skip, partial);
+    }
+    DEBUG_WARN("Lost the FIFO sample boundaries, resetting");
+    mpu6050_fifo_reset();
+    return false;
+}
+
+// The samples up to the first failed transfer, timed from the count read
+// at the start. resumable tells whether the FIFO still holds the samples
+// after a failure.
+static esp_err_t read_fifo_segment(mpu6050_data_t* samples, size_t max_samples, size_t* count, bool* resumable) {
+    *count = 0;
+    *resumable = true;
+    
+    // Every stamp counted before FIFO_COUNT is read belongs to a sample that
+    // is in the count, unless that sample was already delivered or lost. A
+    // sample that comes in during the read may or may not be counted, so
+    // read again then; after a failed transfer that can be at any time.
+    uint32_t stamped;
+    uint16_t bytes;
+    esp_err_t ret;
+    for (int attempt = 0; ; attempt++) {
+        stamped = int_active ? spsc_ring_count(&isr_timestamps) : 0;
+        ret = fifo_count_bytes(&bytes);
+        if (ret != ESP_OK || !int_active || spsc_ring_count(&isr_timestamps) == stamped ||
+            attempt == MPU6050_I2C_RETRIES) {
+            break;
+        }
+    }
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Failed to read FIFO count: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
+    // 1024 is not a multiple of 12: once the FIFO overflows the sample
+    // boundaries are lost, so start over
+    if (bytes > MPU6050_FIFO_MAX_SAMPLES * MPU6050_FIFO_SAMPLE_BYTES) {
+        fifo_overflows++;
+        DEBUG_WARN("MPU6050 FIFO overflow (%lu), resetting", (unsigned long)fifo_overflows);
+        mpu6050_fifo_reset();
+        *resumable = false;
+        return ESP_ERR_INVALID_SIZE;
+    }
+    
+    size_t available = bytes / MPU6050_FIFO_SAMPLE_BYTES;
+    size_t n = available < max_samples ? available : max_samples;
+    if (n == 0) {
+        return ESP_OK;
+    }
+    
+    // Drop the stamps that are provably stale: those of samples delivered
+    // before their interrupt came in, then any beyond the count, which
+    // belong to samples the FIFO no longer holds. The rest line up with the
+    // oldest FIFO samples.
+    uint32_t dropped = drop_stamps(stale_stamps < stamped ? stale_stamps : stamped);
+    stale_stamps -= dropped;
+    stamped -= dropped;
+    if (stamped > available) {
+        drop_stamps(stamped - (uint32_t)available);
+    }
+    
+    // Whole-sample chunks: a transfer that fails part way loses its own
+    // chunk, the ones before it are delivered and the ones after it wait
+    // in the FIFO. The lost samples' stamps are then in excess and dropped
+    // by the next segment.
+    size_t read = 0;
+    while (read < n) {
+        size_t chunk = n - read < MPU6050_FIFO_CHUNK_SAMPLES ? n - read : MPU6050_FIFO_CHUNK_SAMPLES;
+        ret = mpu6050_i2c_read_bytes(MPU6050_REG_FIFO_R_W, &fifo_raw[read * MPU6050_FIFO_SAMPLE_BYTES],
+                                     chunk * MPU6050_FIFO_SAMPLE_BYTES);
+        if (ret != ESP_OK) {
+            DEBUG_ERROR("Failed to read FIFO: %s, %lu of %lu samples read", esp_err_to_name(ret),
+                        (unsigned long)read, (unsigned long)n);
+            break;
+        }
+        read += chunk;
+    }
+    n = read;
+    if (n == 0) {
+        *resumable = fifo_resync();
+        return ret;
+    }
+    
+    // Temperature is not in the FIFO; refresh it once per burst
+    uint8_t temp_raw[2];
+    if (mpu6050_i2c_read_bytes(MPU6050_REG_TEMP_OUT_H, temp_raw, 2) == ESP_OK) {
+        int16_t temp = (temp_raw[0] << 8) | temp_raw[1];
+        fifo_temperature = temp / 340.0f + 36.53f;
+    }
+    
+    // Samples are evenly spaced; the newest queued one was taken about now
+    uint64_t timestamp;
+    uint64_t now = esp_timer_get_time();
+    uint64_t period_us = 1000000 / SAMPLE_RATE_HZ;
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t* raw = &fifo_raw[i * MPU6050_FIFO_SAMPLE_BYTES];
+        convert_motion(&raw[0], &raw[6], &samples[i]);
+        samples[i].temperature = fifo_temperature;
+        samples[i].timestamp = now - (uint64_t)(available - 1 - i) * period_us;
+        
+        // Stamps queue in sample order; a sample that came in after the
+        // snapshot has had its interrupt by the time it is read
+        bool stamp = false;
+        while (int_active && !stamp && spsc_ring_pop(&isr_timestamps, &timestamp)) {
+            if (stale_stamps > 0) {
+                stale_stamps--;
+                continue;
+            }
+            stamp = timestamp >= stamps_since;
+        }
+        if (stamp) {
+            samples[i].timestamp = timestamp;
+        } else if (int_active) {
+            stale_stamps++;
+        } else {
+            portENTER_CRITICAL(&jitter_lock);
+            jitter_record(samples[i].timestamp);
+            portEXIT_CRITICAL(&jitter_lock);
+        }
+    }
+    
+    // Only now: a reset would drop the stamps of the samples just delivered
+    if (ret != ESP_OK) {
+        *resumable = fifo_resync();
+    }
+    
+    *count = n;
+    return ret;
+}
+
+esp_err_t mpu6050_read_fifo(mpu6050_data_t* samples, size_t max_samples, size_t* count) {
+    if (samples == NULL || count == NULL) {
+        DEBUG_ERROR("Invalid FIFO read arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+    *count = 0;
+    
+    if (fifo_reset_pending) {
+        esp_err_t ret = mpu6050_fifo_reset();
+        if (ret != ESP_OK) {
+            DEBUG_ERROR("Failed to reset FIFO: %s", esp_err_to_name(ret));
+            return ret;
+        }
+    }
+    
+    // The samples behind a failed transfer are still in the FIFO: read on
+    // past the gap while that gets anywhere, and report the failure
+    esp_err_t result = ESP_OK;
+    int stuck = 0;
+    while (*count < max_samples && stuck <= MPU6050_I2C_RETRIES) {
+        size_t n;
+        bool resumable;
+        esp_err_t ret = read_fifo_segment(&samples[*count], max_samples - *count, &n, &resumable);
+        *count += n;
+        if (ret == ESP_OK) {
+            break;
+        }
+        result = ret;
+        if (!resumable) {
+            break;
+        }
+        stuck = n > 0 ? 0 : stuck + 1;
+    }
+    return result;
+}
+
+esp_err_t mpu6050_int_enable(TaskHandle_t task, uint32_t samples_per_wake) {
+    if (task == NULL || samples_per_wake == 0) {
+        DEBUG_ERROR("Invalid interrupt arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    DEBUG_PRINT("Enabling MPU6050 data-ready interrupt on GPIO %d...", MPU6050_INT_PIN);
+    
+    esp_err_t ret = spsc_ring_init(&isr_timestamps, isr_timestamp_storage,
+                                   sizeof(uint64_t), MPU6050_INT_TIMESTAMPS);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    int_task = task;
+    int_samples_per_wake = samples_per_wake;
+    int_pending = 0;
+    stale_stamps = 0;
+    
+    gpio_config_t io_conf = {
+        .pin_bit_mask = 1ULL << MPU6050_INT_PIN,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_ENABLE,
+        .intr_type = GPIO_INTR_POSEDGE,
+    };
+    ret = gpio_config(&io_conf);
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Failed to configure INT pin: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
+    // Another driver may already have installed the shared ISR service
+    ret = gpio_install_isr_service(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        DEBUG_ERROR("Failed to install GPIO ISR service: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
+    ret = gpio_isr_handler_add(MPU6050_INT_PIN, mpu6050_isr, NULL);
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Failed to add INT handler: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
+    ret = mpu6050_i2c_write_byte(MPU6050_REG_INT_PIN_CFG, MPU6050_INT_PIN_CFG_RD_CLEAR);
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Failed to configure INT pin mode: %s", esp_err_to_name(ret));
+        gpio_isr_handler_remove(MPU6050_INT_PIN);
+        return ret;
+    }
+    
+    int_active = true;
+    
+    ret = mpu6050_i2c_write_byte(MPU6050_REG_INT_ENABLE, MPU6050_INT_DATA_RDY_EN);
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Failed to enable data-ready interrupt: %s", esp_err_to_name(ret));
+        int_active = false;
+        gpio_isr_handler_remove(MPU6050_INT_PIN);
+        return ret;
+    }
+    
+    // Start the FIFO and the timestamp queue from the same sample, once
+    // every new sample is stamped: a sample without a stamp would shift
+    // every later one. Stamps of samples the reset discards are older than
+    // it and skipped.
+    if (fifo_enabled) {
+        mpu6050_fifo_reset();
+    }
+    
+    DEBUG_PRINT("MPU6050 data-ready interrupt enabled (wake every %lu samples)",
+               (unsigned long)samples_per_wake);
+    return ESP_OK;
+}
+
+esp_err_t mpu6050_int_disable(void) {
+    // Keep the status bit polled reads go by
+    esp_err_t ret = mpu6050_i2c_write_byte(MPU6050_REG_INT_ENABLE, MPU6050_INT_DATA_RDY_EN);
+    gpio_isr_handler_remove(MPU6050_INT_PIN);
+    int_active = false;
+    return ret;
+}
+
+void mpu6050_get_jitter(mpu6050_jitter_t* out) {
+    if (out != NULL) {
+        portENTER_CRITICAL(&jitter_lock);
+        *out = jitter;
+        portEXIT_CRITICAL(&jitter_lock);
+    }
+}
+
+void mpu6050_print_jitter(void) {
+    mpu6050_jitter_t j;
+    mpu6050_get_jitter(&j);
+    
+    DEBUG_PRINT("Sample Jitter (%s timestamps, %lu intervals, max %lu us):",
+               int_active ? "ISR" : "task", (unsigned long)j.intervals, (unsigned long)j.max_us);
+    DEBUG_PRINT("  <50us %lu | <100us %lu | <250us %lu | <500us %lu",
+               (unsigned long)j.bins[0], (unsigned long)j.bins[1],
+               (unsigned long)j.bins[2], (unsigned long)j.bins[3]);
+    DEBUG_PRINT("  <1ms %lu | <2ms %lu | <5ms %lu | >=5ms %lu",
+               (unsigned long)j.bins[4], (unsigned long)j.bins[5],
+               (unsigned long)j.bins[6], (unsigned long)j.bins[7]);
+}
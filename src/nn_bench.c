@@ -0,0 +1,445 @@
+#include "nn_bench.h"
+#include "nn_engine.h"
+#include "nn_static.h"
+#include "config.h"
+
+#include <ctype.h>
+
+#ifdef ESP_PLATFORM
+#include <esp_cpu.h>
+#else
+#include <time.h>
+#endif
+
+// Per-layer latency of the engine kernels on the model's own shapes
+
+#ifdef ESP_PLATFORM
+#define CLOCK_NOW() ((uint32_t)esp_cpu_get_cycle_count())
+#define CLOCK_UNIT "cycles"
+#else
+static uint32_t clock_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+#define CLOCK_NOW() clock_now_ns()
+#define CLOCK_UNIT "ns"
+#endif
+
+#define BENCH_CSV_HEADER "case,shape,unit,iterations,min,p50,p90,p99,max,mean"
+#define BENCH_LINE_MAX 160
+
+// Activations of one window, kept between cases so every kernel runs on
+// what the previous layer really produced
+typedef struct {
+    const nn_model_t* model;
+    int8_t* input;
+    int8_t* conv_out;                       // reference conv blocks only
+    int8_t* pool_out[NN_CONV_BLOCKS];
+    int8_t* xproj;
+    int8_t* h_seq[NN_LSTM_LAYERS];
+    int8_t* scratch;
+    int8_t* cell;
+    int8_t* h0;
+    nn_head_buffers_t head;
+    int8_t* output;
+    nn_engine_t engine;
+    uint8_t* engine_arena;
+    nn_static_engine_t static_engine;
+    uint8_t* static_arena;
+    bool use_static;
+} bench_ctx_t;
+
+typedef void (*bench_fn_t)(bench_ctx_t* ctx, int index);
+
+static size_t bench_align(size_t n) {
+    return (n + NN_ARENA_ALIGNMENT - 1) & ~(size_t)(NN_ARENA_ALIGNMENT - 1);
+}
+
+static void* bench_alloc(size_t size) {
+    size = bench_align(size);
+#ifdef ESP_PLATFORM
+    return heap_caps_aligned_alloc(NN_ARENA_ALIGNMENT, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+#else
+    return aligned_alloc(NN_ARENA_ALIGNMENT, size);
+#endif
+}
+
+static void bench_free(void* ptr) {
+#ifdef ESP_PLATFORM
+    heap_caps_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+// Lays the activation buffers out from base, or only sizes them when base is NULL
+static size_t layout(bench_ctx_t* ctx, uint8_t* base) {
+    const nn_model_t* model = ctx->model;
+    size_t offset = 0;
+#define PLACE(ptr, bytes) do { \
+        if (base != NULL) { (ptr) = (int8_t*)(base + offset); } \
+        offset += bench_align(bytes); \
+    } while (0)
+
+    PLACE(ctx->input, (size_t)model->seq_len * model->features);
+    size_t conv_out = 0;
+    for (int b = 0; b < NN_CONV_BLOCKS; b++) {
+        const nn_conv_block_t* block = &model->blocks[b];
+        size_t bytes = (size_t)block->in_len * block->conv.cout;
+        conv_out = bytes > conv_out ? bytes : conv_out;
+        PLACE(ctx->pool_out[b], (size_t)block->out_len * block->conv.cout);
+    }
+    if (!model->fuse_conv_blocks) {
+        PLACE(ctx->conv_out, conv_out);
+    }
+
+    int units = nn_lstm_max_units(model);
+    PLACE(ctx->xproj, (size_t)model->lstm[0].steps * NN_GATES * units);
+    for (int l = 0; l < NN_LSTM_LAYERS; l++) {
+        PLACE(ctx->h_seq[l], (size_t)model->lstm[l].steps * model->lstm[l].units);
+    }
+    PLACE(ctx->scratch, (size_t)NN_LSTM_SCRATCH_ROWS * units);
+    PLACE(ctx->cell, (size_t)units);
+    PLACE(ctx->h0, (size_t)units);
+    PLACE(ctx->output, (size_t)model->classes);
+
+    size_t head = nn_head_buffers_size(model);
+    if (base != NULL) {
+        nn_head_buffers_place(model, base + offset, &ctx->head);
+    }
+    offset += bench_align(head);
+#undef PLACE
+    return offset;
+}
+
+static void fill_input(int8_t* x, size_t n) {
+    uint32_t state = 12345;
+    for (size_t i = 0; i < n; i++) {
+        state = state * 1664525u + 1013904223u;
+        x[i] = (int8_t)(state >> 24);
+    }
+}
+
+static void bench_conv(bench_ctx_t* ctx, int b) {
+    const nn_conv_block_t* block = &ctx->model->blocks[b];
+    const int8_t* in = b == 0 ? ctx->input : ctx->pool_out[b - 1];
+    if (ctx->model->fuse_conv_blocks) {
+        nn_conv_bn_relu_pool_s8(&block->conv, &block->fold, in, block->in_len, ctx->pool_out[b]);
+        return;
+    }
+    nn_conv1d_s8(&block->conv, in, block->in_len, ctx->conv_out);
+    nn_conv_block_bn(block, ctx->conv_out, block->in_len * block->conv.cout);
+    nn_maxpool1d_s8(ctx->conv_out, block->in_len, block->conv.cout, block->pool, ctx->pool_out[b]);
+}
+
+// Same schedule as the engine: W_x * x_t for all steps, then the recurrence
+static void bench_lstm(bench_ctx_t* ctx, int l) {
+    const nn_lstm_layer_t* layer = &ctx->model->lstm[l];
+    const int8_t* x_seq = l == 0 ? ctx->pool_out[NN_CONV_BLOCKS - 1] : ctx->h_seq[l - 1];
+    const int u = layer->units;
+
+    nn_lstm_reset_state(layer, ctx->h0, ctx->cell);
+    nn_gemm_s8(&layer->input_gemm, x_seq, layer->steps, ctx->xproj);
+    for (int t = 0; t < layer->steps; t++) {
+        const int8_t* h_prev = t > 0 ? ctx->h_seq[l] + (size_t)(t - 1) * u : ctx->h0;
+        nn_lstm_step_projected(layer, ctx->xproj + (size_t)t * NN_GATES * u, h_prev, ctx->cell,
+                               ctx->scratch, ctx->h_seq[l] + (size_t)t * u);
+    }
+}
+
+static void bench_attention(bench_ctx_t* ctx, int unused) {
+    nn_run_attention(ctx->model, ctx->h_seq[NN_LSTM_LAYERS - 1], &ctx->head);
+}
+
+static void bench_dense(bench_ctx_t* ctx, int unused) {
+    nn_run_dense(ctx->model, &ctx->head, ctx->output);
+}
+
+static void bench_model(bench_ctx_t* ctx, int unused) {
+    nn_engine_invoke(&ctx->engine, ctx->input, ctx->output);
+}
+
+static void bench_model_static(bench_ctx_t* ctx, int unused) {
+    nn_static_invoke(&ctx->static_engine, ctx->input, ctx->output);
+}
+
+static int compare_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted samples
+static uint32_t percentile(const uint32_t* sorted, int n, int pct) {
+    int rank = (n * pct + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+static void run_case(bench_ctx_t* ctx, bench_fn_t fn, int index, const char* name, const char* shape,
+                     uint32_t* samples, int iterations, nn_bench_report_t* report) {
+    for (int i = 0; i < NN_BENCH_WARMUP; i++) {
+        fn(ctx, index);
+    }
+    uint64_t sum = 0;
+    for (int i = 0; i < iterations; i++) {
+        uint32_t start = CLOCK_NOW();
+        fn(ctx, index);
+        samples[i] = CLOCK_NOW() - start;
+        sum += samples[i];
+    }
+    qsort(samples, (size_t)iterations, sizeof(samples[0]), compare_u32);
+
+    nn_bench_result_t* r = &report->cases[report->count++];
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    snprintf(r->shape, sizeof(r->shape), "%s", shape);
+    r->iterations = (uint32_t)iterations;
+    r->min = samples[0];
+    r->p50 = percentile(samples, iterations, 50);
+    r->p90 = percentile(samples, iterations, 90);
+    r->p99 = percentile(samples, iterations, 99);
+    r->max = samples[iterations - 1];
+    r->mean = (uint32_t)(sum / (uint64_t)iterations);
+}
+
+esp_err_t nn_bench_run(const nn_model_t* model, int iterations, nn_bench_report_t* report) {
+    if (model == NULL || report == NULL || iterations <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(report, 0, sizeof(*report));
+    snprintf(report->unit, sizeof(report->unit), "%s", CLOCK_UNIT);
+
+    bench_ctx_t* ctx = calloc(1, sizeof(*ctx));
+    uint32_t* samples = malloc((size_t)iterations * sizeof(uint32_t));
+    if (ctx == NULL || samples == NULL) {
+        free(ctx);
+        free(samples);
+        return ESP_ERR_NO_MEM;
+    }
+    ctx->model = model;
+    ctx->use_static = nn_static_matches(model);
+
+    size_t activations = layout(ctx, NULL);
+    size_t engine_size = nn_engine_arena_size(model);
+    size_t static_size = ctx->use_static ? nn_static_arena_size() : 0;
+    uint8_t* base = bench_alloc(activations);
+    ctx->engine_arena = bench_alloc(engine_size);
+    ctx->static_arena = ctx->use_static ? bench_alloc(static_size) : NULL;
+
+    esp_err_t ret = ESP_ERR_NO_MEM;
+    if (base == NULL || ctx->engine_arena == NULL || (ctx->use_static && ctx->static_arena == NULL)) {
+        DEBUG_ERROR("Benchmark needs %zu + %zu + %zu bytes", activations, engine_size, static_size);
+        goto done;
+    }
+    layout(ctx, base);
+    fill_input(ctx->input, (size_t)model->seq_len * model->features);
+
+    ret = nn_engine_init(&ctx->engine, model, ctx->engine_arena, engine_size);
+    if (ret == ESP_OK && ctx->use_static) {
+        ret = nn_static_init(&ctx->static_engine, model, ctx->static_arena, static_size);
+    }
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Benchmark engine setup failed: %s", esp_err_to_name(ret));
+        goto done;
+    }
+
+    char shape[NN_BENCH_SHAPE_LEN];
+    char name[NN_BENCH_NAME_LEN];
+    for (int b = 0; b < NN_CONV_BLOCKS; b++) {
+        const nn_conv_block_t* block = &model->blocks[b];
+        snprintf(name, sizeof(name), "conv%d", b + 1);
+        snprintf(shape, sizeof(shape), "%dx%d->%d k%d pool%d", block->in_len, block->conv.cin,
+                 block->conv.cout, block->conv.kernel, block->pool);
+        run_case(ctx, bench_conv, b, name, shape, samples, iterations, report);
+    }
+    for (int l = 0; l < NN_LSTM_LAYERS; l++) {
+        const nn_lstm_layer_t* layer = &model->lstm[l];
+        snprintf(name, sizeof(name), "lstm%d", l + 1);
+        snprintf(shape, sizeof(shape), "%dx%d->%d", layer->steps, layer->input_size, layer->units);
+        run_case(ctx, bench_lstm, l, name, shape, samples, iterations, report);
+    }
+    snprintf(shape, sizeof(shape), "%dx%d %s", model->attention.steps, model->attention.units,
+             model->online_attention ? "online" : "two-pass");
+    run_case(ctx, bench_attention, 0, "attention", shape, samples, iterations, report);
+    snprintf(shape, sizeof(shape), "%d->%d->%d softmax", model->dense[0].in,
+             model->dense[0].out, model->dense[NN_DENSE_LAYERS - 1].out);
+    run_case(ctx, bench_dense, 0, "dense", shape, samples, iterations, report);
+
+    snprintf(shape, sizeof(shape), "%dx%d->%d", model->seq_len, model->features, model->classes);
+    run_case(ctx, bench_model, 0, "model", shape, samples, iterations, report);
+    if (ctx->use_static) {
+        run_case(ctx, bench_model_static, 0, "model_static", shape, samples, iterations, report);
+    }
+
+done:
+    bench_free(base);
+    bench_free(ctx->engine_arena);
+    bench_free(ctx->static_arena);
+    free(samples);
+    free(ctx);
+    return ret;
+}
+
+void nn_bench_print(const nn_bench_report_t* report) {
+    if (report == NULL) {
+        return;
+    }
+    DEBUG_PRINT("Layer latency (%s, %lu iterations):", report->unit,
+                (unsigned long)(report->count > 0 ? report->cases[0].iterations : 0));
+    DEBUG_PRINT("  %-12s %-20s %10s %10s %10s %10s %10s", "case", "shape", "min", "p50", "p90", "p99", "max");
+    for (int i = 0; i < report->count; i++) {
+        const nn_bench_result_t* r = &report->cases[i];
+        DEBUG_PRINT("  %-12s %-20s %10lu %10lu %10lu %10lu %10lu", r->name, r->shape,
+                    (unsigned long)r->min, (unsigned long)r->p50, (unsigned long)r->p90,
+                    (unsigned long)r->p99, (unsigned long)r->max);
+    }
+}
+
+void nn_bench_write_csv(const nn_bench_report_t* report, FILE* out) {
+    if (report == NULL || out == NULL) {
+        return;
+    }
+    fprintf(out, BENCH_CSV_HEADER "\n");
+    for (int i = 0; i < report->count; i++) {
+        const nn_bench_result_t* r = &report->cases[i];
+        fprintf(out, "%s,%s,%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n", r->name, r->shape, report->unit,
+                (unsigned long)r->iterations, (unsigned long)r->min, (unsigned long)r->p50,
+                (unsigned long)r->p90, (unsigned long)r->p99, (unsigned long)r->max, (unsigned long)r->mean);
+    }
+    fflush(out);
+}
+
+// One result line; false for anything else
+static bool parse_line(char* line, nn_bench_result_t* r, char* unit) {
+    char* fields[10];
+    int n = 0;
+    char* p = line;
+    while (n < 10) {
+        fields[n++] = p;
+        p = strchr(p, ',');
+        if (p == NULL) {
+            break;
+        }
+        *p++ = '\0';
+    }
+    if (n != 10 || p != NULL) {
+        return false;
+    }
+
+    // A log prefix ("I (1234) main: ") may precede the case name
+    char* name = strrchr(fields[0], ' ');
+    name = name != NULL ? name + 1 : fields[0];
+    unsigned long v[7];
+    for (int i = 0; i < 7; i++) {
+        char* end;
+        v[i] = strtoul(fields[3 + i], &end, 10);
+        while (isspace((unsigned char)*end)) {
+            end++;
+        }
+        if (end == fields[3 + i] || *end != '\0') {
+            return false;
+        }
+    }
+    if (name[0] == '\0' || strlen(name) >= NN_BENCH_NAME_LEN || strlen(fields[2]) >= NN_BENCH_UNIT_LEN ||
+        v[0] == 0) {
+        return false;
+    }
+
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    snprintf(r->shape, sizeof(r->shape), "%s", fields[1]);
+    snprintf(unit, NN_BENCH_UNIT_LEN, "%s", fields[2]);
+    r->iterations = (uint32_t)v[0];
+    r->min = (uint32_t)v[1];
+    r->p50 = (uint32_t)v[2];
+    r->p90 = (uint32_t)v[3];
+    r->p99 = (uint32_t)v[4];
+    r->max = (uint32_t)v[5];
+    r->mean = (uint32_t)v[6];
+    return true;
+}
+
+esp_err_t nn_bench_load_csv(const char* path, nn_bench_report_t* report) {
+    if (path == NULL || report == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(report, 0, sizeof(*report));
+    FILE* in = fopen(path, "r");
+    if (in == NULL) {
+        DEBUG_ERROR("Cannot open benchmark results '%s'", path);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    char line[BENCH_LINE_MAX];
+    while (fgets(line, sizeof(line), in) != NULL && report->count < NN_BENCH_MAX_CASES) {
+        char unit[NN_BENCH_UNIT_LEN];
+        nn_bench_result_t r;
+        if (!parse_line(line, &r, unit)) {
+            continue;
+        }
+        if (report->count > 0 && strcmp(unit, report->unit) != 0) {
+            DEBUG_ERROR("Benchmark results '%s' mix units %s and %s", path, report->unit, unit);
+            fclose(in);
+            return ESP_ERR_INVALID_STATE;
+        }
+        snprintf(report->unit, sizeof(report->unit), "%s", unit);
+        report->cases[report->count++] = r;
+    }
+    fclose(in);
+
+    if (report->count == 0) {
+        DEBUG_ERROR("No benchmark results in '%s'", path);
+        return ESP_ERR_NOT_FOUND;
+    }
+    return ESP_OK;
+}
+
+static const nn_bench_result_t* find_case(const nn_bench_report_t* report, const char* name) {
+    for (int i = 0; i < report->count; i++) {
+        if (strcmp(report->cases[i].name, name) == 0) {
+            return &report->cases[i];
+        }
+    }
+    return NULL;
+}
+
+esp_err_t nn_bench_compare(const nn_bench_report_t* baseline, const nn_bench_report_t* current,
+                           float threshold_pct, int* regressions) {
+    if (baseline == NULL || current == NULL || regressions == NULL || threshold_pct < 0.0f) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *regressions = 0;
+    if (strcmp(baseline->unit, current->unit) != 0) {
+        DEBUG_ERROR("Cannot compare %s against a %s baseline", current->unit, baseline->unit);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    DEBUG_PRINT("Median latency against the baseline (%s, threshold %.1f%%):", current->unit, threshold_pct);
+    for (int i = 0; i < current->count; i++) {
+        const nn_bench_result_t* cur = &current->cases[i];
+        const nn_bench_result_t* base = find_case(baseline, cur->name);
+        if (base == NULL) {
+            DEBUG_PRINT("  %-12s %10lu            (not in baseline)", cur->name, (unsigned long)cur->p50);
+            continue;
+        }
+        if (strcmp(base->shape, cur->shape) != 0) {
+            DEBUG_WARN("  %-12s shape %s, baseline %s: not compared", cur->name, cur->shape, base->shape);
+            continue;
+        }
+        float change = base->p50 > 0 ? 100.0f * ((float)cur->p50 - (float)base->p50) / (float)base->p50 : 0.0f;
+        const char* verdict = "";
+        if (change > threshold_pct) {
+            verdict = "  REGRESSION";
+            (*regressions)++;
+        } else if (change < -threshold_pct) {
+            verdict = "  faster";
+        }
+        DEBUG_PRINT("  %-12s %10lu -> %10lu  %+7.1f%%%s", cur->name, (unsigned long)base->p50,
+                    (unsigned long)cur->p50, change, verdict);
+    }
+    for (int i = 0; i < baseline->count; i++) {
+        if (find_case(current, baseline->cases[i].name) == NULL) {
+            DEBUG_WARN("  %-12s in the baseline only", baseline->cases[i].name);
+        }
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,402 @@
+#include "nn_engine.h"
+#include "config.h"
+
+static size_t align_up(size_t v) {
+    return (v + NN_ARENA_ALIGNMENT - 1) & ~(size_t)(NN_ARENA_ALIGNMENT - 1);
+}
+
+int nn_lstm_max_units(const nn_model_t* model) {
+    int units = 0;
+    for (int l = 0; l < NN_LSTM_LAYERS; l++) {
+        if (model->lstm[l].units > units) {
+            units = model->lstm[l].units;
+        }
+    }
+    return units;
+}
+
+// Places the head buffers back to back after base; returns the bytes used
+static size_t layout_head(const nn_model_t* model, uint8_t* base, nn_head_buffers_t* head) {
+    size_t offset = 0;
+
+#define PLACE(ptr, bytes) do { \
+        (ptr) = (int8_t*)((uintptr_t)base + offset); \
+        offset += align_up(bytes); \
+    } while (0)
+
+    const nn_attention_layer_t* att = &model->attention;
+    if (!model->online_attention) {
+        PLACE(head->scores, (size_t)att->steps);
+        PLACE(head->weights, (size_t)att->steps);
+        PLACE(head->weighted, (size_t)att->steps * att->units);
+    }
+    PLACE(head->context, (size_t)att->units);
+    PLACE(head->hidden, (size_t)model->dense[0].out);
+    PLACE(head->logits, (size_t)model->dense[NN_DENSE_LAYERS - 1].out);
+
+#undef PLACE
+    return offset;
+}
+
+size_t nn_head_buffers_size(const nn_model_t* model) {
+    nn_head_buffers_t sizing;
+    return layout_head(model, NULL, &sizing);
+}
+
+void nn_head_buffers_place(const nn_model_t* model, uint8_t* base, nn_head_buffers_t* buffers) {
+    layout_head(model, base, buffers);
+}
+
+// Describes every intermediate tensor with its lifetime over the execution
+// steps of nn_engine_invoke() and records where each pointer lives
+static int build_plan(const nn_model_t* model, nn_engine_t* engine,
+                      nn_plan_buffer_t* buffers, int8_t** targets[]) {
+    int count = 0;
+    int step = 0;
+
+#define ADD(label, ptr, bytes, first_step, last_step, inplace_of) ( \
+        buffers[count] = (nn_plan_buffer_t){ (label), (bytes), (first_step), (last_step), (inplace_of), 0 }, \
+        targets[count] = &(ptr), \
+        count++)
+
+    // Reference: Conv at `step`, MaxPool at step + 1 overwriting the conv
+    // output. Fused: one step writing only the pooled rows.
+    int x = NN_PLAN_NONE;
+    for (int b = 0; b < NN_CONV_BLOCKS; b++) {
+        const nn_conv_block_t* block = &model->blocks[b];
+        if (model->fuse_conv_blocks) {
+            x = ADD("pool_out", engine->pool_out[b], (size_t)block->out_len * block->conv.cout,
+                    step, step + 1, NN_PLAN_NONE);
+            step++;
+            continue;
+        }
+        int conv = ADD("conv_out", engine->conv_out[b], (size_t)block->in_len * block->conv.cout,
+                       step, step + 1, NN_PLAN_NONE);
+        x = ADD("pool_out", engine->pool_out[b], (size_t)block->out_len * block->conv.cout,
+                step + 1, step + 2, conv);
+        step += 2;
+    }
+
+    // One step per LSTM layer. h_t is written after x_t is consumed, so a
+    // layer no wider than its input can overwrite the input sequence. With
+    // online attention the last layer feeds attention row by row and only
+    // keeps h_{t-1} and h_t
+    int lstm_first = step;
+    for (int l = 0; l < NN_LSTM_LAYERS; l++) {
+        const nn_lstm_layer_t* layer = &model->lstm[l];
+        if (model->online_attention && l == NN_LSTM_LAYERS - 1) {
+            x = ADD("lstm_out", engine->lstm_out[l], (size_t)2 * layer->units, step, step, NN_PLAN_NONE);
+            step++;
+            continue;
+        }
+        int inplace = layer->units <= layer->input_size ? x : NN_PLAN_NONE;
+        x = ADD("lstm_out", engine->lstm_out[l], (size_t)layer->steps * layer->units,
+                step, step + 1, inplace);
+        step++;
+    }
+    int units = nn_lstm_max_units(model);
+    ADD("lstm_scratch", engine->lstm_scratch, (size_t)NN_LSTM_SCRATCH_ROWS * units, lstm_first, step - 1, NN_PLAN_NONE);
+    ADD("lstm_cell", engine->lstm_cell, (size_t)units, lstm_first, step - 1, NN_PLAN_NONE);
+    ADD("lstm_h0", engine->lstm_h0, (size_t)units, lstm_first, step - 1, NN_PLAN_NONE);
+#if NN_LSTM_HOIST_INPUT
+    size_t xproj = 0;
+    for (int l = 0; l < NN_LSTM_LAYERS; l++) {
+        size_t bytes = (size_t)model->lstm[l].steps * NN_GATES * model->lstm[l].units;
+        xproj = bytes > xproj ? bytes : xproj;
+    }
+    ADD("lstm_xproj", engine->lstm_xproj, xproj, lstm_first, step - 1, NN_PLAN_NONE);
+#endif
+
+    // Head: scores -> weights, weighted sum -> context, dense, dense, softmax.
+    // Online attention has already produced the context during the last LSTM.
+    const nn_attention_layer_t* att = &model->attention;
+    if (!model->online_attention) {
+        buffers[x].last = step + 1;
+        ADD("scores", engine->head.scores, (size_t)att->steps, step, step, NN_PLAN_NONE);
+        ADD("weights", engine->head.weights, (size_t)att->steps, step, step + 1, NN_PLAN_NONE);
+        ADD("weighted", engine->head.weighted, (size_t)att->steps * att->units, step + 1, step + 1,
+            NN_PLAN_NONE);
+    }
+    ADD("context", engine->head.context, (size_t)att->units, step + 1, step + 2, NN_PLAN_NONE);
+    ADD("hidden", engine->head.hidden, (size_t)model->dense[0].out, step + 2, step + 3, NN_PLAN_NONE);
+    ADD("logits", engine->head.logits, (size_t)model->dense[NN_DENSE_LAYERS - 1].out, step + 3, step + 4,
+        NN_PLAN_NONE);
+
+#undef ADD
+    return count;
+}
+
+// Plans the arena and, when engine->arena is set, points every intermediate
+// tensor into it. Returns the arena size, 0 on failure.
+static size_t layout(const nn_model_t* model, nn_engine_t* engine, nn_plan_buffer_t* buffers, int* count) {
+    int8_t** targets[NN_PLAN_MAX_BUFFERS];
+    *count = build_plan(model, engine, buffers, targets);
+
+    if (nn_plan_arena(buffers, *count, NN_ARENA_ALIGNMENT, &engine->plan) != ESP_OK) {
+        return 0;
+    }
+    for (int i = 0; i < *count; i++) {
+        *targets[i] = (int8_t*)((uintptr_t)engine->arena + buffers[i].offset);
+    }
+    return engine->plan.arena_size;
+}
+
+size_t nn_engine_arena_size(const nn_model_t* model) {
+    if (model == NULL) {
+        return 0;
+    }
+    nn_engine_t sizing = {0};
+    nn_plan_buffer_t buffers[NN_PLAN_MAX_BUFFERS];
+    int count;
+    return layout(model, &sizing, buffers, &count);
+}
+
+void nn_engine_print_plan(const nn_model_t* model) {
+    if (model == NULL) {
+        return;
+    }
+    nn_engine_t sizing = {0};
+    nn_plan_buffer_t buffers[NN_PLAN_MAX_BUFFERS];
+    int count;
+    if (layout(model, &sizing, buffers, &count) != 0) {
+        nn_plan_print(buffers, count, &sizing.plan);
+    }
+}
+
+esp_err_t nn_engine_init(nn_engine_t* engine, const nn_model_t* model, uint8_t* arena, size_t arena_size) {
+    if (engine == NULL || model == NULL || arena == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t required = nn_engine_arena_size(model);
+    if (required == 0) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (arena_size < required) {
+        DEBUG_ERROR("Tensor arena too small: %zu < %zu", arena_size, required);
+        return ESP_ERR_NO_MEM;
+    }
+
+    memset(engine, 0, sizeof(*engine));
+    engine->model = model;
+    engine->arena = arena;
+    engine->arena_size = arena_size;
+    nn_plan_buffer_t buffers[NN_PLAN_MAX_BUFFERS];
+    int count;
+    layout(model, engine, buffers, &count);
+    return ESP_OK;
+}
+
+void nn_conv_block_bn(const nn_conv_block_t* block, int8_t* x, int n) {
+    nn_mul_s8(&block->bn_mul, x, block->bn_scale, block->conv.cout, n, x);
+    nn_add_s8(&block->bn_add, x, block->bn_offset, block->conv.cout, n, x);
+}
+
+static void run_conv_block(const nn_conv_block_t* block, bool fused, const int8_t* in,
+                           int8_t* conv_out, int8_t* pool_out) {
+    if (fused) {
+        nn_conv_bn_relu_pool_s8(&block->conv, &block->fold, in, block->in_len, pool_out);
+        return;
+    }
+
+    // Reference path, op by op as exported
+    nn_conv1d_s8(&block->conv, in, block->in_len, conv_out);
+    nn_conv_block_bn(block, conv_out, block->in_len * block->conv.cout);
+    nn_maxpool1d_s8(conv_out, block->in_len, block->conv.cout, block->pool, pool_out);
+}
+
+void nn_lstm_reset_state(const nn_lstm_layer_t* layer, int8_t* h, int8_t* cell) {
+    memset(h, (int8_t)layer->hidden_q.zero_point, (size_t)layer->units);
+    memset(cell, (int8_t)layer->cell_state_q.zero_point, (size_t)layer->units);
+}
+
+void nn_lstm_step(const nn_lstm_layer_t* layer, const int8_t* x, const int8_t* h_prev,
+                  int8_t* cell, int8_t* scratch, int8_t* h_out) {
+    // The projection lands where nn_lstm_step_projected keeps its own
+    int8_t* proj_x = scratch;
+    nn_gemm_s8(&layer->input_gemm, x, 1, proj_x);
+    nn_lstm_step_projected(layer, proj_x, h_prev, cell, scratch, h_out);
+}
+
+void nn_lstm_step_projected(const nn_lstm_layer_t* layer, const int8_t* proj_x, const int8_t* h_prev,
+                            int8_t* cell, int8_t* scratch, int8_t* h_out) {
+    const int u = layer->units;
+    int8_t* proj_h = scratch + NN_GATES * u;
+    int8_t* pre = proj_h + NN_GATES * u;
+    int8_t* gate = pre + NN_GATES * u;
+    int8_t* forget = gate + NN_GATES * u;
+    int8_t* update = forget + u;
+    int8_t* cell_new = update + u;
+    int8_t* cell_tanh = cell_new + u;
+
+    // h_prev is fully consumed here, before h_out is written below
+    for (int g = 0; g < NN_GATES; g++) {
+        nn_fc_s8(&layer->recurrent_fc[g], h_prev, proj_h + g * u);
+        nn_add_s8(&layer->gate_add[g], proj_x + g * u, proj_h + g * u, u, u, pre + g * u);
+        nn_activation_s8(&layer->gate_act[g], pre + g * u, u, gate + g * u);
+    }
+
+    nn_mul_s8(&layer->forget_mul, gate + NN_GATE_FORGET * u, cell, u, u, forget);
+    nn_mul_s8(&layer->update_mul, gate + NN_GATE_INPUT * u, gate + NN_GATE_CELL * u, u, u, update);
+    nn_add_s8(&layer->cell_add, forget, update, u, u, cell_new);
+    nn_activation_s8(&layer->cell_act, cell_new, u, cell_tanh);
+    nn_mul_s8(&layer->output_mul, gate + NN_GATE_OUTPUT * u, cell_tanh, u, u, h_out);
+
+    // The exported graph carries c_t across iterations in float and
+    // re-quantizes it with the loop-input parameters
+    nn_requant_s8(layer->cell_q, layer->cell_state_q, cell_new, u, cell);
+}
+
+// With attention set, h_seq holds two rows and every h_t goes straight
+// into the online attention instead of being kept for the whole sequence
+static void run_lstm(const nn_lstm_layer_t* layer, const int8_t* x_seq, int8_t* h_seq,
+                     int8_t* scratch, int8_t* cell, int8_t* h0, int8_t* xproj,
+                     const nn_attention_layer_t* att, nn_attention_state_t* attention) {
+    const int u = layer->units;
+    const int rows = attention != NULL ? 2 : layer->steps;
+
+    nn_lstm_reset_state(layer, h0, cell);
+
+#if NN_LSTM_HOIST_INPUT
+    nn_gemm_s8(&layer->input_gemm, x_seq, layer->steps, xproj);
+#endif
+
+    for (int t = 0; t < layer->steps; t++) {
+        const int8_t* h_prev = t > 0 ? h_seq + (size_t)((t - 1) % rows) * u : h0;
+        int8_t* h = h_seq + (size_t)(t % rows) * u;
+#if NN_LSTM_HOIST_INPUT
+        nn_lstm_step_projected(layer, xproj + (size_t)t * NN_GATES * u, h_prev, cell, scratch, h);
+#else
+        const int8_t* x = x_seq + (size_t)t * layer->input_size;
+        nn_lstm_step(layer, x, h_prev, cell, scratch, h);
+#endif
+        if (attention != NULL) {
+            nn_attention_push(att, attention, h);
+        }
+    }
+}
+
+void nn_attention_begin(nn_attention_state_t* state) {
+    memset(state, 0, sizeof(*state));
+    state->max_score = INT8_MIN;
+}
+
+static int32_t scale_q15(int32_t v, int32_t factor) {
+    return (int32_t)(((int64_t)v * factor + (1 << 14)) >> 15);
+}
+
+void nn_attention_push(const nn_attention_layer_t* att, nn_attention_state_t* state, const int8_t* h) {
+    const int u = att->units;
+    const int t = state->steps++;
+
+    int8_t score;
+    nn_fc_s8(&att->score_fc, h, &score);
+    nn_add_s8(&att->bias_add, &score, &att->bias[t], 1, 1, &score);
+    nn_activation_s8(&att->score_act, &score, 1, &score);
+
+    // Everything accumulated so far was weighted relative to the old maximum
+    if (score > state->max_score) {
+        int32_t factor = att->softmax.exp_lut[score - state->max_score];
+        state->sum = scale_q15(state->sum, factor);
+        for (int i = 0; i < u; i++) {
+            state->acc[i] = scale_q15(state->acc[i], factor);
+        }
+        state->max_score = score;
+    }
+
+    int32_t e = att->softmax.exp_lut[state->max_score - score];
+    state->sum += e;
+    for (int i = 0; i < u; i++) {
+        state->acc[i] += e * ((int32_t)h[i] - att->input_q.zero_point);
+    }
+}
+
+void nn_attention_finish(const nn_attention_layer_t* att, const nn_attention_state_t* state, int8_t* context) {
+    // context = input_scale * acc / sum, requantized to the attention output
+    float scale = state->sum > 0 ? att->input_q.scale / (att->out_q.scale * (float)state->sum) : 0.0f;
+    for (int i = 0; i < att->units; i++) {
+        int32_t v = (int32_t)roundf((float)state->acc[i] * scale) + att->out_q.zero_point;
+        context[i] = nn_clamp_s8(v, INT8_MIN, INT8_MAX);
+    }
+}
+
+// Two-pass attention as exported: quantized softmax weights, then the
+// weighted rows and their sum
+static void run_attention(const nn_attention_layer_t* att, const int8_t* seq, const nn_head_buffers_t* head) {
+    const int steps = att->steps;
+    const int u = att->units;
+
+    for (int t = 0; t < steps; t++) {
+        nn_fc_s8(&att->score_fc, seq + (size_t)t * u, &head->scores[t]);
+    }
+    nn_add_s8(&att->bias_add, head->scores, att->bias, steps, steps, head->scores);
+    nn_activation_s8(&att->score_act, head->scores, steps, head->scores);
+    nn_softmax_s8(&att->softmax, head->scores, steps, head->weights);
+
+    for (int t = 0; t < steps; t++) {
+        nn_mul_s8(&att->weight_mul, seq + (size_t)t * u, &head->weights[t], 1, u,
+                  head->weighted + (size_t)t * u);
+    }
+    nn_sum_rows_s8(att->weighted_q, att->out_q, head->weighted, steps, u, head->context);
+}
+
+void nn_run_dense(const nn_model_t* model, const nn_head_buffers_t* buffers, int8_t* output) {
+    nn_fc_s8(&model->dense[0], buffers->context, buffers->hidden);
+    nn_fc_s8(&model->dense[1], buffers->hidden, buffers->logits);
+    nn_softmax_s8(&model->softmax, buffers->logits, model->classes, output);
+}
+
+void nn_run_attention(const nn_model_t* model, const int8_t* seq, const nn_head_buffers_t* buffers) {
+    const nn_attention_layer_t* att = &model->attention;
+
+    if (model->online_attention) {
+        nn_attention_state_t state;
+        nn_attention_begin(&state);
+        for (int t = 0; t < att->steps; t++) {
+            nn_attention_push(att, &state, seq + (size_t)t * att->units);
+        }
+        nn_attention_finish(att, &state, buffers->context);
+    } else {
+        run_attention(att, seq, buffers);
+    }
+}
+
+void nn_run_head(const nn_model_t* model, const int8_t* seq, const nn_head_buffers_t* buffers,
+                 int8_t* output) {
+    nn_run_attention(model, seq, buffers);
+    nn_run_dense(model, buffers, output);
+}
+
+esp_err_t nn_engine_invoke(nn_engine_t* engine, const int8_t* input, int8_t* output) {
+    if (engine == NULL || engine->model == NULL || input == NULL || output == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const nn_model_t* model = engine->model;
+
+    const int8_t* x = input;
+    for (int b = 0; b < NN_CONV_BLOCKS; b++) {
+        run_conv_block(&model->blocks[b], model->fuse_conv_blocks, x, engine->conv_out[b], engine->pool_out[b]);
+        x = engine->pool_out[b];
+    }
+
+    nn_attention_state_t* attention = model->online_attention ? &engine->attention : NULL;
+    if (attention != NULL) {
+        nn_attention_begin(attention);
+    }
+
+    for (int l = 0; l < NN_LSTM_LAYERS; l++) {
+        bool last = l == NN_LSTM_LAYERS - 1;
+        run_lstm(&model->lstm[l], x, engine->lstm_out[l], engine->lstm_scratch, engine->lstm_cell,
+                 engine->lstm_h0, engine->lstm_xproj, &model->attention, last ? attention : NULL);
+        x = engine->lstm_out[l];
+    }
+
+    if (attention != NULL) {
+        nn_attention_finish(&model->attention, attention, engine->head.context);
+        nn_run_dense(model, &engine->head, output);
+    } else {
+        nn_run_head(model, x, &engine->head, output);
+    }
+
+    return ESP_OK;
+}
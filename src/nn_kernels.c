@@ -0,0 +1,442 @@
+#include "nn_kernels.h"
+#include "nn_lut.h"
+
+#include <math.h>
+#include <limits.h>
+#include <string.h>
+
+// TFLite uses a fixed 20-bit headroom for int8 ADD
+#define NN_ADD_LEFT_SHIFT 20
+
+static int32_t saturating_rounding_doubling_high_mul(int32_t a, int32_t b) {
+    if (a == INT32_MIN && b == INT32_MIN) {
+        return INT32_MAX;
+    }
+    int64_t ab = (int64_t)a * (int64_t)b;
+    int32_t nudge = ab >= 0 ? (1 << 30) : (1 - (1 << 30));
+    return (int32_t)((ab + nudge) / (1LL << 31));
+}
+
+static int32_t rounding_divide_by_pot(int32_t x, int exponent) {
+    int32_t mask = (int32_t)((1LL << exponent) - 1);
+    int32_t remainder = x & mask;
+    int32_t threshold = (mask >> 1) + (x < 0 ? 1 : 0);
+    return (x >> exponent) + (remainder > threshold ? 1 : 0);
+}
+
+void nn_quantize_multiplier(double real, nn_requant_t* out) {
+    if (real == 0.0) {
+        out->multiplier = 0;
+        out->shift = 0;
+        return;
+    }
+
+    int shift;
+    double q = frexp(real, &shift);
+    int64_t q_fixed = (int64_t)llround(q * (double)(1LL << 31));
+    if (q_fixed == (1LL << 31)) {
+        q_fixed /= 2;
+        shift++;
+    }
+    if (shift < -31) {
+        shift = 0;
+        q_fixed = 0;
+    }
+
+    out->multiplier = (int32_t)q_fixed;
+    out->shift = shift;
+}
+
+int32_t nn_requantize(int32_t acc, nn_requant_t rq) {
+    int left = rq.shift > 0 ? rq.shift : 0;
+    int right = rq.shift > 0 ? 0 : -rq.shift;
+    return rounding_divide_by_pot(
+        saturating_rounding_doubling_high_mul(acc * (1 << left), rq.multiplier), right);
+}
+
+int8_t nn_quantize_f32(float value, nn_qparam_t q) {
+    int32_t v = (int32_t)roundf(value / q.scale) + q.zero_point;
+    return nn_clamp_s8(v, INT8_MIN, INT8_MAX);
+}
+
+float nn_dequantize_s8(int8_t value, nn_qparam_t q) {
+    return q.scale * (float)((int32_t)value - q.zero_point);
+}
+
+bool nn_qparam_equal(nn_qparam_t a, nn_qparam_t b) {
+    float tolerance = 1e-6f * fmaxf(fabsf(a.scale), fabsf(b.scale));
+    return a.zero_point == b.zero_point && fabsf(a.scale - b.scale) <= tolerance;
+}
+
+void nn_add_params_init(nn_add_params_t* p, nn_qparam_t a, nn_qparam_t b, nn_qparam_t out) {
+    double twice_max = 2.0 * fmax((double)a.scale, (double)b.scale);
+
+    p->input1_offset = -a.zero_point;
+    p->input2_offset = -b.zero_point;
+    p->output_offset = out.zero_point;
+    p->left_shift = NN_ADD_LEFT_SHIFT;
+    nn_quantize_multiplier((double)a.scale / twice_max, &p->input1_rq);
+    nn_quantize_multiplier((double)b.scale / twice_max, &p->input2_rq);
+    nn_quantize_multiplier(twice_max / ((double)(1 << NN_ADD_LEFT_SHIFT) * (double)out.scale),
+                           &p->output_rq);
+}
+
+void nn_mul_params_init(nn_mul_params_t* p, nn_qparam_t a, nn_qparam_t b, nn_qparam_t out) {
+    p->input1_offset = -a.zero_point;
+    p->input2_offset = -b.zero_point;
+    p->output_offset = out.zero_point;
+    nn_quantize_multiplier((double)a.scale * (double)b.scale / (double)out.scale, &p->rq);
+}
+
+void nn_act_params_init(nn_act_params_t* p, nn_act_fn_t fn, nn_qparam_t in_q, nn_qparam_t out_q) {
+    p->fn = fn;
+    p->in_q = in_q;
+    p->out_q = out_q;
+
+    float to_fixed = in_q.scale * (float)(1 << NN_LUT_INPUT_FRAC_BITS);
+    float to_output = 1.0f / (out_q.scale * (float)(1 << NN_LUT_OUTPUT_FRAC_BITS));
+    for (int q = INT8_MIN; q <= INT8_MAX; q++) {
+        float x = roundf(to_fixed * (float)(q - in_q.zero_point));
+        int16_t x_fixed = (int16_t)(x < INT16_MIN ? INT16_MIN : (x > INT16_MAX ? INT16_MAX : x));
+        int16_t y = fn == NN_ACT_SIGMOID ? nn_sigmoid_s16(x_fixed) : nn_tanh_s16(x_fixed);
+        int32_t v = (int32_t)roundf((float)y * to_output) + out_q.zero_point;
+        p->lut[q - INT8_MIN] = nn_clamp_s8(v, INT8_MIN, INT8_MAX);
+    }
+}
+
+void nn_softmax_params_init(nn_softmax_params_t* p, nn_qparam_t in_q, float beta, nn_qparam_t out_q) {
+    p->out_q = out_q;
+
+    float to_fixed = in_q.scale * beta * (float)(1 << NN_LUT_EXP_FRAC_BITS);
+    for (int d = 0; d < 256; d++) {
+        float x = -roundf(to_fixed * (float)d);
+        p->exp_lut[d] = nn_exp_s16((int16_t)(x < INT16_MIN ? INT16_MIN : x));
+    }
+}
+
+esp_err_t nn_gemm_params_pack(nn_gemm_params_t* p, const nn_fc_params_t* fcs, int count, int8_t* packed) {
+    if (p == NULL || fcs == NULL || packed == NULL || count <= 0 || count > NN_GEMM_MAX_SEGMENTS ||
+        fcs[0].out * count > NN_GEMM_MAX_ROWS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const int in = fcs[0].in;
+    const int rows = fcs[0].out;
+    for (int s = 1; s < count; s++) {
+        if (fcs[s].in != in || fcs[s].out != rows || fcs[s].input_offset != fcs[0].input_offset ||
+            fcs[s].act_min != fcs[0].act_min || fcs[s].act_max != fcs[0].act_max) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    memset(p, 0, sizeof(*p));
+    p->in = in;
+    p->out = rows * count;
+    p->segment_rows = rows;
+    p->weights = packed;
+    p->act_min = fcs[0].act_min;
+    p->act_max = fcs[0].act_max;
+    for (int s = 0; s < count; s++) {
+        memcpy(packed + (size_t)s * rows * in, fcs[s].weights, (size_t)rows * in);
+        p->rq[s] = fcs[s].rq;
+        p->output_offset[s] = fcs[s].output_offset;
+        for (int r = 0; r < rows; r++) {
+            const int8_t* w = fcs[s].weights + (size_t)r * in;
+            int32_t sum = 0;
+            for (int i = 0; i < in; i++) {
+                sum += w[i];
+            }
+            p->bias[s * rows + r] = (fcs[s].has_bias ? fcs[s].bias[r] : 0) + fcs[s].input_offset * sum;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t nn_input_affine_init(nn_input_affine_t* p, int channels, const float* gain,
+                               const float* offset, float lo, float hi, nn_qparam_t out_q) {
+    if (p == NULL || gain == NULL || offset == NULL || channels <= 0 ||
+        channels > NN_MAX_CHANNELS || lo > hi) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const double unit = (double)(1 << NN_INPUT_AFFINE_FRAC_BITS);
+    p->channels = channels;
+    p->output_offset = out_q.zero_point;
+    for (int c = 0; c < channels; c++) {
+        if (gain[c] == 0.0f) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        // x = gain * (raw + offset / gain), so the clamp moves to raw units
+        double g = gain[c];
+        double a = ((double)lo - offset[c]) / g * unit;
+        double b = ((double)hi - offset[c]) / g * unit;
+        p->acc_offset[c] = (int32_t)llround((double)offset[c] / g * unit);
+        p->acc_min[c] = (int32_t)llround(fmin(a, b));
+        p->acc_max[c] = (int32_t)llround(fmax(a, b));
+        nn_quantize_multiplier(g / ((double)out_q.scale * unit), &p->rq[c]);
+    }
+    return ESP_OK;
+}
+
+static inline int32_t conv1d_acc(const nn_conv1d_params_t* p, const int8_t* const* taps, int oc) {
+    const int8_t* w = p->weights + (size_t)oc * p->kernel * p->cin;
+    int32_t acc = p->bias[oc];
+
+    for (int k = 0; k < p->kernel; k++) {
+        const int8_t* x = taps[k];
+        if (x == NULL) {
+            continue;
+        }
+        const int8_t* wk = w + k * p->cin;
+        for (int ic = 0; ic < p->cin; ic++) {
+            acc += ((int32_t)x[ic] + p->input_offset) * (int32_t)wk[ic];
+        }
+    }
+    return acc;
+}
+
+void nn_conv1d_step_s8(const nn_conv1d_params_t* p, const int8_t* const* taps, int8_t* out) {
+    for (int oc = 0; oc < p->cout; oc++) {
+        int32_t acc = nn_requantize(conv1d_acc(p, taps, oc), p->rq[oc]) + p->output_offset;
+        out[oc] = nn_clamp_s8(acc, p->act_min, p->act_max);
+    }
+}
+
+void nn_conv1d_acc_s8(const nn_conv1d_params_t* p, const int8_t* const* taps, int32_t* acc) {
+    for (int oc = 0; oc < p->cout; oc++) {
+        acc[oc] = conv1d_acc(p, taps, oc);
+    }
+}
+
+void nn_conv1d_s8(const nn_conv1d_params_t* p, const int8_t* in, int len, int8_t* out) {
+    // SAME padding, stride 1: padded taps hold the input zero point and
+    // contribute nothing once the offset is applied, so they are skipped
+    const int8_t* taps[NN_MAX_KERNEL];
+    int pad = (p->kernel - 1) / 2;
+
+    for (int t = 0; t < len; t++) {
+        for (int k = 0; k < p->kernel; k++) {
+            int src = t + k - pad;
+            taps[k] = (src < 0 || src >= len) ? NULL : in + (size_t)src * p->cin;
+        }
+        nn_conv1d_step_s8(p, taps, out + (size_t)t * p->cout);
+    }
+}
+
+void nn_bn_fold_apply_s8(const nn_bn_fold_t* fold, const int32_t* acc, int8_t* out) {
+    const nn_mul_params_t* mul = &fold->mul;
+    const nn_add_params_t* add = &fold->add;
+    for (int c = 0; c < fold->channels; c++) {
+        // Same steps as nn_conv1d_s8, nn_mul_s8 and nn_add_s8 on one element
+        int32_t x = nn_clamp_s8(nn_requantize(acc[c], fold->conv_rq[c]) + fold->conv_offset,
+                                fold->act_min, fold->act_max);
+        int32_t m = nn_clamp_s8(nn_requantize((x + mul->input1_offset) * fold->scale[c], mul->rq) +
+                                mul->output_offset, INT8_MIN, INT8_MAX);
+        int32_t x1 = nn_requantize((m + add->input1_offset) * (1 << add->left_shift), add->input1_rq);
+        out[c] = nn_clamp_s8(nn_requantize(x1 + fold->offset[c], add->output_rq) + add->output_offset,
+                             INT8_MIN, INT8_MAX);
+    }
+}
+
+void nn_conv_bn_relu_pool_s8(const nn_conv1d_params_t* conv, const nn_bn_fold_t* fold,
+                             const int8_t* in, int len, int8_t* out) {
+    nn_conv_bn_relu_pool_rows_s8(conv, fold, in, len, 0, len / fold->pool, out);
+}
+
+void nn_conv_bn_relu_pool_rows_s8(const nn_conv1d_params_t* conv, const nn_bn_fold_t* fold,
+                                  const int8_t* in, int len, int first, int count, int8_t* out) {
+    const int8_t* taps[NN_MAX_KERNEL];
+    int32_t acc[NN_MAX_CHANNELS];
+    int32_t best[NN_MAX_CHANNELS];
+    int pad = (conv->kernel - 1) / 2;
+
+    for (int t = first; t < first + count; t++) {
+        for (int p = 0; p < fold->pool; p++) {
+            int pos = t * fold->pool + p;
+            for (int k = 0; k < conv->kernel; k++) {
+                int src = pos + k - pad;
+                taps[k] = (src < 0 || src >= len) ? NULL : in + (size_t)src * conv->cin;
+            }
+            nn_conv1d_acc_s8(conv, taps, p == 0 ? best : acc);
+            for (int c = 0; p > 0 && c < conv->cout; c++) {
+                if (acc[c] > best[c]) {
+                    best[c] = acc[c];
+                }
+            }
+        }
+        nn_bn_fold_apply_s8(fold, best, out + (size_t)t * conv->cout);
+    }
+}
+
+void nn_fc_s8(const nn_fc_params_t* p, const int8_t* in, int8_t* out) {
+    for (int o = 0; o < p->out; o++) {
+        const int8_t* w = p->weights + (size_t)o * p->in;
+        int32_t acc = p->has_bias ? p->bias[o] : 0;
+
+        for (int i = 0; i < p->in; i++) {
+            acc += ((int32_t)in[i] + p->input_offset) * (int32_t)w[i];
+        }
+
+        acc = nn_requantize(acc, p->rq) + p->output_offset;
+        out[o] = nn_clamp_s8(acc, p->act_min, p->act_max);
+    }
+}
+
+// Four input rows per weight row load, then a single-row tail
+#define NN_GEMM_BLOCK 4
+
+void nn_gemm_s8(const nn_gemm_params_t* p, const int8_t* in, int rows, int8_t* out) {
+    const int n = p->in;
+    int t = 0;
+
+    for (; t + NN_GEMM_BLOCK <= rows; t += NN_GEMM_BLOCK) {
+        const int8_t* x0 = in + (size_t)t * n;
+        const int8_t* x1 = x0 + n;
+        const int8_t* x2 = x1 + n;
+        const int8_t* x3 = x2 + n;
+        int8_t* y = out + (size_t)t * p->out;
+
+        for (int o = 0; o < p->out; o++) {
+            const int8_t* w = p->weights + (size_t)o * n;
+            int32_t a0 = p->bias[o], a1 = a0, a2 = a0, a3 = a0;
+            for (int i = 0; i < n; i++) {
+                int32_t wi = w[i];
+                a0 += x0[i] * wi;
+                a1 += x1[i] * wi;
+                a2 += x2[i] * wi;
+                a3 += x3[i] * wi;
+            }
+
+            int seg = o / p->segment_rows;
+            nn_requant_t rq = p->rq[seg];
+            int32_t zp = p->output_offset[seg];
+            y[o] = nn_clamp_s8(nn_requantize(a0, rq) + zp, p->act_min, p->act_max);
+            y[p->out + o] = nn_clamp_s8(nn_requantize(a1, rq) + zp, p->act_min, p->act_max);
+            y[2 * p->out + o] = nn_clamp_s8(nn_requantize(a2, rq) + zp, p->act_min, p->act_max);
+            y[3 * p->out + o] = nn_clamp_s8(nn_requantize(a3, rq) + zp, p->act_min, p->act_max);
+        }
+    }
+
+    for (; t < rows; t++) {
+        const int8_t* x = in + (size_t)t * n;
+        int8_t* y = out + (size_t)t * p->out;
+        for (int o = 0; o < p->out; o++) {
+            const int8_t* w = p->weights + (size_t)o * n;
+            int32_t acc = p->bias[o];
+            for (int i = 0; i < n; i++) {
+                acc += x[i] * (int32_t)w[i];
+            }
+            int seg = o / p->segment_rows;
+            y[o] = nn_clamp_s8(nn_requantize(acc, p->rq[seg]) + p->output_offset[seg], p->act_min, p->act_max);
+        }
+    }
+}
+
+void nn_maxpool1d_s8(const int8_t* in, int len, int channels, int pool, int8_t* out) {
+    // VALID padding with stride == pool size
+    int out_len = len / pool;
+
+    for (int t = 0; t < out_len; t++) {
+        const int8_t* src = in + (size_t)t * pool * channels;
+        int8_t* dst = out + (size_t)t * channels;
+        for (int c = 0; c < channels; c++) {
+            int8_t m = src[c];
+            for (int k = 1; k < pool; k++) {
+                int8_t v = src[(size_t)k * channels + c];
+                if (v > m) {
+                    m = v;
+                }
+            }
+            dst[c] = m;
+        }
+    }
+}
+
+void nn_input_affine_s16(const nn_input_affine_t* p, const int16_t* raw, int8_t* out) {
+    for (int c = 0; c < p->channels; c++) {
+        int32_t acc = (int32_t)raw[c] * (1 << NN_INPUT_AFFINE_FRAC_BITS) + p->acc_offset[c];
+        acc = acc < p->acc_min[c] ? p->acc_min[c] : (acc > p->acc_max[c] ? p->acc_max[c] : acc);
+        out[c] = nn_clamp_s8(nn_requantize(acc, p->rq[c]) + p->output_offset, INT8_MIN, INT8_MAX);
+    }
+}
+
+void nn_add_s8(const nn_add_params_t* p, const int8_t* a, const int8_t* b, int b_len,
+               int n, int8_t* out) {
+    for (int i = 0, j = 0; i < n; i++) {
+        int32_t x1 = ((int32_t)a[i] + p->input1_offset) * (1 << p->left_shift);
+        int32_t x2 = ((int32_t)b[j] + p->input2_offset) * (1 << p->left_shift);
+        int32_t sum = nn_requantize(x1, p->input1_rq) + nn_requantize(x2, p->input2_rq);
+        int32_t v = nn_requantize(sum, p->output_rq) + p->output_offset;
+        out[i] = nn_clamp_s8(v, INT8_MIN, INT8_MAX);
+        if (++j == b_len) {
+            j = 0;
+        }
+    }
+}
+
+void nn_mul_s8(const nn_mul_params_t* p, const int8_t* a, const int8_t* b, int b_len,
+               int n, int8_t* out) {
+    for (int i = 0, j = 0; i < n; i++) {
+        int32_t prod = ((int32_t)a[i] + p->input1_offset) * ((int32_t)b[j] + p->input2_offset);
+        int32_t v = nn_requantize(prod, p->rq) + p->output_offset;
+        out[i] = nn_clamp_s8(v, INT8_MIN, INT8_MAX);
+        if (++j == b_len) {
+            j = 0;
+        }
+    }
+}
+
+void nn_activation_s8(const nn_act_params_t* p, const int8_t* in, int n, int8_t* out) {
+    for (int i = 0; i < n; i++) {
+        out[i] = p->lut[(int32_t)in[i] - INT8_MIN];
+    }
+}
+
+void nn_activation_s16(nn_act_fn_t fn, const int16_t* in, int n, int16_t* out) {
+    const nn_lut_table_t* table = fn == NN_ACT_SIGMOID ? &nn_lut_sigmoid : &nn_lut_tanh;
+    for (int i = 0; i < n; i++) {
+        out[i] = nn_lut_interp(table, (uint32_t)((int32_t)in[i] + 32768));
+    }
+}
+
+void nn_softmax_s8(const nn_softmax_params_t* p, const int8_t* in, int n, int8_t* out) {
+    int8_t max_val = in[0];
+    for (int i = 1; i < n; i++) {
+        if (in[i] > max_val) {
+            max_val = in[i];
+        }
+    }
+
+    int32_t sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += p->exp_lut[max_val - in[i]];
+    }
+
+    // Every term is >= 0, so adding 0.5 and truncating rounds to nearest
+    float inv_sum = 1.0f / ((float)sum * p->out_q.scale);
+    for (int i = 0; i < n; i++) {
+        int32_t v = (int32_t)((float)p->exp_lut[max_val - in[i]] * inv_sum + 0.5f) + p->out_q.zero_point;
+        out[i] = nn_clamp_s8(v, INT8_MIN, INT8_MAX);
+    }
+}
+
+void nn_sum_rows_s8(nn_qparam_t in_q, nn_qparam_t out_q, const int8_t* in, int rows,
+                    int cols, int8_t* out) {
+    float scale = in_q.scale / out_q.scale;
+    float bias = -(float)in_q.zero_point * scale * (float)rows;
+
+    for (int c = 0; c < cols; c++) {
+        int32_t sum = 0;
+        for (int r = 0; r < rows; r++) {
+            sum += in[(size_t)r * cols + c];
+        }
+        int32_t v = (int32_t)roundf((float)sum * scale + bias) + out_q.zero_point;
+        out[c] = nn_clamp_s8(v, INT8_MIN, INT8_MAX);
+    }
+}
+
+void nn_requant_s8(nn_qparam_t in_q, nn_qparam_t out_q, const int8_t* in, int n, int8_t* out) {
+    for (int i = 0; i < n; i++) {
+        out[i] = nn_quantize_f32(nn_dequantize_s8(in[i], in_q), out_q);
+    }
+}
@@ -0,0 +1,87 @@
+#include "nn_lut.h"
+
+// Activation tables, evaluated by the compiler. libm is not constexpr, so
+// exp is computed here from a range-reduced Taylor series in double
+// precision; every other function is derived from it.
+
+namespace {
+
+constexpr double ln2 = 0.69314718055994530942;
+
+constexpr double const_exp(double x) {
+    // x = k * ln2 + r with |r| <= ln2 / 2
+    int k = (int)(x / ln2 + (x < 0 ? -0.5 : 0.5));
+    double r = x - k * ln2;
+
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n < 20; n++) {
+        term *= r / n;
+        sum += term;
+    }
+    for (; k > 0; k--) {
+        sum *= 2.0;
+    }
+    for (; k < 0; k++) {
+        sum *= 0.5;
+    }
+    return sum;
+}
+
+enum class lut_fn { sigmoid, tanh, exp };
+
+constexpr double evaluate(lut_fn fn, double x) {
+    switch (fn) {
+    case lut_fn::sigmoid:
+        return 1.0 / (1.0 + const_exp(-x));
+    case lut_fn::tanh: {
+        double e = const_exp(-2.0 * (x < 0 ? -x : x));
+        double t = (1.0 - e) / (1.0 + e);
+        return x < 0 ? -t : t;
+    }
+    default:
+        return const_exp(x);
+    }
+}
+
+constexpr int16_t to_q15(double y) {
+    double v = y * (double)(1 << NN_LUT_OUTPUT_FRAC_BITS);
+    v += v < 0 ? -0.5 : 0.5;
+    if (v >= (double)INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (v <= (double)INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)v;
+}
+
+constexpr nn_lut_table_t make_table(lut_fn fn, double lo, double hi) {
+    nn_lut_table_t t{};
+    for (int k = 0; k < NN_LUT_ENTRIES; k++) {
+        t.v[k] = to_q15(evaluate(fn, lo + (hi - lo) * k / (NN_LUT_ENTRIES - 1)));
+    }
+    return t;
+}
+
+constexpr int mid = (NN_LUT_ENTRIES - 1) / 2;
+
+constexpr nn_lut_table_t sigmoid_table = make_table(lut_fn::sigmoid, -8.0, 8.0);
+constexpr nn_lut_table_t tanh_table = make_table(lut_fn::tanh, -8.0, 8.0);
+constexpr nn_lut_table_t exp_table = make_table(lut_fn::exp, -16.0, 0.0);
+
+static_assert(sigmoid_table.v[mid] == 16384, "sigmoid(0) must be 0.5");
+static_assert(sigmoid_table.v[mid + 32] == 23955, "sigmoid(1) must be 0.731059");
+static_assert(tanh_table.v[mid] == 0 && tanh_table.v[mid + 32] == 24956, "tanh(1) must be 0.761594");
+static_assert(exp_table.v[NN_LUT_ENTRIES - 1] == INT16_MAX, "exp(0) saturates to 1.0");
+static_assert(exp_table.v[NN_LUT_ENTRIES - 33] == 12055, "exp(-1) must be 0.367879");
+
+} // namespace
+
+extern "C" {
+
+const nn_lut_table_t nn_lut_sigmoid = sigmoid_table;
+const nn_lut_table_t nn_lut_tanh = tanh_table;
+const nn_lut_table_t nn_lut_exp = exp_table;
+
+}
@@ -0,0 +1,231 @@
+#include "nn_lut.h"
+#include "nn_kernels.h"
+#include "config.h"
+
+#include <math.h>
+
+#ifdef ESP_PLATFORM
+#include <esp_cpu.h>
+#endif
+
+// Accuracy and speed of the activation tables against libm
+
+#define REPORT_ELEMENTS 2048
+#define REPORT_ROUNDS   8
+#define REPORT_SOFTMAX_ROW 75   // attention steps
+
+#ifdef ESP_PLATFORM
+#define CLOCK_NOW() ((uint32_t)esp_cpu_get_cycle_count())
+#define CLOCK_UNIT "cycles"
+#else
+#define CLOCK_NOW() ((uint32_t)(esp_timer_get_time() * 1000))
+#define CLOCK_UNIT "ns"
+#endif
+
+typedef enum {
+    REPORT_SIGMOID,
+    REPORT_TANH,
+    REPORT_EXP,
+} report_fn_t;
+
+static volatile int32_t report_sink;
+
+static double reference(report_fn_t fn, double x) {
+    switch (fn) {
+    case REPORT_SIGMOID:
+        return 1.0 / (1.0 + exp(-x));
+    case REPORT_TANH:
+        return tanh(x);
+    default:
+        return exp(x);
+    }
+}
+
+static void report_s16_accuracy(report_fn_t fn, const char* name) {
+    const double output_one = (double)(1 << NN_LUT_OUTPUT_FRAC_BITS);
+    const double input_one = (double)(1 << (fn == REPORT_EXP ? NN_LUT_EXP_FRAC_BITS : NN_LUT_INPUT_FRAC_BITS));
+    const int last = fn == REPORT_EXP ? 0 : INT16_MAX;
+
+    double max_err = 0.0;
+    double sum_sq = 0.0;
+    int worst = 0;
+    int count = 0;
+    for (int x = INT16_MIN; x <= last; x++) {
+        int16_t y = fn == REPORT_SIGMOID ? nn_sigmoid_s16((int16_t)x)
+                  : fn == REPORT_TANH ? nn_tanh_s16((int16_t)x) : nn_exp_s16((int16_t)x);
+        double ref = reference(fn, (double)x / input_one) * output_one;
+        if (ref > INT16_MAX) {
+            ref = INT16_MAX;
+        }
+        double err = fabs((double)y - ref);
+        sum_sq += err * err;
+        count++;
+        if (err > max_err) {
+            max_err = err;
+            worst = x;
+        }
+    }
+
+    DEBUG_PRINT("  %-7s int16: max %.2f LSB at x=%.4f, rms %.3f LSB (Q0.15)",
+                name, max_err, (double)worst / input_one, sqrt(sum_sq / count));
+}
+
+// The float kernel the tables replace, for one int8 tensor
+static int8_t float_activation(const nn_act_params_t* p, int8_t q) {
+    float x = p->in_q.scale * (float)((int32_t)q - p->in_q.zero_point);
+    float y = p->fn == NN_ACT_SIGMOID ? 1.0f / (1.0f + expf(-x)) : tanhf(x);
+    int32_t v = (int32_t)(roundf(y / p->out_q.scale) + (float)p->out_q.zero_point);
+    return nn_clamp_s8(v, INT8_MIN, INT8_MAX);
+}
+
+static void report_s8_accuracy(nn_act_fn_t fn, const char* name, nn_qparam_t out_q) {
+    static const float input_scales[] = { 1.0f / 16, 1.0f / 32, 1.0f / 64, 1.0f / 128 };
+
+    for (size_t s = 0; s < sizeof(input_scales) / sizeof(input_scales[0]); s++) {
+        nn_qparam_t in_q = { input_scales[s], 0 };
+        nn_act_params_t p;
+        nn_act_params_init(&p, fn, in_q, out_q);
+
+        int mismatches = 0;
+        int max_diff = 0;
+        for (int q = INT8_MIN; q <= INT8_MAX; q++) {
+            int diff = abs((int)p.lut[q - INT8_MIN] - (int)float_activation(&p, (int8_t)q));
+            mismatches += diff != 0;
+            max_diff = diff > max_diff ? diff : max_diff;
+        }
+        DEBUG_PRINT("  %-7s int8, input scale 1/%-3d: %d/256 outputs differ from libm, max %d LSB",
+                    name, (int)(1.0f / input_scales[s] + 0.5f), mismatches, max_diff);
+    }
+}
+
+static void fill_inputs(int8_t* s8, int16_t* s16, int n) {
+    uint32_t state = 12345;
+    for (int i = 0; i < n; i++) {
+        state = state * 1664525u + 1013904223u;
+        s8[i] = (int8_t)(state >> 24);
+        s16[i] = (int16_t)(state >> 16);
+    }
+}
+
+static void report_s8_speed(nn_act_fn_t fn, const char* name, const int8_t* in, int8_t* out) {
+    nn_qparam_t in_q = { 1.0f / 32, 0 };
+    nn_qparam_t out_q = fn == NN_ACT_SIGMOID ? (nn_qparam_t){ 1.0f / 256, -128 } : (nn_qparam_t){ 1.0f / 128, 0 };
+    nn_act_params_t p;
+    nn_act_params_init(&p, fn, in_q, out_q);
+
+    uint32_t start = CLOCK_NOW();
+    for (int r = 0; r < REPORT_ROUNDS; r++) {
+        for (int i = 0; i < REPORT_ELEMENTS; i++) {
+            out[i] = float_activation(&p, in[i]);
+        }
+        report_sink += out[r];
+    }
+    uint32_t libm = CLOCK_NOW() - start;
+
+    start = CLOCK_NOW();
+    for (int r = 0; r < REPORT_ROUNDS; r++) {
+        nn_activation_s8(&p, in, REPORT_ELEMENTS, out);
+        report_sink += out[r];
+    }
+    uint32_t table = CLOCK_NOW() - start;
+
+    const float elements = (float)REPORT_ROUNDS * REPORT_ELEMENTS;
+    DEBUG_PRINT("  %-7s int8:  libm %7.1f, table %5.1f " CLOCK_UNIT "/element",
+                name, libm / elements, table / elements);
+}
+
+static void report_s16_speed(nn_act_fn_t fn, const char* name, const int16_t* in, int16_t* out) {
+    const float input_one = (float)(1 << NN_LUT_INPUT_FRAC_BITS);
+    const float output_one = (float)(1 << NN_LUT_OUTPUT_FRAC_BITS);
+
+    uint32_t start = CLOCK_NOW();
+    for (int r = 0; r < REPORT_ROUNDS; r++) {
+        for (int i = 0; i < REPORT_ELEMENTS; i++) {
+            float x = (float)in[i] / input_one;
+            float y = fn == NN_ACT_SIGMOID ? 1.0f / (1.0f + expf(-x)) : tanhf(x);
+            out[i] = (int16_t)fminf(roundf(y * output_one), (float)INT16_MAX);
+        }
+        report_sink += out[r];
+    }
+    uint32_t libm = CLOCK_NOW() - start;
+
+    start = CLOCK_NOW();
+    for (int r = 0; r < REPORT_ROUNDS; r++) {
+        nn_activation_s16(fn, in, REPORT_ELEMENTS, out);
+        report_sink += out[r];
+    }
+    uint32_t table = CLOCK_NOW() - start;
+
+    const float elements = (float)REPORT_ROUNDS * REPORT_ELEMENTS;
+    DEBUG_PRINT("  %-7s int16: libm %7.1f, table %5.1f " CLOCK_UNIT "/element",
+                name, libm / elements, table / elements);
+}
+
+static void report_softmax_speed(const int8_t* in, int8_t* out) {
+    nn_qparam_t in_q = { 1.0f / 128, 0 };
+    nn_qparam_t out_q = { 1.0f / 256, -128 };
+    nn_softmax_params_t p;
+    nn_softmax_params_init(&p, in_q, 1.0f, out_q);
+    const int rows = REPORT_ELEMENTS / REPORT_SOFTMAX_ROW;
+
+    uint32_t start = CLOCK_NOW();
+    for (int r = 0; r < REPORT_ROUNDS; r++) {
+        for (int row = 0; row < rows; row++) {
+            const int8_t* x = in + row * REPORT_SOFTMAX_ROW;
+            int8_t* y = out + row * REPORT_SOFTMAX_ROW;
+            int8_t max_val = x[0];
+            for (int i = 1; i < REPORT_SOFTMAX_ROW; i++) {
+                max_val = x[i] > max_val ? x[i] : max_val;
+            }
+            float sum = 0.0f;
+            for (int i = 0; i < REPORT_SOFTMAX_ROW; i++) {
+                sum += expf(-in_q.scale * (float)(max_val - x[i]));
+            }
+            float inv_sum = 1.0f / (sum * out_q.scale);
+            for (int i = 0; i < REPORT_SOFTMAX_ROW; i++) {
+                float e = expf(-in_q.scale * (float)(max_val - x[i]));
+                y[i] = nn_clamp_s8((int32_t)rintf(e * inv_sum) + out_q.zero_point, INT8_MIN, INT8_MAX);
+            }
+        }
+        report_sink += out[r];
+    }
+    uint32_t libm = CLOCK_NOW() - start;
+
+    start = CLOCK_NOW();
+    for (int r = 0; r < REPORT_ROUNDS; r++) {
+        for (int row = 0; row < rows; row++) {
+            nn_softmax_s8(&p, in + row * REPORT_SOFTMAX_ROW, REPORT_SOFTMAX_ROW, out + row * REPORT_SOFTMAX_ROW);
+        }
+        report_sink += out[r];
+    }
+    uint32_t table = CLOCK_NOW() - start;
+
+    const float elements = (float)REPORT_ROUNDS * rows * REPORT_SOFTMAX_ROW;
+    DEBUG_PRINT("  softmax int8 x%d: libm %7.1f, table %5.1f " CLOCK_UNIT "/element",
+                REPORT_SOFTMAX_ROW, libm / elements, table / elements);
+}
+
+void nn_lut_report(void) {
+    static int8_t in_s8[REPORT_ELEMENTS];
+    static int8_t out_s8[REPORT_ELEMENTS];
+    static int16_t in_s16[REPORT_ELEMENTS];
+    static int16_t out_s16[REPORT_ELEMENTS];
+
+    DEBUG_PRINT("Activation tables: %d entries, %u bytes each",
+                NN_LUT_ENTRIES, (unsigned)sizeof(nn_lut_table_t));
+
+    DEBUG_PRINT("Accuracy against libm:");
+    report_s16_accuracy(REPORT_SIGMOID, "sigmoid");
+    report_s16_accuracy(REPORT_TANH, "tanh");
+    report_s16_accuracy(REPORT_EXP, "exp");
+    report_s8_accuracy(NN_ACT_SIGMOID, "sigmoid", (nn_qparam_t){ 1.0f / 256, -128 });
+    report_s8_accuracy(NN_ACT_TANH, "tanh", (nn_qparam_t){ 1.0f / 128, 0 });
+
+    DEBUG_PRINT("Speed (%d elements x %d rounds):", REPORT_ELEMENTS, REPORT_ROUNDS);
+    fill_inputs(in_s8, in_s16, REPORT_ELEMENTS);
+    report_s8_speed(NN_ACT_SIGMOID, "sigmoid", in_s8, out_s8);
+    report_s8_speed(NN_ACT_TANH, "tanh", in_s8, out_s8);
+    report_s16_speed(NN_ACT_SIGMOID, "sigmoid", in_s16, out_s16);
+    report_s16_speed(NN_ACT_TANH, "tanh", in_s16, out_s16);
+    report_softmax_speed(in_s8, out_s8);
+}
@@ -0,0 +1,572 @@
+#include "nn_model.h"
+#include "config.h"
+
+#define MAIN_SUBGRAPH 0
+
+#define BIND_CHECK(cond, what) do { \
+        if (!(cond)) { \
+            DEBUG_ERROR("Unsupported model: %s", what); \
+            return ESP_ERR_NOT_SUPPORTED; \
+        } \
+    } while (0)
+
+static int32_t op_input(const nn_model_t* m, int sg, int op, int index) {
+    int32_t inputs[8];
+    int n = tfl_op_inputs(&m->tfl, sg, op, inputs, 8);
+    return (op >= 0 && index < n && index < 8) ? inputs[index] : -1;
+}
+
+static int32_t op_output(const nn_model_t* m, int sg, int op) {
+    int32_t outputs[8];
+    int n = tfl_op_outputs(&m->tfl, sg, op, outputs, 8);
+    return (op >= 0 && n > 0) ? outputs[0] : -1;
+}
+
+// For a binary op, the input that is not `tensor`
+static int32_t other_input(const nn_model_t* m, int sg, int op, int32_t tensor) {
+    int32_t a = op_input(m, sg, op, 0);
+    return a == tensor ? op_input(m, sg, op, 1) : a;
+}
+
+// For a binary op with one constant operand, the index of the constant input
+static int const_input(const nn_model_t* m, int sg, int op) {
+    for (int i = 0; i < 2; i++) {
+        tfl_tensor_t t;
+        if (tfl_tensor_get(&m->tfl, sg, op_input(m, sg, op, i), &t) == ESP_OK && t.data != NULL) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static nn_qparam_t tensor_q(const nn_model_t* m, int sg, int32_t index) {
+    nn_qparam_t q = {0.0f, 0};
+    tfl_tensor_t t;
+    if (tfl_tensor_get(&m->tfl, sg, index, &t) == ESP_OK) {
+        q.scale = tfl_tensor_scale(&t, 0);
+        q.zero_point = t.zero_point;
+    }
+    return q;
+}
+
+static esp_err_t copy_bias(const nn_model_t* m, int sg, int32_t index, int32_t* bias, int count) {
+    tfl_tensor_t t;
+    esp_err_t ret = tfl_tensor_get(&m->tfl, sg, index, &t);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    BIND_CHECK(t.type == TFL_TYPE_INT32 && t.data != NULL, "bias must be constant int32");
+    BIND_CHECK(t.data_size == (size_t)count * sizeof(int32_t), "bias size mismatch");
+    // Biases are copied because flatbuffer data is only byte aligned
+    memcpy(bias, t.data, t.data_size);
+    return ESP_OK;
+}
+
+static esp_err_t bind_fc(const nn_model_t* m, int sg, int op, nn_fc_params_t* fc, nn_qparam_t* out_q) {
+    BIND_CHECK(op >= 0 && tfl_op_builtin(&m->tfl, sg, op) == TFL_OP_FULLY_CONNECTED,
+               "expected FULLY_CONNECTED");
+
+    tfl_tensor_t w;
+    esp_err_t ret = tfl_tensor_get(&m->tfl, sg, op_input(m, sg, op, 1), &w);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    BIND_CHECK(w.type == TFL_TYPE_INT8 && w.data != NULL && w.ndim == 2, "FC weights must be int8 [out, in]");
+    BIND_CHECK(w.dims[0] <= NN_MAX_CHANNELS, "FC too wide");
+    BIND_CHECK(w.data_size >= (size_t)tfl_tensor_elements(&w), "FC weights truncated");
+
+    memset(fc, 0, sizeof(*fc));
+    fc->out = w.dims[0];
+    fc->in = w.dims[1];
+    fc->weights = (const int8_t*)w.data;
+
+    int32_t bias_index = op_input(m, sg, op, 2);
+    fc->has_bias = bias_index >= 0;
+    if (fc->has_bias) {
+        ret = copy_bias(m, sg, bias_index, fc->bias, fc->out);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+
+    nn_qparam_t in_q = tensor_q(m, sg, op_input(m, sg, op, 0));
+    *out_q = tensor_q(m, sg, op_output(m, sg, op));
+    fc->input_offset = -in_q.zero_point;
+    fc->output_offset = out_q->zero_point;
+    nn_quantize_multiplier((double)in_q.scale * (double)tfl_tensor_scale(&w, 0) / (double)out_q->scale,
+                           &fc->rq);
+
+    uint8_t act = tfl_op_option_byte(&m->tfl, sg, op, TFL_FC_OPT_ACTIVATION, TFL_ACTIVATION_NONE);
+    BIND_CHECK(act == TFL_ACTIVATION_NONE || act == TFL_ACTIVATION_RELU, "FC activation");
+    fc->act_min = act == TFL_ACTIVATION_RELU ? (out_q->zero_point > INT8_MIN ? out_q->zero_point : INT8_MIN) : INT8_MIN;
+    fc->act_max = INT8_MAX;
+    return ESP_OK;
+}
+
+// Parameters of the fused block (nn_bn_fold_t): the exported conv
+// requantization and BN MUL/ADD, per channel. Pooling over accumulators
+// needs every BN scale to be non-negative.
+static void fold_batchnorm(nn_conv_block_t* block) {
+    const nn_conv1d_params_t* conv = &block->conv;
+    nn_bn_fold_t* fold = &block->fold;
+
+    fold->channels = conv->cout;
+    fold->pool = block->pool;
+    fold->conv_offset = conv->output_offset;
+    fold->act_min = conv->act_min;
+    fold->act_max = conv->act_max;
+    fold->mul = block->bn_mul;
+    fold->add = block->bn_add;
+    block->foldable = true;
+    for (int c = 0; c < conv->cout; c++) {
+        fold->conv_rq[c] = conv->rq[c];
+        fold->scale[c] = (int32_t)block->bn_scale[c] + block->bn_mul.input2_offset;
+        if (fold->scale[c] < 0) {
+            block->foldable = false;
+            return;
+        }
+        int32_t b = ((int32_t)block->bn_offset[c] + block->bn_add.input2_offset) * (1 << block->bn_add.left_shift);
+        fold->offset[c] = nn_requantize(b, block->bn_add.input2_rq);
+    }
+}
+
+static esp_err_t bind_conv_block(const nn_model_t* m, int conv_op, nn_conv_block_t* block, int* next_op) {
+    const int sg = MAIN_SUBGRAPH;
+    nn_conv1d_params_t* conv = &block->conv;
+
+    BIND_CHECK(conv_op >= 0, "missing CONV_2D");
+    BIND_CHECK(tfl_op_option_byte(&m->tfl, sg, conv_op, TFL_CONV_OPT_PADDING, TFL_PADDING_SAME) == TFL_PADDING_SAME,
+               "conv padding must be SAME");
+    BIND_CHECK(tfl_op_option_int(&m->tfl, sg, conv_op, TFL_CONV_OPT_STRIDE_W, 1) == 1, "conv stride must be 1");
+
+    tfl_tensor_t x, w;
+    esp_err_t ret = tfl_tensor_get(&m->tfl, sg, op_input(m, sg, conv_op, 0), &x);
+    if (ret == ESP_OK) {
+        ret = tfl_tensor_get(&m->tfl, sg, op_input(m, sg, conv_op, 1), &w);
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    BIND_CHECK(x.ndim == 4 && x.dims[1] == 1, "conv input must be [1, 1, T, C]");
+    BIND_CHECK(w.type == TFL_TYPE_INT8 && w.data != NULL && w.ndim == 4 && w.dims[1] == 1,
+               "conv filter must be int8 [out, 1, k, in]");
+    BIND_CHECK(w.dims[0] <= NN_MAX_CHANNELS && w.dims[3] == x.dims[3], "conv channel mismatch");
+    BIND_CHECK(w.dims[2] <= NN_MAX_KERNEL, "conv kernel too large");
+    BIND_CHECK(w.data_size >= (size_t)tfl_tensor_elements(&w), "conv filter truncated");
+
+    memset(block, 0, sizeof(*block));
+    block->in_len = x.dims[2];
+    conv->cout = w.dims[0];
+    conv->kernel = w.dims[2];
+    conv->cin = w.dims[3];
+    conv->weights = (const int8_t*)w.data;
+    ret = copy_bias(m, sg, op_input(m, sg, conv_op, 2), conv->bias, conv->cout);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    nn_qparam_t in_q = tensor_q(m, sg, op_input(m, sg, conv_op, 0));
+    int32_t conv_out = op_output(m, sg, conv_op);
+    block->conv_q = tensor_q(m, sg, conv_out);
+    conv->input_offset = -in_q.zero_point;
+    conv->output_offset = block->conv_q.zero_point;
+    for (int c = 0; c < conv->cout; c++) {
+        double scale = (double)in_q.scale * (double)tfl_tensor_scale(&w, (size_t)c) / (double)block->conv_q.scale;
+        nn_quantize_multiplier(scale, &conv->rq[c]);
+    }
+
+    uint8_t act = tfl_op_option_byte(&m->tfl, sg, conv_op, TFL_CONV_OPT_ACTIVATION, TFL_ACTIVATION_NONE);
+    BIND_CHECK(act == TFL_ACTIVATION_NONE || act == TFL_ACTIVATION_RELU, "conv activation");
+    conv->act_min = act == TFL_ACTIVATION_RELU ? block->conv_q.zero_point : INT8_MIN;
+    conv->act_max = INT8_MAX;
+
+    // BatchNormalization is exported as a per-channel MUL followed by ADD
+    int mul_op = tfl_find_consumer(&m->tfl, sg, conv_out, TFL_OP_MUL);
+    int mul_const = const_input(m, sg, mul_op);
+    BIND_CHECK(mul_op >= 0 && mul_const >= 0, "missing batchnorm MUL");
+    int32_t scale_index = op_input(m, sg, mul_op, mul_const);
+    tfl_tensor_t bn;
+    ret = tfl_tensor_get(&m->tfl, sg, scale_index, &bn);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    BIND_CHECK(bn.type == TFL_TYPE_INT8 && tfl_tensor_elements(&bn) == conv->cout, "batchnorm scale shape");
+    BIND_CHECK(bn.data != NULL && bn.data_size >= (size_t)tfl_tensor_elements(&bn), "batchnorm scale truncated");
+    block->bn_scale = (const int8_t*)bn.data;
+    int32_t mul_out = op_output(m, sg, mul_op);
+    block->bn_mul_q = tensor_q(m, sg, mul_out);
+    nn_mul_params_init(&block->bn_mul, block->conv_q, tensor_q(m, sg, scale_index), block->bn_mul_q);
+
+    int add_op = tfl_find_consumer(&m->tfl, sg, mul_out, TFL_OP_ADD);
+    int add_const = const_input(m, sg, add_op);
+    BIND_CHECK(add_op >= 0 && add_const >= 0, "missing batchnorm ADD");
+    int32_t offset_index = op_input(m, sg, add_op, add_const);
+    ret = tfl_tensor_get(&m->tfl, sg, offset_index, &bn);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    BIND_CHECK(bn.type == TFL_TYPE_INT8 && tfl_tensor_elements(&bn) == conv->cout, "batchnorm offset shape");
+    BIND_CHECK(bn.data != NULL && bn.data_size >= (size_t)tfl_tensor_elements(&bn), "batchnorm offset truncated");
+    block->bn_offset = (const int8_t*)bn.data;
+    nn_qparam_t add_q = tensor_q(m, sg, op_output(m, sg, add_op));
+    nn_add_params_init(&block->bn_add, block->bn_mul_q, tensor_q(m, sg, offset_index), add_q);
+
+    int pool_op = tfl_find_op(&m->tfl, sg, TFL_OP_MAX_POOL_2D, add_op);
+    BIND_CHECK(pool_op >= 0, "missing MAX_POOL_2D");
+    BIND_CHECK(tfl_op_option_byte(&m->tfl, sg, pool_op, TFL_POOL_OPT_PADDING, TFL_PADDING_SAME) == TFL_PADDING_VALID,
+               "pool padding must be VALID");
+    block->pool = tfl_op_option_int(&m->tfl, sg, pool_op, TFL_POOL_OPT_FILTER_H, 0);
+    BIND_CHECK(block->pool > 0 && block->pool == tfl_op_option_int(&m->tfl, sg, pool_op, TFL_POOL_OPT_STRIDE_H, 0),
+               "pool stride must equal pool size");
+    block->out_len = block->in_len / block->pool;
+    block->out_tensor = op_output(m, sg, pool_op);
+    block->out_q = tensor_q(m, sg, block->out_tensor);
+    BIND_CHECK(nn_qparam_equal(block->out_q, add_q), "pool must preserve quantization");
+
+    fold_batchnorm(block);
+
+    *next_op = pool_op + 1;
+    return ESP_OK;
+}
+
+static esp_err_t bind_lstm(const nn_model_t* m, int while_op, nn_lstm_layer_t* layer) {
+    int sg = tfl_op_option_int(&m->tfl, MAIN_SUBGRAPH, while_op, TFL_WHILE_OPT_BODY, -1);
+    BIND_CHECK(sg > 0 && sg < tfl_subgraph_count(&m->tfl), "LSTM body subgraph");
+
+    memset(layer, 0, sizeof(*layer));
+    int32_t act_out[NN_GATES] = {-1, -1, -1, -1};
+    int input_fc_op[NN_GATES] = {-1, -1, -1, -1};
+    int recurrent_fc_op[NN_GATES] = {-1, -1, -1, -1};
+    int add_op[NN_GATES] = {-1, -1, -1, -1};
+    int sigmoid_count = 0;
+    int32_t sigmoid_out[3];
+    int sigmoid_fc[3], sigmoid_rec[3], sigmoid_add[3];
+
+    // Every gate is FC(x) + FC(h) -> ADD -> LOGISTIC|TANH
+    for (int op = tfl_find_op(&m->tfl, sg, TFL_OP_FULLY_CONNECTED, 0); op >= 0;
+         op = tfl_find_op(&m->tfl, sg, TFL_OP_FULLY_CONNECTED, op + 1)) {
+        if (op_input(m, sg, op, 2) < 0) {
+            continue;  // recurrent projection, reached through its ADD
+        }
+        int add = tfl_find_consumer(&m->tfl, sg, op_output(m, sg, op), TFL_OP_ADD);
+        BIND_CHECK(add >= 0, "LSTM gate ADD");
+        int rec = tfl_find_producer(&m->tfl, sg, other_input(m, sg, add, op_output(m, sg, op)));
+        BIND_CHECK(rec >= 0 && tfl_op_builtin(&m->tfl, sg, rec) == TFL_OP_FULLY_CONNECTED, "LSTM recurrent FC");
+
+        int32_t pre = op_output(m, sg, add);
+        int tanh_op = tfl_find_consumer(&m->tfl, sg, pre, TFL_OP_TANH);
+        int sig_op = tfl_find_consumer(&m->tfl, sg, pre, TFL_OP_LOGISTIC);
+        if (tanh_op >= 0) {
+            BIND_CHECK(act_out[NN_GATE_CELL] < 0, "LSTM has more than one tanh gate");
+            act_out[NN_GATE_CELL] = op_output(m, sg, tanh_op);
+            input_fc_op[NN_GATE_CELL] = op;
+            recurrent_fc_op[NN_GATE_CELL] = rec;
+            add_op[NN_GATE_CELL] = add;
+        } else {
+            BIND_CHECK(sig_op >= 0 && sigmoid_count < 3, "LSTM sigmoid gates");
+            sigmoid_out[sigmoid_count] = op_output(m, sg, sig_op);
+            sigmoid_fc[sigmoid_count] = op;
+            sigmoid_rec[sigmoid_count] = rec;
+            sigmoid_add[sigmoid_count] = add;
+            sigmoid_count++;
+        }
+    }
+    BIND_CHECK(sigmoid_count == 3 && act_out[NN_GATE_CELL] >= 0, "LSTM must have four gates");
+
+    // Tell the sigmoid gates apart by what they multiply:
+    // i * g, f * c_{t-1}, o * tanh(c_t)
+    int update_mul = -1, forget_mul = -1, output_mul = -1;
+    int32_t cell_prev = -1;
+    for (int s = 0; s < 3; s++) {
+        int mul = tfl_find_consumer(&m->tfl, sg, sigmoid_out[s], TFL_OP_MUL);
+        BIND_CHECK(mul >= 0, "LSTM gate MUL");
+        int32_t other = other_input(m, sg, mul, sigmoid_out[s]);
+        int producer = tfl_find_producer(&m->tfl, sg, other);
+        nn_lstm_gate_t gate;
+        if (other == act_out[NN_GATE_CELL]) {
+            gate = NN_GATE_INPUT;
+            update_mul = mul;
+        } else if (producer >= 0 && tfl_op_builtin(&m->tfl, sg, producer) == TFL_OP_TANH) {
+            gate = NN_GATE_OUTPUT;
+            output_mul = mul;
+        } else {
+            gate = NN_GATE_FORGET;
+            forget_mul = mul;
+            cell_prev = other;
+        }
+        BIND_CHECK(act_out[gate] < 0, "LSTM gate assigned twice");
+        act_out[gate] = sigmoid_out[s];
+        input_fc_op[gate] = sigmoid_fc[s];
+        recurrent_fc_op[gate] = sigmoid_rec[s];
+        add_op[gate] = sigmoid_add[s];
+    }
+    BIND_CHECK(update_mul >= 0 && forget_mul >= 0 && output_mul >= 0, "LSTM cell update");
+
+    for (int g = 0; g < NN_GATES; g++) {
+        esp_err_t ret = bind_fc(m, sg, input_fc_op[g], &layer->input_fc[g], &layer->input_fc_q[g]);
+        if (ret == ESP_OK) {
+            ret = bind_fc(m, sg, recurrent_fc_op[g], &layer->recurrent_fc[g], &layer->recurrent_fc_q[g]);
+        }
+        if (ret != ESP_OK) {
+            return ret;
+        }
+
+        nn_qparam_t pre_q = tensor_q(m, sg, op_output(m, sg, add_op[g]));
+        layer->gate_q[g] = tensor_q(m, sg, act_out[g]);
+        nn_add_params_init(&layer->gate_add[g], layer->input_fc_q[g], layer->recurrent_fc_q[g], pre_q);
+        nn_act_params_init(&layer->gate_act[g], g == NN_GATE_CELL ? NN_ACT_TANH : NN_ACT_SIGMOID,
+                           pre_q, layer->gate_q[g]);
+    }
+
+    layer->units = layer->recurrent_fc[0].out;
+    layer->input_size = layer->input_fc[0].in;
+    layer->input_q = tensor_q(m, sg, op_input(m, sg, input_fc_op[0], 0));
+    for (int g = 0; g < NN_GATES; g++) {
+        BIND_CHECK(layer->input_fc[g].out == layer->units && layer->recurrent_fc[g].out == layer->units &&
+                   layer->recurrent_fc[g].in == layer->units && layer->input_fc[g].in == layer->input_size,
+                   "LSTM gate shapes");
+        BIND_CHECK(nn_qparam_equal(tensor_q(m, sg, op_input(m, sg, input_fc_op[g], 0)), layer->input_q),
+                   "LSTM gates must share the input quantization");
+    }
+
+    // Pack the input projections so a whole sequence goes through one GEMM
+    BIND_CHECK(layer->units <= NN_LSTM_MAX_UNITS && layer->input_size <= NN_LSTM_MAX_INPUT, "LSTM too large");
+    BIND_CHECK(nn_gemm_params_pack(&layer->input_gemm, layer->input_fc, NN_GATES, layer->input_packed) == ESP_OK,
+               "LSTM input projection packing");
+
+    layer->cell_state_q = tensor_q(m, sg, cell_prev);
+    layer->forget_q = tensor_q(m, sg, op_output(m, sg, forget_mul));
+    layer->update_q = tensor_q(m, sg, op_output(m, sg, update_mul));
+    nn_mul_params_init(&layer->forget_mul, layer->gate_q[NN_GATE_FORGET], layer->cell_state_q, layer->forget_q);
+    nn_mul_params_init(&layer->update_mul, layer->gate_q[NN_GATE_INPUT], layer->gate_q[NN_GATE_CELL],
+                       layer->update_q);
+
+    int cell_add = tfl_find_consumer(&m->tfl, sg, op_output(m, sg, forget_mul), TFL_OP_ADD);
+    BIND_CHECK(cell_add >= 0, "LSTM cell ADD");
+    int32_t cell = op_output(m, sg, cell_add);
+    layer->cell_q = tensor_q(m, sg, cell);
+    nn_add_params_init(&layer->cell_add, layer->forget_q, layer->update_q, layer->cell_q);
+
+    int cell_tanh = tfl_find_consumer(&m->tfl, sg, cell, TFL_OP_TANH);
+    BIND_CHECK(cell_tanh >= 0, "LSTM cell TANH");
+    layer->cell_tanh_q = tensor_q(m, sg, op_output(m, sg, cell_tanh));
+    nn_act_params_init(&layer->cell_act, NN_ACT_TANH, layer->cell_q, layer->cell_tanh_q);
+
+    layer->hidden_q = tensor_q(m, sg, op_output(m, sg, output_mul));
+    nn_mul_params_init(&layer->output_mul, layer->gate_q[NN_GATE_OUTPUT], layer->cell_tanh_q, layer->hidden_q);
+
+    // h_{t-1} goes through a float round trip between iterations; the engine
+    // keeps it in int8 so the two quantizations must agree
+    nn_qparam_t recurrent_in_q = tensor_q(m, sg, op_input(m, sg, recurrent_fc_op[0], 0));
+    BIND_CHECK(nn_qparam_equal(recurrent_in_q, layer->hidden_q), "LSTM hidden state quantization");
+
+    return ESP_OK;
+}
+
+// The loop emits a float TensorList; it is stacked, quantized and transposed
+// back to int8 [1, steps, units] before the next layer looks at it
+static int32_t lstm_output_tensor(const nn_model_t* m, int while_op, const nn_lstm_layer_t* layer) {
+    const int sg = MAIN_SUBGRAPH;
+    int transpose_op = tfl_find_op(&m->tfl, sg, TFL_OP_TRANSPOSE, while_op + 1);
+    int next_while = tfl_find_op(&m->tfl, sg, TFL_OP_WHILE, while_op + 1);
+    if (transpose_op < 0 || (next_while >= 0 && transpose_op > next_while)) {
+        return -1;
+    }
+    int32_t index = op_output(m, sg, transpose_op);
+    tfl_tensor_t t;
+    if (tfl_tensor_get(&m->tfl, sg, index, &t) != ESP_OK || t.type != TFL_TYPE_INT8 || t.data != NULL ||
+        t.ndim < 2 || t.dims[t.ndim - 1] != layer->units) {
+        return -1;
+    }
+    return index;
+}
+
+static esp_err_t bind_attention(const nn_model_t* m, int start_op, nn_attention_layer_t* att, int* next_op) {
+    const int sg = MAIN_SUBGRAPH;
+    memset(att, 0, sizeof(*att));
+
+    int fc_op = tfl_find_op(&m->tfl, sg, TFL_OP_FULLY_CONNECTED, start_op);
+    esp_err_t ret = bind_fc(m, sg, fc_op, &att->score_fc, &att->score_fc_q);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    BIND_CHECK(att->score_fc.out == 1, "attention score must be scalar per step");
+    att->units = att->score_fc.in;
+    att->input_q = tensor_q(m, sg, op_input(m, sg, fc_op, 0));
+
+    int add_op = tfl_find_op(&m->tfl, sg, TFL_OP_ADD, fc_op);
+    int bias_input = const_input(m, sg, add_op);
+    BIND_CHECK(add_op >= 0 && bias_input >= 0, "attention bias ADD");
+    tfl_tensor_t bias;
+    int32_t bias_index = op_input(m, sg, add_op, bias_input);
+    ret = tfl_tensor_get(&m->tfl, sg, bias_index, &bias);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    BIND_CHECK(bias.type == TFL_TYPE_INT8, "attention bias must be int8");
+    BIND_CHECK(bias.data != NULL && bias.data_size >= (size_t)tfl_tensor_elements(&bias), "attention bias truncated");
+    att->steps = tfl_tensor_elements(&bias);
+    att->bias = (const int8_t*)bias.data;
+    BIND_CHECK(att->steps <= NN_ATTENTION_MAX_STEPS && att->units <= NN_MAX_CHANNELS, "attention size");
+    nn_qparam_t add_q = tensor_q(m, sg, op_output(m, sg, add_op));
+    nn_add_params_init(&att->bias_add, att->score_fc_q, tensor_q(m, sg, bias_index), add_q);
+
+    int tanh_op = tfl_find_op(&m->tfl, sg, TFL_OP_TANH, add_op);
+    BIND_CHECK(tanh_op >= 0, "attention TANH");
+    att->score_q = tensor_q(m, sg, op_output(m, sg, tanh_op));
+    nn_act_params_init(&att->score_act, NN_ACT_TANH, add_q, att->score_q);
+
+    int softmax_op = tfl_find_op(&m->tfl, sg, TFL_OP_SOFTMAX, tanh_op);
+    BIND_CHECK(softmax_op >= 0, "attention SOFTMAX");
+    att->softmax_beta = tfl_op_option_float(&m->tfl, sg, softmax_op, TFL_SOFTMAX_OPT_BETA, 1.0f);
+    att->weight_q = tensor_q(m, sg, op_output(m, sg, softmax_op));
+    nn_softmax_params_init(&att->softmax, att->score_q, att->softmax_beta, att->weight_q);
+
+    int mul_op = tfl_find_op(&m->tfl, sg, TFL_OP_MUL, softmax_op);
+    BIND_CHECK(mul_op >= 0, "attention MUL");
+    att->weighted_q = tensor_q(m, sg, op_output(m, sg, mul_op));
+    BIND_CHECK(nn_qparam_equal(tensor_q(m, sg, op_input(m, sg, mul_op, 0)), att->input_q),
+               "attention MUL must take the LSTM sequence first");
+    nn_mul_params_init(&att->weight_mul, att->input_q, att->weight_q, att->weighted_q);
+
+    int sum_op = tfl_find_op(&m->tfl, sg, TFL_OP_SUM, mul_op);
+    BIND_CHECK(sum_op >= 0, "attention SUM");
+    att->out_tensor = op_output(m, sg, sum_op);
+    att->out_q = tensor_q(m, sg, att->out_tensor);
+
+    *next_op = sum_op + 1;
+    return ESP_OK;
+}
+
+esp_err_t nn_model_load(nn_model_t* model, const uint8_t* data, size_t size) {
+    if (model == NULL || data == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(model, 0, sizeof(*model));
+
+    esp_err_t ret = tfl_model_open(&model->tfl, data, size);
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Invalid TFLite flatbuffer: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    const int sg = MAIN_SUBGRAPH;
+    tfl_tensor_t input;
+    ret = tfl_tensor_get(&model->tfl, sg, tfl_subgraph_input(&model->tfl, sg, 0), &input);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    BIND_CHECK(input.type == TFL_TYPE_INT8 && input.ndim == 3 && input.dims[0] == 1,
+               "input must be int8 [1, T, C]");
+    model->seq_len = input.dims[1];
+    model->features = input.dims[2];
+    model->input_q.scale = tfl_tensor_scale(&input, 0);
+    model->input_q.zero_point = input.zero_point;
+
+    int op = 0;
+    for (int b = 0; b < NN_CONV_BLOCKS; b++) {
+        ret = bind_conv_block(model, tfl_find_op(&model->tfl, sg, TFL_OP_CONV_2D, op), &model->blocks[b], &op);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+
+    for (int l = 0; l < NN_LSTM_LAYERS; l++) {
+        int while_op = tfl_find_op(&model->tfl, sg, TFL_OP_WHILE, op);
+        BIND_CHECK(while_op >= 0, "missing LSTM WHILE loop");
+        ret = bind_lstm(model, while_op, &model->lstm[l]);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        model->lstm[l].steps = model->blocks[NN_CONV_BLOCKS - 1].out_len;
+        model->lstm[l].out_tensor = lstm_output_tensor(model, while_op, &model->lstm[l]);
+        op = while_op + 1;
+    }
+
+    ret = bind_attention(model, op, &model->attention, &op);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    for (int d = 0; d < NN_DENSE_LAYERS; d++) {
+        int fc_op = tfl_find_op(&model->tfl, sg, TFL_OP_FULLY_CONNECTED, op);
+        ret = bind_fc(model, sg, fc_op, &model->dense[d], &model->dense_q[d]);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        model->dense_tensor[d] = op_output(model, sg, fc_op);
+        op = fc_op + 1;
+    }
+
+    int softmax_op = tfl_find_op(&model->tfl, sg, TFL_OP_SOFTMAX, op);
+    BIND_CHECK(softmax_op >= 0, "missing output SOFTMAX");
+    model->softmax_beta = tfl_op_option_float(&model->tfl, sg, softmax_op, TFL_SOFTMAX_OPT_BETA, 1.0f);
+    model->output_tensor = tfl_subgraph_output(&model->tfl, sg, 0);
+    model->output_q = tensor_q(model, sg, model->output_tensor);
+    nn_softmax_params_init(&model->softmax, model->dense_q[NN_DENSE_LAYERS - 1], model->softmax_beta,
+                           model->output_q);
+    model->classes = model->dense[NN_DENSE_LAYERS - 1].out;
+
+    // Fuse the conv blocks whenever every BatchNorm can be folded
+    model->fuse_conv_blocks = true;
+    for (int b = 0; b < NN_CONV_BLOCKS; b++) {
+        model->fuse_conv_blocks = model->fuse_conv_blocks && model->blocks[b].foldable;
+    }
+    // The two-pass attention matches the exported graph; the single-pass one
+    // is enabled by the streaming executor (nn_stream.h)
+    model->online_attention = false;
+
+    // Shape and quantization chain between layers
+    const nn_conv_block_t* last_block = &model->blocks[NN_CONV_BLOCKS - 1];
+    BIND_CHECK(model->blocks[0].in_len == model->seq_len && model->blocks[0].conv.cin == model->features,
+               "first conv does not match the input");
+    BIND_CHECK(nn_qparam_equal(tensor_q(model, sg, tfl_subgraph_input(&model->tfl, sg, 0)), model->input_q),
+               "input quantization");
+    for (int b = 1; b < NN_CONV_BLOCKS; b++) {
+        BIND_CHECK(model->blocks[b].in_len == model->blocks[b - 1].out_len &&
+                   model->blocks[b].conv.cin == model->blocks[b - 1].conv.cout, "conv block shapes");
+        BIND_CHECK(model->blocks[b].conv.input_offset == -model->blocks[b - 1].out_q.zero_point,
+                   "conv block quantization");
+    }
+    BIND_CHECK(model->lstm[0].input_size == last_block->conv.cout, "LSTM input width");
+    BIND_CHECK(nn_qparam_equal(model->lstm[0].input_q, last_block->out_q), "LSTM input quantization");
+    for (int l = 1; l < NN_LSTM_LAYERS; l++) {
+        BIND_CHECK(model->lstm[l].input_size == model->lstm[l - 1].units, "stacked LSTM width");
+        BIND_CHECK(nn_qparam_equal(model->lstm[l].input_q, model->lstm[l - 1].hidden_q),
+                   "stacked LSTM quantization");
+    }
+    const nn_lstm_layer_t* last_lstm = &model->lstm[NN_LSTM_LAYERS - 1];
+    BIND_CHECK(model->attention.steps == last_lstm->steps && model->attention.units == last_lstm->units,
+               "attention shape");
+    BIND_CHECK(nn_qparam_equal(model->attention.input_q, last_lstm->hidden_q), "attention input quantization");
+    BIND_CHECK(model->dense[0].in == model->attention.units, "dense input width");
+    BIND_CHECK(model->dense[0].input_offset == -model->attention.out_q.zero_point, "dense input quantization");
+    for (int d = 1; d < NN_DENSE_LAYERS; d++) {
+        BIND_CHECK(model->dense[d].in == model->dense[d - 1].out &&
+                   model->dense[d].input_offset == -model->dense_q[d - 1].zero_point, "dense chain");
+    }
+
+    return ESP_OK;
+}
+
+void nn_model_print_summary(const nn_model_t* model) {
+    DEBUG_PRINT("Model: input %dx%d int8 (scale %.6f, zp %ld), %d classes",
+                model->seq_len, model->features, model->input_q.scale,
+                (long)model->input_q.zero_point, model->classes);
+    for (int b = 0; b < NN_CONV_BLOCKS; b++) {
+        const nn_conv_block_t* block = &model->blocks[b];
+        DEBUG_PRINT("  Conv1D k=%d %d->%d, BN, MaxPool/%d: %d -> %d steps%s",
+                    block->conv.kernel, block->conv.cin, block->conv.cout,
+                    block->pool, block->in_len, block->out_len,
+                    model->fuse_conv_blocks ? " (fused)" : "");
+    }
+    for (int l = 0; l < NN_LSTM_LAYERS; l++) {
+        DEBUG_PRINT("  LSTM %d->%d over %d steps",
+                    model->lstm[l].input_size, model->lstm[l].units, model->lstm[l].steps);
+    }
+    DEBUG_PRINT("  Attention over %d steps x %d%s", model->attention.steps, model->attention.units,
+                model->online_attention ? " (online)" : "");
+    for (int d = 0; d < NN_DENSE_LAYERS; d++) {
+        DEBUG_PRINT("  Dense %d->%d", model->dense[d].in, model->dense[d].out);
+    }
+}
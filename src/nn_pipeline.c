@@ -0,0 +1,344 @@
+#include "nn_pipeline.h"
+#include "config.h"
+
+#if !defined(ESP_PLATFORM) && !defined(HOST_OSAL)
+#include <sched.h>
+#endif
+
+static size_t align_up(size_t v) {
+    return (v + NN_ARENA_ALIGNMENT - 1) & ~(size_t)(NN_ARENA_ALIGNMENT - 1);
+}
+
+static int last_block_rows(const nn_model_t* model) {
+    const nn_conv_block_t* last = &model->blocks[NN_CONV_BLOCKS - 1];
+    return last->in_len / last->pool;
+}
+
+// Smallest chunk that keeps a whole window inside the queue
+static int chunk_rows(const nn_model_t* model) {
+    int steps = last_block_rows(model);
+    int rows = (steps + NN_PIPELINE_QUEUE_DEPTH - 1) / NN_PIPELINE_QUEUE_DEPTH;
+    return rows > NN_PIPELINE_CHUNK_ROWS ? rows : NN_PIPELINE_CHUNK_ROWS;
+}
+
+// Same placement scheme as nn_stream: buffers back to back after pipeline->arena
+static size_t layout(const nn_model_t* model, nn_pipeline_t* pipeline) {
+    size_t offset = 0;
+
+#define PLACE(ptr, bytes) do { \
+        (ptr) = (int8_t*)((uintptr_t)pipeline->arena + offset); \
+        offset += align_up(bytes); \
+    } while (0)
+
+    for (int b = 0; b < NN_CONV_BLOCKS; b++) {
+        const nn_conv_block_t* block = &model->blocks[b];
+        PLACE(pipeline->block_out[b], (size_t)(block->in_len / block->pool) * block->conv.cout);
+    }
+    PLACE(pipeline->xproj, (size_t)chunk_rows(model) * NN_GATES * model->lstm[0].units);
+    PLACE(pipeline->proj, (size_t)NN_GATES * nn_lstm_max_units(model));
+    for (int l = 0; l < NN_LSTM_LAYERS; l++) {
+        PLACE(pipeline->lstm_h[l], (size_t)model->lstm[l].units);
+        PLACE(pipeline->lstm_cell[l], (size_t)model->lstm[l].units);
+    }
+    PLACE(pipeline->lstm_scratch, (size_t)NN_LSTM_SCRATCH_ROWS * nn_lstm_max_units(model));
+    if (!model->online_attention) {
+        const nn_lstm_layer_t* top = &model->lstm[NN_LSTM_LAYERS - 1];
+        PLACE(pipeline->top_seq, (size_t)top->steps * top->units);
+    }
+
+#undef PLACE
+    nn_head_buffers_place(model, (uint8_t*)((uintptr_t)pipeline->arena + offset), &pipeline->head);
+    offset += align_up(nn_head_buffers_size(model));
+    return offset;
+}
+
+bool nn_pipeline_supported(const nn_model_t* model) {
+    return model != NULL && model->fuse_conv_blocks &&
+           model->lstm[0].steps == last_block_rows(model);
+}
+
+size_t nn_pipeline_arena_size(const nn_model_t* model) {
+    if (!nn_pipeline_supported(model)) {
+        return 0;
+    }
+    nn_pipeline_t sizing = {0};
+    return layout(model, &sizing);
+}
+
+esp_err_t nn_pipeline_init(nn_pipeline_t* pipeline, const nn_model_t* model, uint8_t* arena, size_t arena_size) {
+    if (pipeline == NULL || model == NULL || arena == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!nn_pipeline_supported(model)) {
+        DEBUG_WARN("Pipelined execution needs fused conv blocks");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    size_t required = nn_pipeline_arena_size(model);
+    if (arena_size < required) {
+        DEBUG_ERROR("Pipeline arena too small: %zu < %zu", arena_size, required);
+        return ESP_ERR_NO_MEM;
+    }
+
+    memset(pipeline, 0, sizeof(*pipeline));
+    pipeline->model = model;
+    pipeline->arena = arena;
+    pipeline->arena_size = arena_size;
+    pipeline->chunk_rows = chunk_rows(model);
+    pipeline->steps = last_block_rows(model);
+    layout(model, pipeline);
+
+    esp_err_t ret = spsc_ring_init(&pipeline->queue, pipeline->queue_storage,
+                                   sizeof(nn_pipeline_chunk_t), NN_PIPELINE_QUEUE_DEPTH);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Idle: window 0 is completely published and consumed
+    for (int b = 0; b < NN_CONV_BLOCKS; b++) {
+        const nn_conv_block_t* block = &model->blocks[b];
+        pipeline->block_rows[b] = block->in_len / block->pool;
+    }
+    pipeline->back_rows = pipeline->steps;
+    atomic_init(&pipeline->front_done, 0);
+    atomic_init(&pipeline->submitted, 0);
+    return ESP_OK;
+}
+
+void nn_pipeline_set_front_worker(nn_pipeline_t* pipeline, nn_pipeline_notify_fn_t notify, void* ctx) {
+    if (pipeline == NULL) {
+        return;
+    }
+    pipeline->front_notify = notify;
+    pipeline->front_ctx = ctx;
+}
+
+// Makes pooled rows [0, rows) of block b final, first computing the rows of
+// block b - 1 they read
+static void front_produce(nn_pipeline_t* pipeline, int b, int rows) {
+    const nn_conv_block_t* block = &pipeline->model->blocks[b];
+    int done = pipeline->block_rows[b];
+    if (rows <= done) {
+        return;
+    }
+
+    const int8_t* in = pipeline->input;
+    if (b > 0) {
+        // SAME padding: the last position of a pool window looks ahead
+        int lookahead = block->conv.kernel - 1 - (block->conv.kernel - 1) / 2;
+        int need = rows * block->pool + lookahead;
+        front_produce(pipeline, b - 1, need < block->in_len ? need : block->in_len);
+        in = pipeline->block_out[b - 1];
+    }
+
+    nn_conv_bn_relu_pool_rows_s8(&block->conv, &block->fold, in, block->in_len, done, rows - done,
+                                 pipeline->block_out[b]);
+    pipeline->block_rows[b] = rows;
+}
+
+bool nn_pipeline_front_step(nn_pipeline_t* pipeline) {
+    if (pipeline == NULL || pipeline->model == NULL) {
+        return false;
+    }
+
+    // The acquire pairs with nn_pipeline_begin(): input is set for this window
+    uint32_t window = atomic_load_explicit(&pipeline->submitted, memory_order_acquire);
+    if (window != pipeline->front_window) {
+        pipeline->front_window = window;
+        for (int b = 0; b < NN_CONV_BLOCKS; b++) {
+            pipeline->block_rows[b] = 0;
+        }
+    }
+
+    const int last = NN_CONV_BLOCKS - 1;
+    int first = pipeline->block_rows[last];
+    if (first >= pipeline->steps) {
+        return false;
+    }
+
+    int64_t start = esp_timer_get_time();
+    int rows = pipeline->steps - first < pipeline->chunk_rows ? pipeline->steps - first : pipeline->chunk_rows;
+    front_produce(pipeline, last, first + rows);
+
+    // Never full: a whole window fits in the queue and one window is in flight
+    nn_pipeline_chunk_t chunk = { .window = window, .first_row = (uint16_t)first, .rows = (uint16_t)rows };
+    spsc_ring_push(&pipeline->queue, &chunk);
+
+    nn_pipeline_stage_stats_t* stats = &pipeline->stats.front;
+    stats->chunks++;
+    if (first + rows == pipeline->steps) {
+        stats->windows++;
+        atomic_store_explicit(&pipeline->front_done, window, memory_order_release);
+    }
+    stats->busy_us += (uint64_t)(esp_timer_get_time() - start);
+    return true;
+}
+
+esp_err_t nn_pipeline_begin(nn_pipeline_t* pipeline, const int8_t* input) {
+    if (pipeline == NULL || pipeline->model == NULL || input == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t window = atomic_load_explicit(&pipeline->submitted, memory_order_relaxed);
+    if (pipeline->back_rows < pipeline->steps ||
+        atomic_load_explicit(&pipeline->front_done, memory_order_acquire) != window) {
+        DEBUG_ERROR("Pipeline busy with window %lu", (unsigned long)window);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    const nn_model_t* model = pipeline->model;
+    pipeline->window_start_us = esp_timer_get_time();
+    if (pipeline->stats.started_us == 0) {
+        pipeline->stats.started_us = pipeline->window_start_us;
+    }
+    for (int l = 0; l < NN_LSTM_LAYERS; l++) {
+        nn_lstm_reset_state(&model->lstm[l], pipeline->lstm_h[l], pipeline->lstm_cell[l]);
+    }
+    nn_attention_begin(&pipeline->attention);
+    pipeline->back_rows = 0;
+
+    pipeline->input = input;
+    atomic_store_explicit(&pipeline->submitted, window + 1, memory_order_release);
+    if (pipeline->front_notify != NULL) {
+        pipeline->front_notify(pipeline->front_ctx);
+    }
+    return ESP_OK;
+}
+
+// Advances the LSTM stack and the attention over the rows of one chunk
+static void back_run_chunk(nn_pipeline_t* pipeline, const nn_pipeline_chunk_t* chunk) {
+    const nn_model_t* model = pipeline->model;
+    const nn_lstm_layer_t* bottom = &model->lstm[0];
+    const int8_t* x = pipeline->block_out[NN_CONV_BLOCKS - 1] + (size_t)chunk->first_row * bottom->input_size;
+
+    nn_gemm_s8(&bottom->input_gemm, x, chunk->rows, pipeline->xproj);
+
+    for (int r = 0; r < chunk->rows; r++) {
+        const int8_t* proj = pipeline->xproj + (size_t)r * NN_GATES * bottom->units;
+        for (int l = 0; l < NN_LSTM_LAYERS; l++) {
+            const nn_lstm_layer_t* layer = &model->lstm[l];
+            if (l > 0) {
+                nn_gemm_s8(&layer->input_gemm, pipeline->lstm_h[l - 1], 1, pipeline->proj);
+                proj = pipeline->proj;
+            }
+            nn_lstm_step_projected(layer, proj, pipeline->lstm_h[l], pipeline->lstm_cell[l],
+                                   pipeline->lstm_scratch, pipeline->lstm_h[l]);
+        }
+        const nn_lstm_layer_t* top = &model->lstm[NN_LSTM_LAYERS - 1];
+        const int8_t* h = pipeline->lstm_h[NN_LSTM_LAYERS - 1];
+        if (model->online_attention) {
+            nn_attention_push(&model->attention, &pipeline->attention, h);
+        } else {
+            memcpy(pipeline->top_seq + (size_t)(chunk->first_row + r) * top->units, h, top->units);
+        }
+    }
+    pipeline->back_rows += chunk->rows;
+}
+
+static void wait_for_front(void) {
+#if defined(ESP_PLATFORM) || defined(HOST_OSAL)
+    taskYIELD();
+#else
+    sched_yield();
+#endif
+}
+
+esp_err_t nn_pipeline_finish(nn_pipeline_t* pipeline, int8_t* output) {
+    if (pipeline == NULL || pipeline->model == NULL || output == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t window = atomic_load_explicit(&pipeline->submitted, memory_order_relaxed);
+    nn_pipeline_stage_stats_t* stats = &pipeline->stats.back;
+    int64_t wait_start = 0;
+
+    while (pipeline->back_rows < pipeline->steps) {
+        nn_pipeline_chunk_t chunk;
+        if (!spsc_ring_pop(&pipeline->queue, &chunk)) {
+            if (pipeline->front_notify == NULL) {
+                nn_pipeline_front_step(pipeline);
+                continue;
+            }
+            int64_t now = esp_timer_get_time();
+            if (wait_start == 0) {
+                wait_start = now;
+            } else if (now - wait_start > NN_PIPELINE_TIMEOUT_US) {
+                DEBUG_ERROR("Pipeline front stage stalled at row %d of window %lu",
+                            pipeline->back_rows, (unsigned long)window);
+                return ESP_ERR_TIMEOUT;
+            }
+            wait_for_front();
+            continue;
+        }
+
+        int64_t start = esp_timer_get_time();
+        if (wait_start != 0) {
+            stats->wait_us += (uint64_t)(start - wait_start);
+            wait_start = 0;
+        }
+        if (chunk.window != window || chunk.first_row != pipeline->back_rows) {
+            DEBUG_ERROR("Pipeline chunk out of order: window %lu row %u, expected window %lu row %d",
+                        (unsigned long)chunk.window, chunk.first_row, (unsigned long)window, pipeline->back_rows);
+            return ESP_FAIL;
+        }
+        back_run_chunk(pipeline, &chunk);
+        stats->chunks++;
+        stats->busy_us += (uint64_t)(esp_timer_get_time() - start);
+    }
+
+    int64_t start = esp_timer_get_time();
+    if (pipeline->model->online_attention) {
+        nn_attention_finish(&pipeline->model->attention, &pipeline->attention, pipeline->head.context);
+        nn_run_dense(pipeline->model, &pipeline->head, output);
+    } else {
+        nn_run_head(pipeline->model, pipeline->top_seq, &pipeline->head, output);
+    }
+    int64_t end = esp_timer_get_time();
+
+    stats->busy_us += (uint64_t)(end - start);
+    stats->windows++;
+    pipeline->stats.window_us += (uint64_t)(end - pipeline->window_start_us);
+    return ESP_OK;
+}
+
+esp_err_t nn_pipeline_invoke(nn_pipeline_t* pipeline, const int8_t* input, int8_t* output) {
+    esp_err_t ret = nn_pipeline_begin(pipeline, input);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return nn_pipeline_finish(pipeline, output);
+}
+
+void nn_pipeline_reset_stats(nn_pipeline_t* pipeline) {
+    if (pipeline != NULL) {
+        memset(&pipeline->stats, 0, sizeof(pipeline->stats));
+    }
+}
+
+static float percent(uint64_t part, uint64_t whole) {
+    return whole > 0 ? 100.0f * (float)part / (float)whole : 0.0f;
+}
+
+void nn_pipeline_print_stats(const nn_pipeline_t* pipeline) {
+    if (pipeline == NULL || pipeline->model == NULL) {
+        return;
+    }
+    const nn_pipeline_stats_t* s = &pipeline->stats;
+    uint32_t windows = s->back.windows;
+    if (windows == 0) {
+        DEBUG_PRINT("Pipeline: no windows yet");
+        return;
+    }
+    uint64_t elapsed = (uint64_t)(esp_timer_get_time() - s->started_us);
+
+    // Window share: how much of the in-flight time each core computes.
+    // Elapsed share: duty cycle of each core since the first window.
+    DEBUG_PRINT("Pipeline (%d-row chunks): %lu windows, %.1f us/window",
+                pipeline->chunk_rows, (unsigned long)windows, (double)s->window_us / windows);
+    DEBUG_PRINT("  Front: busy %.1f us/window, %.1f%% of window, %.2f%% of elapsed, %lu chunks",
+                (double)s->front.busy_us / windows, percent(s->front.busy_us, s->window_us),
+                percent(s->front.busy_us, elapsed), (unsigned long)s->front.chunks);
+    DEBUG_PRINT("  Back: busy %.1f us/window, %.1f%% of window, %.2f%% of elapsed, waited %.1f us/window",
+                (double)s->back.busy_us / windows, percent(s->back.busy_us, s->window_us),
+                percent(s->back.busy_us, elapsed), (double)s->back.wait_us / windows);
+    DEBUG_PRINT("  Overlap: %.2fx (busy time of both stages / window time)",
+                s->window_us > 0 ? (double)(s->front.busy_us + s->back.busy_us) / s->window_us : 0.0);
+}
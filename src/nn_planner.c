@@ -0,0 +1,147 @@
+#include "nn_planner.h"
+#include "config.h"
+
+static size_t align_to(size_t v, size_t alignment) {
+    return (v + alignment - 1) / alignment * alignment;
+}
+
+static bool lifetimes_overlap(int first_a, int last_a, int first_b, int last_b) {
+    return first_a <= last_b && first_b <= last_a;
+}
+
+esp_err_t nn_plan_arena(nn_plan_buffer_t* buffers, int count, size_t alignment, nn_plan_report_t* report) {
+    if (buffers == NULL || count < 0 || count > NN_PLAN_MAX_BUFFERS || alignment == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // A slot is a buffer plus every buffer that (transitively) overwrites it
+    int root[NN_PLAN_MAX_BUFFERS];
+    size_t slot_size[NN_PLAN_MAX_BUFFERS] = {0};
+    int slot_first[NN_PLAN_MAX_BUFFERS];
+    int slot_last[NN_PLAN_MAX_BUFFERS];
+    size_t slot_offset[NN_PLAN_MAX_BUFFERS] = {0};
+    size_t naive = 0;
+
+    for (int i = 0; i < count; i++) {
+        const nn_plan_buffer_t* b = &buffers[i];
+        if (b->first > b->last) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (b->inplace != NN_PLAN_NONE) {
+            // Must reference an earlier buffer that is dead once this one is produced
+            if (b->inplace < 0 || b->inplace >= i || buffers[b->inplace].last > b->first) {
+                DEBUG_ERROR("Invalid in-place buffer %s", b->name ? b->name : "?");
+                return ESP_ERR_INVALID_ARG;
+            }
+            root[i] = root[b->inplace];
+        } else {
+            root[i] = i;
+            slot_first[i] = b->first;
+            slot_last[i] = b->last;
+        }
+
+        int r = root[i];
+        size_t size = align_to(b->size, alignment);
+        naive += size;
+        if (size > slot_size[r]) {
+            slot_size[r] = size;
+        }
+        if (b->first < slot_first[r]) {
+            slot_first[r] = b->first;
+        }
+        if (b->last > slot_last[r]) {
+            slot_last[r] = b->last;
+        }
+    }
+
+    // Largest slots first; ties keep declaration order
+    int order[NN_PLAN_MAX_BUFFERS];
+    int slots = 0;
+    for (int i = 0; i < count; i++) {
+        if (root[i] != i) {
+            continue;
+        }
+        int pos = slots++;
+        while (pos > 0 && slot_size[order[pos - 1]] < slot_size[i]) {
+            order[pos] = order[pos - 1];
+            pos--;
+        }
+        order[pos] = i;
+    }
+
+    size_t arena = 0;
+    for (int n = 0; n < slots; n++) {
+        int s = order[n];
+        size_t offset = 0;
+        bool moved = true;
+
+        // Lowest offset clear of every placed slot whose lifetime intersects
+        while (moved) {
+            moved = false;
+            for (int p = 0; p < n; p++) {
+                int o = order[p];
+                if (!lifetimes_overlap(slot_first[s], slot_last[s], slot_first[o], slot_last[o])) {
+                    continue;
+                }
+                if (offset < slot_offset[o] + slot_size[o] && slot_offset[o] < offset + slot_size[s]) {
+                    offset = slot_offset[o] + slot_size[o];
+                    moved = true;
+                }
+            }
+        }
+
+        slot_offset[s] = offset;
+        if (offset + slot_size[s] > arena) {
+            arena = offset + slot_size[s];
+        }
+    }
+
+    int first_step = 0;
+    int last_step = -1;
+    for (int i = 0; i < count; i++) {
+        buffers[i].offset = slot_offset[root[i]];
+        if (i == 0 || buffers[i].first < first_step) {
+            first_step = buffers[i].first;
+        }
+        if (buffers[i].last > last_step) {
+            last_step = buffers[i].last;
+        }
+    }
+
+    size_t peak = 0;
+    for (int step = first_step; step <= last_step; step++) {
+        size_t live = 0;
+        for (int n = 0; n < slots; n++) {
+            int s = order[n];
+            if (slot_first[s] <= step && step <= slot_last[s]) {
+                live += slot_size[s];
+            }
+        }
+        if (live > peak) {
+            peak = live;
+        }
+    }
+
+    if (report != NULL) {
+        report->arena_size = arena;
+        report->peak_live = peak;
+        report->naive_size = naive;
+        report->buffers = count;
+    }
+    return ESP_OK;
+}
+
+void nn_plan_print(const nn_plan_buffer_t* buffers, int count, const nn_plan_report_t* report) {
+    if (buffers == NULL || report == NULL) {
+        return;
+    }
+
+    DEBUG_PRINT("Arena plan: %zu bytes (peak live %zu, no reuse %zu)",
+                report->arena_size, report->peak_live, report->naive_size);
+    for (int i = 0; i < count; i++) {
+        const nn_plan_buffer_t* b = &buffers[i];
+        DEBUG_PRINT("  %-14s %6zu bytes @ %6zu  steps %d-%d%s",
+                    b->name ? b->name : "?", b->size, b->offset, b->first, b->last,
+                    b->inplace != NN_PLAN_NONE ? " (in place)" : "");
+    }
+}
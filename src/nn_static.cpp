@@ -0,0 +1,53 @@
+#include "nn_static.h"
+#include "nn_static.hpp"
+#include "config.h"
+
+// Not found next to this file on purpose: the host build puts the header it
+// generates from the current model ahead of the checked-in src/ copy
+#include <nn_static_model.h>
+
+using StaticGraph = nn_static_model::Graph;
+
+extern "C" {
+
+const char* nn_static_shape(void) {
+    return NN_STATIC_MODEL_SHAPE;
+}
+
+bool nn_static_matches(const nn_model_t* model) {
+    return model != NULL && StaticGraph::matches(*model);
+}
+
+size_t nn_static_arena_size(void) {
+    return StaticGraph::arena_size;
+}
+
+esp_err_t nn_static_init(nn_static_engine_t* engine, const nn_model_t* model, uint8_t* arena, size_t arena_size) {
+    if (engine == NULL || model == NULL || arena == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!StaticGraph::matches(*model)) {
+        DEBUG_WARN("Model does not match the generated kernels (%s)", NN_STATIC_MODEL_SHAPE);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (arena_size < StaticGraph::arena_size) {
+        DEBUG_ERROR("Tensor arena too small: %zu < %zu", arena_size, StaticGraph::arena_size);
+        return ESP_ERR_NO_MEM;
+    }
+
+    engine->model = model;
+    engine->arena = arena;
+    engine->arena_size = arena_size;
+    StaticGraph::bind(*model, engine->tables);
+    return ESP_OK;
+}
+
+esp_err_t nn_static_invoke(nn_static_engine_t* engine, const int8_t* input, int8_t* output) {
+    if (engine == NULL || engine->model == NULL || input == NULL || output == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    StaticGraph::invoke(*engine->model, engine->tables, engine->arena, input, output);
+    return ESP_OK;
+}
+
+}
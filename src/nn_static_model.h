@@ -0,0 +1,30 @@
+// Generated by host/model_codegen from the built-in model (src/fall_detection_model.h)
+// (59600 bytes, CRC-32 baa71b04). Do not edit; regenerate with
+//   model_codegen [model.tflite] src/nn_static_model.h
+
+#ifndef NN_STATIC_MODEL_H
+#define NN_STATIC_MODEL_H
+
+#define NN_STATIC_MODEL_CRC32 0xbaa71b04u
+#define NN_STATIC_MODEL_SHAPE "301x6 k3/3 16/32 lstm 32/16 att 75 dense 32 -> 5"
+#define NN_STATIC_INTERPRETER_ARENA 12704
+
+#ifdef __cplusplus
+
+namespace nn_static_model {
+
+using Graph = nn_static::Graph<
+    nn_static::ConvBlock<nn_static::Conv1D<int8_t, 3, 6, 16>, 301, 2>,
+    nn_static::ConvBlock<nn_static::Conv1D<int8_t, 3, 16, 32>, 150, 2>,
+    nn_static::Lstm<int8_t, 32, 32>,
+    nn_static::Lstm<int8_t, 32, 16>,
+    nn_static::Attention<int8_t, 75, 16>,
+    nn_static::Dense<16, 32>,
+    nn_static::Dense<32, 5>,
+    NN_STATIC_INTERPRETER_ARENA>;
+
+} // namespace nn_static_model
+
+#endif // __cplusplus
+
+#endif // NN_STATIC_MODEL_H
@@ -0,0 +1,201 @@
+#include "nn_stream.h"
+#include "config.h"
+
+static size_t align_up(size_t v) {
+    return (v + NN_ARENA_ALIGNMENT - 1) & ~(size_t)(NN_ARENA_ALIGNMENT - 1);
+}
+
+// Same placement scheme as nn_engine: state back to back after stream->arena
+static size_t layout(const nn_model_t* model, nn_stream_t* stream) {
+    size_t offset = 0;
+
+#define PLACE(ptr, bytes) do { \
+        (ptr) = (int8_t*)((uintptr_t)stream->arena + offset); \
+        offset += align_up(bytes); \
+    } while (0)
+
+    for (int b = 0; b < NN_CONV_BLOCKS; b++) {
+        const nn_conv1d_params_t* conv = &model->blocks[b].conv;
+        PLACE(stream->conv_history[b], (size_t)conv->kernel * conv->cin);
+        PLACE(stream->pool_max[b], (size_t)conv->cout);
+        if (model->fuse_conv_blocks) {
+            int8_t* acc;
+            PLACE(acc, (size_t)conv->cout * sizeof(int32_t));
+            stream->pool_acc[b] = (int32_t*)acc;
+        } else {
+            PLACE(stream->conv_out[b], (size_t)conv->cout);
+        }
+    }
+    for (int l = 0; l < NN_LSTM_LAYERS; l++) {
+        PLACE(stream->lstm_h[l], (size_t)model->lstm[l].units);
+        PLACE(stream->lstm_cell[l], (size_t)model->lstm[l].units);
+    }
+    PLACE(stream->lstm_scratch, (size_t)NN_LSTM_SCRATCH_ROWS * nn_lstm_max_units(model));
+    PLACE(stream->history, (size_t)2 * model->attention.steps * model->attention.units);
+
+#undef PLACE
+    nn_head_buffers_place(model, (uint8_t*)((uintptr_t)stream->arena + offset), &stream->head);
+    offset += align_up(nn_head_buffers_size(model));
+    return offset;
+}
+
+size_t nn_stream_arena_size(const nn_model_t* model) {
+    if (model == NULL) {
+        return 0;
+    }
+    nn_stream_t sizing = {0};
+    return layout(model, &sizing);
+}
+
+esp_err_t nn_stream_init(nn_stream_t* stream, const nn_model_t* model, uint8_t* arena, size_t arena_size) {
+    if (stream == NULL || model == NULL || arena == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t required = nn_stream_arena_size(model);
+    if (arena_size < required) {
+        DEBUG_ERROR("Stream arena too small: %zu < %zu", arena_size, required);
+        return ESP_ERR_NO_MEM;
+    }
+
+    memset(stream, 0, sizeof(*stream));
+    stream->model = model;
+    stream->arena = arena;
+    stream->arena_size = arena_size;
+    layout(model, stream);
+    nn_stream_reset(stream);
+    return ESP_OK;
+}
+
+void nn_stream_reset(nn_stream_t* stream) {
+    if (stream == NULL || stream->model == NULL) {
+        return;
+    }
+    const nn_model_t* model = stream->model;
+
+    for (int b = 0; b < NN_CONV_BLOCKS; b++) {
+        stream->conv_rows[b] = 0;
+        stream->pool_phase[b] = 0;
+    }
+    for (int l = 0; l < NN_LSTM_LAYERS; l++) {
+        nn_lstm_reset_state(&model->lstm[l], stream->lstm_h[l], stream->lstm_cell[l]);
+    }
+    stream->history_pos = 0;
+    stream->history_count = 0;
+    stream->samples = 0;
+    stream->steps = 0;
+}
+
+// Feeds one input row to a conv block. Returns true with *out set when the
+// block completes a pooled output row.
+static bool push_conv_block(nn_stream_t* stream, int b, const int8_t* row, const int8_t** out) {
+    const nn_conv_block_t* block = &stream->model->blocks[b];
+    const nn_conv1d_params_t* conv = &block->conv;
+    const int k = conv->kernel;
+    const int pad = (k - 1) / 2;
+    const int lookahead = k - 1 - pad;
+    int8_t* history = stream->conv_history[b];
+
+    memmove(history, history + conv->cin, (size_t)(k - 1) * conv->cin);
+    memcpy(history + (size_t)(k - 1) * conv->cin, row, (size_t)conv->cin);
+    int32_t newest = (int32_t)stream->conv_rows[b]++;
+
+    // SAME padding: output position o needs inputs up to o + lookahead
+    int32_t o = newest - lookahead;
+    if (o < 0) {
+        return false;
+    }
+
+    // History row j holds input newest - (k - 1) + j == o - pad + j
+    const int8_t* taps[NN_MAX_KERNEL];
+    for (int j = 0; j < k; j++) {
+        taps[j] = (o - pad + j < 0) ? NULL : history + (size_t)j * conv->cin;
+    }
+    int8_t* pool = stream->pool_max[b];
+    if (stream->model->fuse_conv_blocks) {
+        // Max over accumulators; BN and ReLU once per pooled row
+        int32_t acc[NN_MAX_CHANNELS];
+        int32_t* best = stream->pool_acc[b];
+        nn_conv1d_acc_s8(conv, taps, stream->pool_phase[b] == 0 ? best : acc);
+        for (int c = 0; stream->pool_phase[b] > 0 && c < conv->cout; c++) {
+            if (acc[c] > best[c]) {
+                best[c] = acc[c];
+            }
+        }
+        if (stream->pool_phase[b] == block->pool - 1) {
+            nn_bn_fold_apply_s8(&block->fold, best, pool);
+        }
+    } else {
+        nn_conv1d_step_s8(conv, taps, stream->conv_out[b]);
+        nn_conv_block_bn(block, stream->conv_out[b], conv->cout);
+        if (stream->pool_phase[b] == 0) {
+            memcpy(pool, stream->conv_out[b], (size_t)conv->cout);
+        } else {
+            for (int c = 0; c < conv->cout; c++) {
+                if (stream->conv_out[b][c] > pool[c]) {
+                    pool[c] = stream->conv_out[b][c];
+                }
+            }
+        }
+    }
+
+    if (++stream->pool_phase[b] < block->pool) {
+        return false;
+    }
+    stream->pool_phase[b] = 0;
+    *out = pool;
+    return true;
+}
+
+esp_err_t nn_stream_push(nn_stream_t* stream, const int8_t* sample) {
+    if (stream == NULL || stream->model == NULL || sample == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const nn_model_t* model = stream->model;
+    stream->samples++;
+
+    const int8_t* x = sample;
+    for (int b = 0; b < NN_CONV_BLOCKS; b++) {
+        if (!push_conv_block(stream, b, x, &x)) {
+            return ESP_OK;
+        }
+    }
+
+    for (int l = 0; l < NN_LSTM_LAYERS; l++) {
+        nn_lstm_step(&model->lstm[l], x, stream->lstm_h[l], stream->lstm_cell[l],
+                     stream->lstm_scratch, stream->lstm_h[l]);
+        x = stream->lstm_h[l];
+    }
+    stream->steps++;
+
+    // Mirrored ring: row i is also stored at i + steps, so the latest
+    // `steps` rows are always contiguous starting at history_pos
+    const uint32_t steps = (uint32_t)model->attention.steps;
+    const size_t units = (size_t)model->attention.units;
+    memcpy(stream->history + stream->history_pos * units, x, units);
+    memcpy(stream->history + (stream->history_pos + steps) * units, x, units);
+    stream->history_pos = (stream->history_pos + 1) % steps;
+    if (stream->history_count < steps) {
+        stream->history_count++;
+    }
+
+    return ESP_OK;
+}
+
+bool nn_stream_ready(const nn_stream_t* stream) {
+    return stream != NULL && stream->model != NULL &&
+           stream->history_count >= (uint32_t)stream->model->attention.steps;
+}
+
+esp_err_t nn_stream_evaluate(nn_stream_t* stream, int8_t* output) {
+    if (stream == NULL || stream->model == NULL || output == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!nn_stream_ready(stream)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    const int8_t* seq = stream->history + (size_t)stream->history_pos * stream->model->attention.units;
+    nn_run_head(stream->model, seq, &stream->head, output);
+    return ESP_OK;
+}
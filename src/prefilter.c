@@ -0,0 +1,173 @@
+#include "prefilter.h"
+
+#define ONE_G_MG 1000
+
+prefilter_t g_prefilter = {0};
+
+static uint32_t isqrt32(uint32_t v) {
+    uint32_t root = 0;
+    uint32_t bit = 1u << 30;
+
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+static int32_t clamp_axis(int32_t v, int32_t limit) {
+    return v < -limit ? -limit : (v > limit ? limit : v);
+}
+
+void prefilter_init(prefilter_t* pf) {
+    if (pf == NULL) {
+        return;
+    }
+    memset(pf, 0, sizeof(*pf));
+    // Run the model on the very first window
+    pf->idle_windows = PREFILTER_KEEPALIVE_WINDOWS;
+    pf->gating = true;
+}
+
+void prefilter_push(prefilter_t* pf, int32_t ax_mg, int32_t ay_mg, int32_t az_mg,
+                    int32_t gx_ddps, int32_t gy_ddps, int32_t gz_ddps) {
+    if (pf == NULL) {
+        return;
+    }
+
+    // Clamp to the sensor's widest ranges (16 g, 2000 dps) so squares fit
+    ax_mg = clamp_axis(ax_mg, 16000);
+    ay_mg = clamp_axis(ay_mg, 16000);
+    az_mg = clamp_axis(az_mg, 16000);
+    gx_ddps = clamp_axis(gx_ddps, 20000);
+    gy_ddps = clamp_axis(gy_ddps, 20000);
+    gz_ddps = clamp_axis(gz_ddps, 20000);
+
+    uint32_t mag2 = (uint32_t)(ax_mg * ax_mg) + (uint32_t)(ay_mg * ay_mg) + (uint32_t)(az_mg * az_mg);
+    pf->stats.samples++;
+
+    // Free fall: sustained dip of |a| towards 0 g
+    if (mag2 < (uint32_t)PREFILTER_FREEFALL_MG * PREFILTER_FREEFALL_MG) {
+        if (++pf->freefall_run == PREFILTER_FREEFALL_SAMPLES) {
+            pf->pending |= PREFILTER_TRIGGER_FREEFALL;
+            pf->stats.freefall_events++;
+        }
+    } else {
+        pf->freefall_run = 0;
+    }
+
+    // Impact: rising edge of |a| above the threshold
+    bool impact = mag2 > (uint32_t)PREFILTER_IMPACT_MG * PREFILTER_IMPACT_MG;
+    if (impact && !pf->in_impact) {
+        pf->pending |= PREFILTER_TRIGGER_IMPACT;
+        pf->stats.impact_events++;
+    }
+    pf->in_impact = impact;
+
+    uint32_t mag = isqrt32(mag2);
+    pf->dynamic_sum_mg += mag > ONE_G_MG ? mag - ONE_G_MG : ONE_G_MG - mag;
+    pf->gyro_energy += (uint64_t)((uint32_t)(gx_ddps * gx_ddps) + (uint32_t)(gy_ddps * gy_ddps)) +
+                       (uint32_t)(gz_ddps * gz_ddps);
+    pf->hop_samples++;
+}
+
+uint32_t prefilter_end_window(prefilter_t* pf) {
+    if (pf == NULL) {
+        return PREFILTER_TRIGGER_ALWAYS;
+    }
+
+    uint32_t trigger = pf->pending;
+
+    if (pf->hop_samples > 0) {
+        uint32_t activity = pf->dynamic_sum_mg / pf->hop_samples;
+        uint32_t delta = activity > pf->last_activity_mg ? activity - pf->last_activity_mg
+                                                         : pf->last_activity_mg - activity;
+        if (delta > PREFILTER_ACTIVITY_DELTA_MG) {
+            trigger |= PREFILTER_TRIGGER_ACTIVITY;
+            pf->stats.activity_windows++;
+        }
+        pf->last_activity_mg = activity;
+
+        uint64_t gyro_ms = pf->gyro_energy / pf->hop_samples;
+        if (gyro_ms > (uint64_t)(PREFILTER_GYRO_RMS_DPS * 10) * (PREFILTER_GYRO_RMS_DPS * 10)) {
+            trigger |= PREFILTER_TRIGGER_GYRO;
+            pf->stats.gyro_windows++;
+        }
+    }
+
+    // Keep the model running while the event passes through the window
+    if (trigger & PREFILTER_EVENT_MASK) {
+        pf->hold_windows = PREFILTER_HOLD_WINDOWS;
+    } else if (pf->hold_windows > 0) {
+        pf->hold_windows--;
+        trigger |= PREFILTER_TRIGGER_HOLD;
+    }
+
+    if (trigger == PREFILTER_TRIGGER_NONE && ++pf->idle_windows >= PREFILTER_KEEPALIVE_WINDOWS) {
+        trigger |= PREFILTER_TRIGGER_KEEPALIVE;
+        pf->stats.keepalive_windows++;
+    }
+    if (trigger != PREFILTER_TRIGGER_NONE) {
+        pf->idle_windows = 0;
+    }
+
+#if !PREFILTER_ENABLE
+    trigger |= PREFILTER_TRIGGER_ALWAYS;
+#endif
+
+    // Under the other cadences the model runs regardless of the trigger,
+    // and the cadence counts the runs (print_inference_metrics)
+    pf->stats.windows++;
+    if (pf->gating) {
+        if (trigger != PREFILTER_TRIGGER_NONE) {
+            pf->stats.executed++;
+        } else {
+            pf->stats.skipped++;
+        }
+    }
+
+    pf->pending = 0;
+    pf->hop_samples = 0;
+    pf->dynamic_sum_mg = 0;
+    pf->gyro_energy = 0;
+    return trigger;
+}
+
+void prefilter_set_gating(prefilter_t* pf, bool gating) {
+    if (pf != NULL) {
+        pf->gating = gating;
+    }
+}
+
+void prefilter_print_stats(const prefilter_t* pf) {
+    if (pf == NULL) {
+        return;
+    }
+
+    const prefilter_stats_t* s = &pf->stats;
+    uint32_t gated = s->executed + s->skipped;
+    uint32_t duty = gated > 0 ? (s->executed * 100u) / gated : 0;
+    DEBUG_PRINT("Prefilter Status:");
+    if (gated == s->windows) {
+        DEBUG_PRINT("  Windows: %lu executed, %lu skipped (%lu%% duty)",
+                   (unsigned long)s->executed, (unsigned long)s->skipped, (unsigned long)duty);
+    } else {
+        // The cadence ran the model on the rest (Inference Scheduling)
+        DEBUG_PRINT("  Windows: %lu, %lu gated: %lu executed, %lu skipped (%lu%% duty)",
+                   (unsigned long)s->windows, (unsigned long)gated, (unsigned long)s->executed,
+                   (unsigned long)s->skipped, (unsigned long)duty);
+    }
+    DEBUG_PRINT("  Events: %lu free-fall, %lu impact",
+               (unsigned long)s->freefall_events, (unsigned long)s->impact_events);
+    DEBUG_PRINT("  Windows with gyro %lu, activity change %lu, keep-alive %lu",
+               (unsigned long)s->gyro_windows, (unsigned long)s->activity_windows,
+               (unsigned long)s->keepalive_windows);
+}
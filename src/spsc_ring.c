@@ -0,0 +1,57 @@
+#include "spsc_ring.h"
+
+#include <string.h>
+
+esp_err_t spsc_ring_init(spsc_ring_t* ring, void* storage, uint32_t elem_size, uint32_t capacity) {
+    if (ring == NULL || storage == NULL || elem_size == 0 || capacity == 0 ||
+        (capacity & (capacity - 1)) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(ring, 0, sizeof(*ring));
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    ring->storage = storage;
+    ring->elem_size = elem_size;
+    ring->capacity = capacity;
+    ring->mask = capacity - 1;
+    return ESP_OK;
+}
+
+bool spsc_ring_push(spsc_ring_t* ring, const void* elem) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    // Only refresh the consumer's index when the cached view says full
+    if (head - ring->tail_cache >= ring->capacity) {
+        ring->tail_cache = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (head - ring->tail_cache >= ring->capacity) {
+            ring->dropped++;
+            return false;
+        }
+    }
+
+    memcpy(ring->storage + (size_t)(head & ring->mask) * ring->elem_size, elem, ring->elem_size);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return true;
+}
+
+bool spsc_ring_pop(spsc_ring_t* ring, void* elem) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    if (tail == ring->head_cache) {
+        ring->head_cache = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (tail == ring->head_cache) {
+            return false;
+        }
+    }
+
+    memcpy(elem, ring->storage + (size_t)(tail & ring->mask) * ring->elem_size, ring->elem_size);
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+uint32_t spsc_ring_count(const spsc_ring_t* ring) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    return head - tail;
+}
@@ -1,88 +1,538 @@
 #include "tflite_inference.h"
+#include "model_store.h"
+#if MODEL_EMBEDDED_FALLBACK
 #include "fall_detection_model.h"
+#endif
+
+#include <stdatomic.h>
+
+// Where the model is loaded from at boot, first valid image wins
+#ifdef ESP_PLATFORM
+static const char* const boot_locations[] = { MODEL_PARTITION_LABEL, MODEL_PARTITION_LABEL_B };
+#else
+static const char* const boot_locations[] = { MODEL_HOST_PATH };
+#endif
 
 // static const char* TAG = "TFLITE";  // Unused for now
 
 // Global variables
 data_buffer_t g_data_buffer = {0};
+spsc_ring_t g_sample_ring;
+static sensor_sample_t* sample_ring_storage = NULL;    // placed as MEM_CLASS_SAMPLE_RING
+static int16_t* window_ring_storage = NULL;
 inference_result_t g_last_result = {0};
+inference_metrics_t g_inference_metrics = {0};
+
+// Tensor arena for model execution, sized by the arena planner. The
+// streaming arena holds state carried between samples rather than scratch.
+#if INFERENCE_STREAMING
+#define TENSOR_ARENA_CLASS MEM_CLASS_LSTM_STATE
+#else
+#define TENSOR_ARENA_CLASS MEM_CLASS_ACTIVATIONS
+#endif
+
+// Model slots. The active slot serves windows on the inference task. A new
+// model is loaded, bound, arena-planned and warmed up in the other slot by
+// tflite_stage_model() on another task, then made active by the inference
+// task at the next window boundary, so acquisition never pauses.
+//   EMPTY/RETIRED -> LOADING -> STANDBY    staging task
+//   STANDBY -> ACTIVE, ACTIVE -> RETIRED   inference task
+// A retired slot is released by the next tflite_stage_model().
+#define MODEL_SLOTS 2
+
+typedef enum {
+    SLOT_EMPTY,
+    SLOT_LOADING,
+    SLOT_STANDBY,
+    SLOT_ACTIVE,
+    SLOT_RETIRED,
+} slot_state_t;
+
+// Native int8 engine state. The exported graph uses TensorList (Flex) ops for
+// its LSTM loops, which TensorFlow Lite Micro cannot execute, so the graph is
+// bound and run by nn_model/nn_engine instead.
+typedef struct {
+    atomic_int state;                   // slot_state_t
+    char location[32];
+    model_blob_t blob;                  // mapped model image, kept while the model is bound
+    const uint8_t* weights;             // blob data as placed by the memory policy
+    nn_model_t model;
+    nn_input_affine_t input_affine;     // raw int16 -> scaled, quantized input in one integer step
+    int num_classes;
+    int fall_class;                     // class labelled "Fall", -1 if none
+    uint8_t* arena;
+    size_t arena_size;
+#if INFERENCE_STREAMING
+    nn_stream_t stream;
+    uint32_t stream_consumed;           // total_samples already pushed
+    uint32_t stream_row;                // ring row of the next sample to push
+    bool primed;                        // staged front end fed from the window ring
+#else
+    nn_engine_t engine;
+    nn_static_engine_t static_engine;
+    bool use_static;                    // shapes match the generated kernels
+    nn_pipeline_t pipeline;
+    bool use_pipeline;                  // INFERENCE_PIPELINED and the graph allows it
+#endif
+} model_slot_t;
+
+static model_slot_t slots[MODEL_SLOTS];
+static const char* const slot_model_names[MODEL_SLOTS] = { "model", "model (B)" };
+static const char* const slot_arena_names[MODEL_SLOTS] = { "tensor arena", "tensor arena (B)" };
+static _Atomic(model_slot_t*) active_slot = NULL;     // written by the inference task only
+static _Atomic(model_slot_t*) pending_slot = NULL;    // staged, taken at a window boundary
+static uint32_t model_swaps = 0;
+#if INFERENCE_STREAMING
+static uint32_t stream_resets = 0;
+#endif
+
+// Model input/output staging
+#if !INFERENCE_STREAMING
+static int8_t input_quantized[MODEL_INPUT_SIZE];
+static int8_t warm_up_input[MODEL_INPUT_SIZE];      // staging task
+#endif
+static int8_t output_quantized[MODEL_OUTPUT_SIZE];
+
+// Window length of the loaded model (slot meta), at most INPUT_SEQUENCE_LENGTH.
+// Fixed after boot: a staged model must use the same window.
+static uint32_t window_len = INPUT_SEQUENCE_LENGTH;
 
-// TensorFlow Lite Micro objects (placeholder for now)
-// In a full implementation, you would use the actual TensorFlow Lite objects
-static tflite::MicroErrorReporter micro_error_reporter;
-static tflite::ErrorReporter* error_reporter = &micro_error_reporter;
-static const tflite::Model* model = nullptr;
-static tflite::MicroInterpreter* interpreter = nullptr;
-static TfLiteTensor* input = nullptr;
-static TfLiteTensor* output = nullptr;
-
-// Tensor arena for model execution (aligned for ESP32-S3)
-static uint8_t tensor_arena[TENSOR_ARENA_SIZE] __attribute__((aligned(16)));
-
-// Simple model placeholder for now
-static bool model_loaded = false;
-
-// Class labels
-const char* CLASS_LABELS[NUM_CLASSES] = {
-    "Normal",
-    "Fall",
-    "Near Fall",
-    "Sitting",
-    "Walking"
-};
-
-void* tflite_allocate_tensor_arena(size_t size) {
-    if (size > TENSOR_ARENA_SIZE) {
-        DEBUG_ERROR("Tensor arena size too large: %zu > %d", size, TENSOR_ARENA_SIZE);
+// Event-driven scheduling
+static window_notify_fn_t window_notify = NULL;
+static void* window_notify_ctx = NULL;
+static uint32_t samples_pushed = 0;     // sensor task only
+static inference_cadence_t cadence = (inference_cadence_t)INFERENCE_CADENCE;
+static uint32_t cadence_n = INFERENCE_CADENCE_N;
+
+// Front stage worker of the pipelined executor (pipeline task, other core)
+static window_notify_fn_t pipeline_worker = NULL;
+static void* pipeline_worker_ctx = NULL;
+
+static inline model_slot_t* get_active_slot(void) {
+    return atomic_load_explicit(&active_slot, memory_order_acquire);
+}
+
+static inline int slot_index(const model_slot_t* slot) {
+    return (int)(slot - slots);
+}
+
+static void* slot_allocate_arena(model_slot_t* slot, size_t size) {
+    if (size == 0) {
+        DEBUG_ERROR("Invalid tensor arena size");
+        return NULL;
+    }
+    
+    if (slot->arena != NULL) {
+        if (size <= slot->arena_size) {
+            return slot->arena;
+        }
+        mem_free(slot->arena);
+        slot->arena = NULL;
+        slot->arena_size = 0;
+    }
+    
+    slot->arena = mem_alloc(TENSOR_ARENA_CLASS, slot_arena_names[slot_index(slot)], size, NN_ARENA_ALIGNMENT);
+    if (slot->arena == NULL) {
+        DEBUG_ERROR("Failed to allocate %zu byte tensor arena", size);
         return NULL;
     }
-    return tensor_arena;
+    slot->arena_size = size;
+    
+    DEBUG_PRINT("Tensor arena: %zu bytes in %s", size, mem_region_name(mem_find(slot->arena)->region));
+    return slot->arena;
+}
+
+// Unmaps the image and frees the arena of a slot no task is using
+static void slot_release(model_slot_t* slot) {
+    if (slot->arena != NULL) {
+        mem_free(slot->arena);
+        slot->arena = NULL;
+        slot->arena_size = 0;
+    }
+    if (slot->weights != NULL) {
+        mem_free(slot->weights);
+        slot->weights = NULL;
+    }
+    model_store_close(&slot->blob);
+    slot->location[0] = '\0';
+    atomic_store_explicit(&slot->state, SLOT_EMPTY, memory_order_release);
+}
+
+static bool same_qparam(float scale, int32_t zero_point, nn_qparam_t q) {
+    return fabsf(scale - q.scale) <= 1e-6f * q.scale && zero_point == q.zero_point;
+}
+
+// The metadata has to describe the bound graph and fit the sensor pipeline
+static esp_err_t check_model_meta(const model_meta_t* meta, const nn_model_t* model) {
+    if (meta->seq_len != model->seq_len || meta->features != model->features || meta->classes != model->classes) {
+        DEBUG_ERROR("Model metadata [%u x %u] -> %u does not match the graph [%d x %d] -> %d",
+                    meta->seq_len, meta->features, meta->classes,
+                    model->seq_len, model->features, model->classes);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (meta->features != INPUT_FEATURES || meta->seq_len > INPUT_SEQUENCE_LENGTH || meta->classes > NUM_CLASSES) {
+        DEBUG_ERROR("Model shape [%u x %u] -> %u, the pipeline supports [<=%d x %d] -> <=%d",
+                    meta->seq_len, meta->features, meta->classes,
+                    INPUT_SEQUENCE_LENGTH, INPUT_FEATURES, NUM_CLASSES);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    // Zero scale: not recorded (built-in model, version 1 images)
+    if ((meta->input_scale != 0.0f && !same_qparam(meta->input_scale, meta->input_zero_point, model->input_q)) ||
+        (meta->output_scale != 0.0f && !same_qparam(meta->output_scale, meta->output_zero_point, model->output_q))) {
+        DEBUG_ERROR("Model metadata quantization does not match the graph");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (meta->sample_rate_hz != SAMPLE_RATE_HZ) {
+        DEBUG_WARN("Model trained at %u Hz, sensor runs at %d Hz", meta->sample_rate_hz, SAMPLE_RATE_HZ);
+    }
+    return ESP_OK;
+}
+
+// Maps the image at location, or the built-in model if allowed, and binds it
+static esp_err_t slot_load(model_slot_t* slot, const char* location, bool allow_fallback) {
+    esp_err_t ret = model_store_open(location, &slot->blob);
+    if (ret != ESP_OK) {
+        if (!allow_fallback) {
+            DEBUG_ERROR("No valid model image at '%s': %s", location, esp_err_to_name(ret));
+            return ret;
+        }
+#if MODEL_EMBEDDED_FALLBACK
+        DEBUG_WARN("No valid model image at '%s' (%s), using the built-in model",
+                   location, esp_err_to_name(ret));
+        slot->blob = (model_blob_t){
+            .data = fall_detection_model,
+            .size = fall_detection_model_len,
+            .source = MODEL_SOURCE_EMBEDDED,
+        };
+        model_meta_default(&slot->blob.meta);
+#else
+        DEBUG_ERROR("No valid model image at '%s': %s", location, esp_err_to_name(ret));
+        return ret;
+#endif
+    }
+    snprintf(slot->location, sizeof(slot->location), "%s", location);
+    DEBUG_PRINT("Loading TensorFlow Lite model (%zu bytes, %s) into slot %d...",
+                slot->blob.size, model_source_name(slot->blob.source), slot_index(slot));
+
+    // The flatbuffer stays referenced by the bound model (weights are used in
+    // place, straight from the mapped flash unless the policy copies them)
+    slot->weights = mem_place_const(MEM_CLASS_WEIGHTS, slot_model_names[slot_index(slot)],
+                                    slot->blob.data, slot->blob.size, 16);
+    if (slot->weights == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    ret = nn_model_load(&slot->model, slot->weights, slot->blob.size);
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Failed to bind model: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    const model_meta_t* meta = &slot->blob.meta;
+    ret = check_model_meta(meta, &slot->model);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    slot->num_classes = meta->classes;
+    slot->fall_class = -1;
+    for (int c = 0; c < meta->classes; c++) {
+        if (strcmp(meta->labels[c], "Fall") == 0) {
+            slot->fall_class = c;
+        }
+    }
+
+    DEBUG_PRINT("Model metadata (%s): window %u, clip [%g, %g]",
+                slot->blob.has_meta ? "image" : "defaults", meta->seq_len,
+                meta->clip_min, meta->clip_max);
+    for (int f = 0; f < meta->features; f++) {
+        DEBUG_PRINT("  feature %d: center %g, scale %g", f, meta->center[f], meta->scale[f]);
+    }
+
+    // Fold sensor sensitivity, the training scaler and input quantization:
+    // (raw / lsb - center) / scale = raw * gain + offset
+    float gain[INPUT_FEATURES];
+    float offset[INPUT_FEATURES];
+    for (int f = 0; f < INPUT_FEATURES; f++) {
+        float lsb = f < 3 ? MPU6050_ACCEL_LSB_PER_G : MPU6050_GYRO_LSB_PER_DPS;
+        gain[f] = 1.0f / (lsb * meta->scale[f]);
+        offset[f] = -meta->center[f] / meta->scale[f];
+    }
+    ret = nn_input_affine_init(&slot->input_affine, INPUT_FEATURES, gain, offset,
+                               meta->clip_min, meta->clip_max, slot->model.input_q);
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Failed to set up input affine: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    nn_model_print_summary(&slot->model);
+    return ESP_OK;
 }
 
-esp_err_t tflite_free_tensor_arena(void) {
-    // Tensor arena is static, no need to free
+static esp_err_t slot_setup(model_slot_t* slot) {
+#if INFERENCE_STREAMING
+    // Streaming results already differ from the exported graph, so the head
+    // uses the cheaper single-pass attention. Full-window builds leave it off
+    // and keep the top LSTM rows for the exported two-pass attention.
+    slot->model.online_attention = true;
+    size_t arena_size = nn_stream_arena_size(&slot->model);
+#else
+    slot->use_pipeline = INFERENCE_PIPELINED && nn_pipeline_supported(&slot->model);
+    slot->use_static = !slot->use_pipeline && INFERENCE_STATIC_KERNELS && nn_static_matches(&slot->model);
+    size_t arena_size = slot->use_pipeline ? nn_pipeline_arena_size(&slot->model)
+                      : slot->use_static ? nn_static_arena_size() : nn_engine_arena_size(&slot->model);
+    if (!slot->use_pipeline && !slot->use_static) {
+        nn_engine_print_plan(&slot->model);
+    }
+#endif
+    uint8_t* arena = slot_allocate_arena(slot, arena_size);
+    if (arena == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+#if INFERENCE_STREAMING
+    esp_err_t ret = nn_stream_init(&slot->stream, &slot->model, arena, arena_size);
+#else
+    esp_err_t ret = slot->use_pipeline ? nn_pipeline_init(&slot->pipeline, &slot->model, arena, arena_size)
+                  : slot->use_static ? nn_static_init(&slot->static_engine, &slot->model, arena, arena_size)
+                  : nn_engine_init(&slot->engine, &slot->model, arena, arena_size);
+#endif
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Failed to initialize engine: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+#if INFERENCE_STREAMING
+    DEBUG_PRINT("Engine ready (streaming), tensor arena: %zu bytes", arena_size);
+#else
+    DEBUG_PRINT("Engine ready (full window, %s%s), tensor arena: %zu bytes",
+                slot->use_pipeline ? "pipelined" : slot->use_static ? "static kernels " : "interpreter",
+                slot->use_static ? nn_static_shape() : "", arena_size);
+#endif
+    return ESP_OK;
+}
+
+#if !INFERENCE_STREAMING
+// Pipelined slots run their front stage inline unless a worker is attached
+// (run_inference() does that for the active slot)
+static esp_err_t slot_invoke(model_slot_t* slot, const int8_t* input, int8_t* output) {
+    if (slot->use_pipeline) {
+        return nn_pipeline_invoke(&slot->pipeline, input, output);
+    }
+    return slot->use_static ? nn_static_invoke(&slot->static_engine, input, output)
+                            : nn_engine_invoke(&slot->engine, input, output);
+}
+#endif
+
+// Runs one window of a device at rest through a staged model: touches every
+// weight once (flash cache) and proves the model runs before it serves
+static esp_err_t slot_warm_up(model_slot_t* slot) {
+    const int16_t at_rest[INPUT_FEATURES] = { 0, 0, (int16_t)MPU6050_ACCEL_LSB_PER_G, 0, 0, 0 };
+    int8_t sample[INPUT_FEATURES];
+    int8_t output[MODEL_OUTPUT_SIZE];
+    nn_input_affine_s16(&slot->input_affine, at_rest, sample);
+
+    uint64_t start_time = esp_timer_get_time();
+#if INFERENCE_STREAMING
+    // SAME padding delays the front end by a few samples past one window
+    esp_err_t ret = ESP_OK;
+    for (uint32_t t = 0; t < 2 * window_len && ret == ESP_OK && !nn_stream_ready(&slot->stream); t++) {
+        ret = nn_stream_push(&slot->stream, sample);
+    }
+    if (ret == ESP_OK) {
+        ret = nn_stream_evaluate(&slot->stream, output);
+    }
+    nn_stream_reset(&slot->stream);
+    slot->primed = false;
+#else
+    for (uint32_t t = 0; t < window_len; t++) {
+        memcpy(&warm_up_input[t * INPUT_FEATURES], sample, sizeof(sample));
+    }
+    esp_err_t ret = slot_invoke(slot, warm_up_input, output);
+#endif
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Model warm-up failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    DEBUG_PRINT("Model warm-up: %llu us", (unsigned long long)(esp_timer_get_time() - start_time));
     return ESP_OK;
 }
 
 esp_err_t tflite_load_model(void) {
-    DEBUG_PRINT("Loading TensorFlow Lite model...");
-    
-    // For now, we'll use a simple placeholder
-    // In a real implementation, you would load the actual model
-    model_loaded = true;
-    
-    DEBUG_PRINT("Model placeholder loaded successfully");
-    DEBUG_PRINT("Note: This is a placeholder implementation");
-    DEBUG_PRINT("For full TensorFlow Lite support, you need to:");
-    DEBUG_PRINT("1. Install ESP-IDF TensorFlow Lite component");
-    DEBUG_PRINT("2. Convert your model to TFLite format");
-    DEBUG_PRINT("3. Generate C array from the model");
-    
+    model_slot_t* slot = &slots[0];
+    if (get_active_slot() != NULL || atomic_load(&slot->state) != SLOT_EMPTY) {
+        DEBUG_ERROR("Model already loaded, use tflite_stage_model()");
+        return ESP_ERR_INVALID_STATE;
+    }
+    atomic_store(&slot->state, SLOT_LOADING);
+
+    // Only the last location may fall back to the built-in model
+    size_t count = sizeof(boot_locations) / sizeof(boot_locations[0]);
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+    for (size_t i = 0; i < count; i++) {
+        bool last = i + 1 == count;
+        model_blob_t probe;
+        if (!last) {
+            if (model_store_open(boot_locations[i], &probe) != ESP_OK) {
+                continue;
+            }
+            model_store_close(&probe);
+        }
+        ret = slot_load(slot, boot_locations[i], last);
+        if (ret == ESP_OK) {
+            break;
+        }
+        slot_release(slot);
+        atomic_store(&slot->state, SLOT_LOADING);
+    }
+    if (ret != ESP_OK) {
+        slot_release(slot);
+        return ret;
+    }
+    window_len = slot->blob.meta.seq_len;
+
+    DEBUG_PRINT("Model loaded successfully");
     return ESP_OK;
 }
 
 esp_err_t tflite_setup_interpreter(void) {
-    DEBUG_PRINT("Setting up TensorFlow Lite interpreter...");
-    
-    // For now, we'll use a simple placeholder
-    // In a real implementation, you would setup the actual interpreter
-    DEBUG_PRINT("Interpreter placeholder setup successfully");
-    DEBUG_PRINT("Note: This is a placeholder implementation");
-    
+    DEBUG_PRINT("Setting up inference engine...");
+
+    model_slot_t* slot = &slots[0];
+    if (atomic_load(&slot->state) != SLOT_LOADING) {
+        DEBUG_ERROR("Model not loaded");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = slot_setup(slot);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    atomic_store(&slot->state, SLOT_ACTIVE);
+    atomic_store_explicit(&active_slot, slot, memory_order_release);
     return ESP_OK;
 }
 
+esp_err_t tflite_stage_model(const char* location) {
+    model_slot_t* active = get_active_slot();
+    if (location == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (active == NULL || atomic_load_explicit(&pending_slot, memory_order_acquire) != NULL) {
+        DEBUG_ERROR("Cannot stage a model now (%s)", active == NULL ? "not initialized" : "swap pending");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (strcmp(location, active->location) == 0) {
+        // Rewriting the image under the serving model would corrupt it
+        DEBUG_ERROR("'%s' is mapped by the active model", location);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    model_slot_t* slot = NULL;
+    for (int i = 0; i < MODEL_SLOTS && slot == NULL; i++) {
+        int state = atomic_load_explicit(&slots[i].state, memory_order_acquire);
+        if (state == SLOT_EMPTY || state == SLOT_RETIRED) {
+            slot = &slots[i];
+        }
+    }
+    if (slot == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    slot_release(slot);
+    atomic_store(&slot->state, SLOT_LOADING);
+
+    uint64_t start_time = esp_timer_get_time();
+    esp_err_t ret = slot_load(slot, location, false);
+    if (ret == ESP_OK && slot->blob.meta.seq_len != window_len) {
+        DEBUG_ERROR("Staged model window %u differs from the running %lu",
+                    slot->blob.meta.seq_len, (unsigned long)window_len);
+        ret = ESP_ERR_INVALID_SIZE;
+    }
+    if (ret == ESP_OK) {
+        ret = slot_setup(slot);
+    }
+    if (ret == ESP_OK) {
+        ret = slot_warm_up(slot);
+    }
+    if (ret != ESP_OK) {
+        slot_release(slot);
+        return ret;
+    }
+
+    atomic_store(&slot->state, SLOT_STANDBY);
+    atomic_store_explicit(&pending_slot, slot, memory_order_release);
+    DEBUG_PRINT("Model '%s' staged in slot %d in %llu us, active from the next window",
+                location, slot_index(slot), (unsigned long long)(esp_timer_get_time() - start_time));
+    return ESP_OK;
+}
+
+#if INFERENCE_STREAMING
+static esp_err_t stream_pending_samples(model_slot_t* slot);
+#endif
+
+// Window boundary, inference task: make a staged model active
+static model_slot_t* take_pending_model(void) {
+    model_slot_t* active = get_active_slot();
+    model_slot_t* next = atomic_load_explicit(&pending_slot, memory_order_acquire);
+    if (next == NULL) {
+        return active;
+    }
+
+#if INFERENCE_STREAMING
+    // The new front end is fed from the current window alongside the active
+    // one and takes over once its history is full, so no window goes unserved
+    if (!next->primed) {
+        uint32_t backlog = g_data_buffer.count;
+        next->stream_consumed = g_data_buffer.total_samples - backlog;
+        next->stream_row = (g_data_buffer.index + DATA_RING_CAPACITY - backlog) % DATA_RING_CAPACITY;
+        next->primed = true;
+    }
+    esp_err_t ret = stream_pending_samples(next);
+    if (ret == ESP_ERR_INVALID_STATE) {
+        return active;
+    }
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Staged model failed: %s", esp_err_to_name(ret));
+        atomic_store_explicit(&next->state, SLOT_RETIRED, memory_order_release);
+        atomic_store_explicit(&pending_slot, NULL, memory_order_release);
+        return active;
+    }
+#endif
+    atomic_store_explicit(&pending_slot, NULL, memory_order_release);
+    atomic_store(&next->state, SLOT_ACTIVE);
+    atomic_store_explicit(&active_slot, next, memory_order_release);
+    atomic_store_explicit(&active->state, SLOT_RETIRED, memory_order_release);
+    model_swaps++;
+
+    DEBUG_PRINT("Switched to model '%s' (slot %d) at window %lu",
+                next->location, slot_index(next), (unsigned long)g_data_buffer.windows_emitted);
+    return next;
+}
+
+const char* tflite_active_model_location(void) {
+    model_slot_t* active = get_active_slot();
+    return active != NULL ? active->location : NULL;
+}
+
+bool tflite_model_swap_pending(void) {
+    return atomic_load_explicit(&pending_slot, memory_order_acquire) != NULL;
+}
+
+uint32_t tflite_model_swaps(void) {
+    return model_swaps;
+}
+
 esp_err_t tflite_inference_init(void) {
-    DEBUG_PRINT("Initializing TensorFlow Lite inference (placeholder)...");
+    DEBUG_PRINT("Initializing inference...");
     
-    // Load the model (placeholder)
+    // Load the model
     esp_err_t ret = tflite_load_model();
     if (ret != ESP_OK) {
         DEBUG_ERROR("Failed to load model: %s", esp_err_to_name(ret));
         return ret;
     }
     
-    // Set up the interpreter (placeholder)
+    // Set up the engine
     ret = tflite_setup_interpreter();
     if (ret != ESP_OK) {
         DEBUG_ERROR("Failed to setup interpreter: %s", esp_err_to_name(ret));
@@ -90,11 +540,30 @@ esp_err_t tflite_inference_init(void) {
     }
     
     // Initialize data buffer
+    if (sample_ring_storage == NULL) {
+        sample_ring_storage = mem_alloc(MEM_CLASS_SAMPLE_RING, "sample ring",
+                                        SAMPLE_RING_SIZE * sizeof(sensor_sample_t), 16);
+        window_ring_storage = mem_alloc(MEM_CLASS_SAMPLE_RING, "window ring",
+                                        DATA_RING_CAPACITY * INPUT_FEATURES * sizeof(int16_t), 16);
+        if (sample_ring_storage == NULL || window_ring_storage == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    ret = spsc_ring_init(&g_sample_ring, sample_ring_storage, sizeof(sensor_sample_t), SAMPLE_RING_SIZE);
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Failed to create sample ring: %s", esp_err_to_name(ret));
+        return ret;
+    }
     memset(&g_data_buffer, 0, sizeof(g_data_buffer));
+    memset(window_ring_storage, 0, DATA_RING_CAPACITY * INPUT_FEATURES * sizeof(int16_t));
+    g_data_buffer.data = window_ring_storage;
     memset(&g_last_result, 0, sizeof(g_last_result));
+    prefilter_init(&g_prefilter);
+    prefilter_set_gating(&g_prefilter, cadence == CADENCE_ON_TRIGGER);
+    
+    mem_report();
     
-    DEBUG_PRINT("TensorFlow Lite inference placeholder initialized successfully");
-    DEBUG_PRINT("Note: This is a placeholder implementation for testing");
+    DEBUG_PRINT("Inference initialized successfully");
     return ESP_OK;
 }
 
@@ -102,53 +571,173 @@ esp_err_t tflite_init(void) {
     return tflite_inference_init();
 }
 
+// Counts a pushed sample; true when it completes a window on the consumer side
+static bool count_pushed_sample(void) {
+    samples_pushed++;
+    return samples_pushed >= window_len &&
+           (samples_pushed - window_len) % INFERENCE_HOP_SIZE == 0;
+}
+
+static void notify_window(void) {
+    if (window_notify != NULL) {
+        g_inference_metrics.notifications++;
+        window_notify(window_notify_ctx);
+    }
+}
+
 esp_err_t add_sensor_data_to_buffer(const mpu6050_data_t* sensor_data) {
     if (sensor_data == NULL) {
         DEBUG_ERROR("Invalid sensor data pointer");
         return ESP_ERR_INVALID_ARG;
     }
     
-    // Add sensor data to buffer in the correct order
-    uint32_t base_idx = g_data_buffer.index * INPUT_FEATURES;
-    if (base_idx + INPUT_FEATURES <= MODEL_INPUT_SIZE) {
-        g_data_buffer.data[base_idx + 0] = sensor_data->accel_x;
-        g_data_buffer.data[base_idx + 1] = sensor_data->accel_y;
-        g_data_buffer.data[base_idx + 2] = sensor_data->accel_z;
-        g_data_buffer.data[base_idx + 3] = sensor_data->gyro_x;
-        g_data_buffer.data[base_idx + 4] = sensor_data->gyro_y;
-        g_data_buffer.data[base_idx + 5] = sensor_data->gyro_z;
-        
-        g_data_buffer.index++;
-        g_data_buffer.last_update = sensor_data->timestamp;
-        
-        // Check if buffer is full
-        if (g_data_buffer.index >= INPUT_SEQUENCE_LENGTH) {
-            g_data_buffer.is_full = true;
-            g_data_buffer.index = 0;  // Reset for next cycle
-            DEBUG_PRINT("Data buffer is full, ready for inference");
+    // Never blocks: a full ring means the inference task is behind
+    sensor_sample_t sample = { .raw = sensor_data->raw, .timestamp = sensor_data->timestamp };
+    if (!spsc_ring_push(&g_sample_ring, &sample)) {
+        return ESP_ERR_NO_MEM;
+    }
+    
+    // Wake the inference task exactly when the consumer will emit a window
+    if (count_pushed_sample()) {
+        notify_window();
+    }
+    
+    return ESP_OK;
+}
+
+esp_err_t add_sensor_data_block_to_buffer(const mpu6050_data_t* samples, size_t count) {
+    if (samples == NULL && count > 0) {
+        DEBUG_ERROR("Invalid sensor data block");
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    bool window_due = false;
+    bool dropped = false;
+    for (size_t i = 0; i < count; i++) {
+        sensor_sample_t sample = { .raw = samples[i].raw, .timestamp = samples[i].timestamp };
+        if (spsc_ring_push(&g_sample_ring, &sample)) {
+            window_due |= count_pushed_sample();
+        } else {
+            dropped = true;
+        }
+    }
+    
+    // One wake-up per block, even if it completes several windows
+    if (window_due) {
+        notify_window();
+    }
+    
+    return dropped ? ESP_ERR_NO_MEM : ESP_OK;
+}
+
+static void append_sample(const sensor_sample_t* sample) {
+    // Add the raw sample to the ring in the correct order
+    int16_t* row = &g_data_buffer.data[g_data_buffer.index * INPUT_FEATURES];
+    memcpy(row, &sample->raw, sizeof(sample->raw));
+    
+    g_data_buffer.index = (g_data_buffer.index + 1) % DATA_RING_CAPACITY;
+    g_data_buffer.total_samples++;
+    g_data_buffer.last_update = sample->timestamp;
+    g_data_buffer.hop_count++;
+    
+    // mg and 0.1 dps from the raw registers
+    prefilter_push(&g_prefilter,
+                   sample->raw.accel[0] * 1000 / (int32_t)MPU6050_ACCEL_LSB_PER_G,
+                   sample->raw.accel[1] * 1000 / (int32_t)MPU6050_ACCEL_LSB_PER_G,
+                   sample->raw.accel[2] * 1000 / (int32_t)MPU6050_ACCEL_LSB_PER_G,
+                   sample->raw.gyro[0] * 10 / (int32_t)MPU6050_GYRO_LSB_PER_DPS,
+                   sample->raw.gyro[1] * 10 / (int32_t)MPU6050_GYRO_LSB_PER_DPS,
+                   sample->raw.gyro[2] * 10 / (int32_t)MPU6050_GYRO_LSB_PER_DPS);
+    
+    if (g_data_buffer.count < window_len) {
+        g_data_buffer.count++;
+        if (g_data_buffer.count < window_len) {
+            return;
         }
+        g_data_buffer.is_full = true;
+        g_data_buffer.hop_count = INFERENCE_HOP_SIZE;  // first window is due immediately
     }
     
+    // Emit a window every INFERENCE_HOP_SIZE samples
+    if (g_data_buffer.hop_count >= INFERENCE_HOP_SIZE) {
+        g_data_buffer.hop_count = 0;
+        if (g_data_buffer.window_ready) {
+            g_data_buffer.windows_dropped++;
+        }
+        g_data_buffer.window_start = (g_data_buffer.index + DATA_RING_CAPACITY - window_len)
+                                     % DATA_RING_CAPACITY;
+        g_data_buffer.window_trigger = prefilter_end_window(&g_prefilter);
+        g_data_buffer.windows_emitted++;
+        g_data_buffer.window_ready = true;
+    }
+}
+
+esp_err_t process_sensor_samples(void) {
+    sensor_sample_t sample;
+    
+    // Stop at the next window so it is consumed before the ring moves on
+    while (!g_data_buffer.window_ready && spsc_ring_pop(&g_sample_ring, &sample)) {
+        append_sample(&sample);
+    }
+    
+    return ESP_OK;
+}
+
+esp_err_t get_data_window(data_window_t* window) {
+    if (window == NULL) {
+        DEBUG_ERROR("Invalid window pointer");
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (!g_data_buffer.window_ready) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    window->sequence = g_data_buffer.windows_emitted;
+    uint32_t start = g_data_buffer.window_start;
+    uint32_t first_rows = DATA_RING_CAPACITY - start;
+    if (first_rows > window_len) {
+        first_rows = window_len;
+    }
+    
+    window->first = &g_data_buffer.data[start * INPUT_FEATURES];
+    window->first_rows = first_rows;
+    window->second = g_data_buffer.data;
+    window->second_rows = window_len - first_rows;
+    
     return ESP_OK;
 }
 
+void release_data_window(const data_window_t* window) {
+    // Keep the flag if a newer window was emitted while this one was read
+    if (window != NULL && window->sequence == g_data_buffer.windows_emitted) {
+        g_data_buffer.window_ready = false;
+    }
+}
+
+static inline float normalize_feature(const model_meta_t* meta, float value, int feature) {
+    // The training scaler, from the model metadata
+    float x = (value - meta->center[feature]) / meta->scale[feature];
+    return fmaxf(meta->clip_min, fminf(meta->clip_max, x));
+}
+
+static inline float raw_to_units(int16_t value, int feature) {
+    return feature < 3 ? value / MPU6050_ACCEL_LSB_PER_G : value / MPU6050_GYRO_LSB_PER_DPS;
+}
+
 esp_err_t normalize_sensor_data(float* data, size_t size) {
     if (data == NULL) {
         DEBUG_ERROR("Invalid data pointer");
         return ESP_ERR_INVALID_ARG;
     }
     
-    // Simple normalization: scale to [-1, 1] range
-    // This should match the normalization used during training
+    const model_meta_t* meta = tflite_model_meta();
+    if (meta == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
     for (size_t i = 0; i < size; i++) {
-        // Apply normalization based on typical sensor ranges
-        if (i % 6 < 3) {
-            // Accelerometer data: typically ±2g, normalize to ±1
-            data[i] = fmaxf(-1.0f, fminf(1.0f, data[i] / 2.0f));
-        } else {
-            // Gyroscope data: typically ±250°/s, normalize to ±1
-            data[i] = fmaxf(-1.0f, fminf(1.0f, data[i] / 250.0f));
-        }
+        data[i] = normalize_feature(meta, data[i], i % INPUT_FEATURES);
     }
     
     return ESP_OK;
@@ -160,19 +749,19 @@ esp_err_t prepare_input_tensor(float* input_data) {
         return ESP_ERR_INVALID_ARG;
     }
     
-    if (!g_data_buffer.is_full) {
-        DEBUG_ERROR("Data buffer not full yet");
+    const model_meta_t* meta = tflite_model_meta();
+    data_window_t window;
+    if (meta == NULL || get_data_window(&window) != ESP_OK) {
+        DEBUG_ERROR("No data window ready yet");
         return ESP_ERR_INVALID_STATE;
     }
     
-    // Copy data from buffer to input tensor
-    memcpy(input_data, g_data_buffer.data, MODEL_INPUT_SIZE * sizeof(float));
-    
-    // Normalize the data
-    esp_err_t ret = normalize_sensor_data(input_data, MODEL_INPUT_SIZE);
-    if (ret != ESP_OK) {
-        DEBUG_ERROR("Failed to normalize sensor data: %s", esp_err_to_name(ret));
-        return ret;
+    // Linearize the window into a caller-owned buffer and normalize it
+    for (uint32_t t = 0; t < window_len; t++) {
+        const int16_t* row = data_window_row(&window, t);
+        for (int f = 0; f < INPUT_FEATURES; f++) {
+            input_data[t * INPUT_FEATURES + f] = normalize_feature(meta, raw_to_units(row[f], f), f);
+        }
     }
     
     return ESP_OK;
@@ -184,10 +773,12 @@ int get_predicted_class(const float* probabilities) {
         return -1;
     }
     
+    model_slot_t* active = get_active_slot();
+    int num_classes = active != NULL ? active->num_classes : NUM_CLASSES;
     int max_idx = 0;
     float max_prob = probabilities[0];
     
-    for (int i = 1; i < NUM_CLASSES; i++) {
+    for (int i = 1; i < num_classes; i++) {
         if (probabilities[i] > max_prob) {
             max_prob = probabilities[i];
             max_idx = i;
@@ -211,47 +802,231 @@ float get_confidence(const float* probabilities) {
     return probabilities[max_idx];
 }
 
+#if INFERENCE_STREAMING
+// Pushes every sample written since the last call through the streaming
+// front end, one O(1) layer update per sample
+static esp_err_t stream_pending_samples(model_slot_t* slot) {
+    uint32_t total = g_data_buffer.total_samples;
+    uint32_t pending = total - slot->stream_consumed;
+    
+    if (pending > DATA_RING_CAPACITY) {
+        // Fell behind the writer: restart from the oldest full window
+        DEBUG_WARN("Streaming fell %lu samples behind, resetting", (unsigned long)pending);
+        nn_stream_reset(&slot->stream);
+        stream_resets++;
+        pending = window_len;
+        slot->stream_row = (g_data_buffer.index + DATA_RING_CAPACITY - pending) % DATA_RING_CAPACITY;
+    }
+    
+    int8_t sample[INPUT_FEATURES];
+    for (uint32_t i = 0; i < pending; i++) {
+        nn_input_affine_s16(&slot->input_affine, &g_data_buffer.data[slot->stream_row * INPUT_FEATURES], sample);
+        esp_err_t ret = nn_stream_push(&slot->stream, sample);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        slot->stream_row = (slot->stream_row + 1) % DATA_RING_CAPACITY;
+    }
+    slot->stream_consumed = total;
+    
+    if (!nn_stream_ready(&slot->stream)) {
+        DEBUG_PRINT("Streaming front end warming up (%lu/%d steps)",
+                    (unsigned long)slot->stream.history_count, slot->model.attention.steps);
+        return ESP_ERR_INVALID_STATE;
+    }
+    return ESP_OK;
+}
+#endif
+
+const model_meta_t* tflite_model_meta(void) {
+    model_slot_t* active = get_active_slot();
+    return active != NULL ? &active->blob.meta : NULL;
+}
+
+const nn_model_t* tflite_active_model(void) {
+    model_slot_t* active = get_active_slot();
+    return active != NULL ? &active->model : NULL;
+}
+
+const char* tflite_class_label(int index) {
+    model_slot_t* active = get_active_slot();
+    if (active == NULL || index < 0 || index >= active->num_classes) {
+        return "?";
+    }
+    return active->blob.meta.labels[index];
+}
+
+void set_window_notify_callback(window_notify_fn_t callback, void* ctx) {
+    window_notify_ctx = ctx;
+    window_notify = callback;
+}
+
+esp_err_t set_inference_cadence(inference_cadence_t policy, uint32_t every_n) {
+    if (policy > CADENCE_ON_TRIGGER || (policy == CADENCE_EVERY_N_HOPS && every_n == 0)) {
+        DEBUG_ERROR("Invalid inference cadence %d/%lu", (int)policy, (unsigned long)every_n);
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    cadence = policy;
+    cadence_n = every_n;
+    prefilter_set_gating(&g_prefilter, policy == CADENCE_ON_TRIGGER);
+    return ESP_OK;
+}
+
+void record_inference_wake(bool notified) {
+    g_inference_metrics.wakes++;
+    if (!notified) {
+        g_inference_metrics.timeouts++;
+    }
+    if (!g_data_buffer.window_ready) {
+        g_inference_metrics.idle_wakes++;
+    }
+}
+
+bool inference_window_due(void) {
+    if (!g_data_buffer.window_ready) {
+        return false;
+    }
+    
+    bool due = true;
+    g_inference_metrics.windows++;
+    switch (cadence) {
+        case CADENCE_EVERY_HOP:
+            break;
+        case CADENCE_EVERY_N_HOPS:
+            due = (g_data_buffer.windows_emitted - 1) % cadence_n == 0;
+            break;
+        case CADENCE_ON_TRIGGER:
+            due = g_data_buffer.window_trigger != PREFILTER_TRIGGER_NONE;
+            break;
+    }
+    
+    if (due) {
+        g_inference_metrics.inferences++;
+    } else {
+        g_inference_metrics.skipped++;
+    }
+    return due;
+}
+
+void print_inference_metrics(void) {
+    const inference_metrics_t* m = &g_inference_metrics;
+    DEBUG_PRINT("Inference Scheduling:");
+    DEBUG_PRINT("  Wakes: %lu (%lu notified, %lu timeouts, %lu idle)",
+               (unsigned long)m->wakes, (unsigned long)m->notifications,
+               (unsigned long)m->timeouts, (unsigned long)m->idle_wakes);
+    DEBUG_PRINT("  Windows: %lu, inferences %lu, skipped %lu",
+               (unsigned long)m->windows, (unsigned long)m->inferences, (unsigned long)m->skipped);
+#if !INFERENCE_STREAMING
+    model_slot_t* slot = get_active_slot();
+    if (slot != NULL && slot->use_pipeline) {
+        nn_pipeline_print_stats(&slot->pipeline);
+    }
+#endif
+}
+
+void set_pipeline_worker_callback(window_notify_fn_t callback, void* ctx) {
+    pipeline_worker_ctx = ctx;
+    pipeline_worker = callback;
+}
+
+void run_pipeline_front(void) {
+#if !INFERENCE_STREAMING
+    // The active slot only changes between windows, after its front stage is done
+    model_slot_t* slot = get_active_slot();
+    if (slot == NULL || !slot->use_pipeline) {
+        return;
+    }
+    while (nn_pipeline_front_step(&slot->pipeline)) {
+    }
+#endif
+}
+
+esp_err_t skip_inference_window(void) {
+    data_window_t window;
+    if (get_active_slot() == NULL || get_data_window(&window) != ESP_OK) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+#if INFERENCE_STREAMING
+    // The streaming front end still has to see every sample
+    esp_err_t ret = stream_pending_samples(take_pending_model());
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        release_data_window(&window);
+        return ret;
+    }
+#else
+    take_pending_model();
+#endif
+    
+    release_data_window(&window);
+    return ESP_OK;
+}
+
 esp_err_t run_inference(inference_result_t* result) {
     if (result == NULL) {
         DEBUG_ERROR("Invalid result pointer");
         return ESP_ERR_INVALID_ARG;
     }
     
-    if (!g_data_buffer.is_full) {
-        DEBUG_ERROR("Data buffer not full, cannot run inference");
+    if (get_active_slot() == NULL) {
+        DEBUG_ERROR("Engine not ready, cannot run inference");
         return ESP_ERR_INVALID_STATE;
     }
     
-    if (!model_loaded) {
-        DEBUG_ERROR("Model not loaded, cannot run inference");
+    data_window_t window;
+    if (get_data_window(&window) != ESP_OK) {
+        DEBUG_ERROR("No data window ready, cannot run inference");
         return ESP_ERR_INVALID_STATE;
     }
     
+    // Window boundary: a staged model takes over here
+    model_slot_t* slot = take_pending_model();
+    
     uint64_t start_time = esp_timer_get_time();
     
-    // For now, we'll use a simple placeholder inference
-    // In a real implementation, you would run the actual TensorFlow Lite model
+#if INFERENCE_STREAMING
+    esp_err_t ret = stream_pending_samples(slot);
+    release_data_window(&window);
+    if (ret != ESP_OK) {
+        return ret;
+    }
     
-    // Simulate inference time
-    vTaskDelay(pdMS_TO_TICKS(50));  // 50ms simulation
+    ret = nn_stream_evaluate(&slot->stream, output_quantized);
+#else
+    // Normalize and quantize straight from the raw ring view
+    for (uint32_t t = 0; t < window_len; t++) {
+        nn_input_affine_s16(&slot->input_affine, data_window_row(&window, t),
+                            &input_quantized[t * INPUT_FEATURES]);
+    }
+    release_data_window(&window);
+    
+    // Only the active slot is handed to the front worker, so a model warming
+    // up on the staging task never competes for it
+    if (slot->use_pipeline) {
+        nn_pipeline_set_front_worker(&slot->pipeline, pipeline_worker, pipeline_worker_ctx);
+    }
+    esp_err_t ret = slot_invoke(slot, input_quantized, output_quantized);
+#endif
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Engine invoke failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
+    for (int i = 0; i < NUM_CLASSES; i++) {
+        result->probabilities[i] = i < slot->num_classes
+                                 ? nn_dequantize_s8(output_quantized[i], slot->model.output_q) : 0.0f;
+    }
     
     uint64_t end_time = esp_timer_get_time();
     result->inference_time_us = end_time - start_time;
     
-    // Generate placeholder probabilities (mostly Normal class)
-    result->probabilities[0] = 0.85f;  // Normal
-    result->probabilities[1] = 0.05f;  // Fall
-    result->probabilities[2] = 0.03f;  // Near Fall
-    result->probabilities[3] = 0.04f;  // Sitting
-    result->probabilities[4] = 0.03f;  // Walking
-    
     // Process results
     result->predicted_class = get_predicted_class(result->probabilities);
     result->confidence = get_confidence(result->probabilities);
     result->is_valid = true;
     
-    DEBUG_PRINT("Placeholder inference completed in %llu us", result->inference_time_us);
-    DEBUG_PRINT("Note: This is a placeholder implementation");
+    DEBUG_PRINT("Inference completed in %llu us", (unsigned long long)result->inference_time_us);
     
     return ESP_OK;
 }
@@ -269,7 +1044,8 @@ esp_err_t process_inference_result(inference_result_t* result) {
     print_inference_result(result);
     
     // Check for fall detection
-    if (result->predicted_class == 1 && result->confidence > 0.7f) {
+    model_slot_t* active = get_active_slot();
+    if (active != NULL && result->predicted_class == active->fall_class && result->confidence > 0.7f) {
         DEBUG_ERROR("FALL DETECTED! Confidence: %.3f", result->confidence);
         // Here you can add fall detection actions (alarm, notification, etc.)
     }
@@ -285,13 +1061,14 @@ void print_inference_result(const inference_result_t* result) {
     
     DEBUG_PRINT("=== Inference Result ===");
     DEBUG_PRINT("Predicted Class: %s (%d)", 
-               CLASS_LABELS[result->predicted_class], result->predicted_class);
+               tflite_class_label(result->predicted_class), result->predicted_class);
     DEBUG_PRINT("Confidence: %.3f", result->confidence);
-    DEBUG_PRINT("Inference Time: %llu us", result->inference_time_us);
+    DEBUG_PRINT("Inference Time: %llu us", (unsigned long long)result->inference_time_us);
     
     DEBUG_PRINT("Class Probabilities:");
-    for (int i = 0; i < NUM_CLASSES; i++) {
-        DEBUG_PRINT("  %s: %.3f", CLASS_LABELS[i], result->probabilities[i]);
+    model_slot_t* active = get_active_slot();
+    for (int i = 0; i < (active != NULL ? active->num_classes : 0); i++) {
+        DEBUG_PRINT("  %s: %.3f", tflite_class_label(i), result->probabilities[i]);
     }
     DEBUG_PRINT("========================");
 }
@@ -311,7 +1088,23 @@ void print_sensor_data(const mpu6050_data_t* data) {
 
 void print_data_buffer_status(void) {
     DEBUG_PRINT("Data Buffer Status:");
-    DEBUG_PRINT("  Index: %lu/%u", (unsigned long)g_data_buffer.index, INPUT_SEQUENCE_LENGTH);
+    DEBUG_PRINT("  Index: %lu/%u", (unsigned long)g_data_buffer.index, DATA_RING_CAPACITY);
+    DEBUG_PRINT("  Samples: %lu/%lu", (unsigned long)g_data_buffer.count, (unsigned long)window_len);
     DEBUG_PRINT("  Is Full: %s", g_data_buffer.is_full ? "Yes" : "No");
-    DEBUG_PRINT("  Last Update: %llu", g_data_buffer.last_update);
+    DEBUG_PRINT("  Sample ring: %lu queued, %lu dropped",
+               (unsigned long)spsc_ring_count(&g_sample_ring), (unsigned long)g_sample_ring.dropped);
+    DEBUG_PRINT("  Windows: %lu emitted, %lu dropped (hop %d)",
+               (unsigned long)g_data_buffer.windows_emitted,
+               (unsigned long)g_data_buffer.windows_dropped, INFERENCE_HOP_SIZE);
+    model_slot_t* active = get_active_slot();
+    if (active != NULL) {
+        DEBUG_PRINT("  Model: '%s' (slot %d), %lu swaps",
+                   active->location, slot_index(active), (unsigned long)model_swaps);
+#if INFERENCE_STREAMING
+        DEBUG_PRINT("  Streaming: %lu samples, %lu steps, %lu resets",
+                   (unsigned long)active->stream.samples, (unsigned long)active->stream.steps,
+                   (unsigned long)stream_resets);
+#endif
+    }
+    DEBUG_PRINT("  Last Update: %llu", (unsigned long long)g_data_buffer.last_update);
 }
\ No newline at end of file
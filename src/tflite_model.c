@@ -0,0 +1,361 @@
+#include "tflite_model.h"
+
+#include <string.h>
+
+// Field indices of the tflite schema tables we walk
+#define MODEL_VERSION       0
+#define MODEL_OPCODES       1
+#define MODEL_SUBGRAPHS     2
+#define MODEL_BUFFERS       4
+#define OPCODE_DEPRECATED   0
+#define OPCODE_BUILTIN      3
+#define SUBGRAPH_TENSORS    0
+#define SUBGRAPH_INPUTS     1
+#define SUBGRAPH_OUTPUTS    2
+#define SUBGRAPH_OPERATORS  3
+#define TENSOR_SHAPE        0
+#define TENSOR_TYPE         1
+#define TENSOR_BUFFER       2
+#define TENSOR_NAME         3
+#define TENSOR_QUANT        4
+#define QUANT_SCALE         2
+#define QUANT_ZERO_POINT    3
+#define OP_OPCODE_INDEX     0
+#define OP_INPUTS           1
+#define OP_OUTPUTS          2
+#define OP_OPTIONS          4
+#define BUFFER_DATA         0
+
+#define TFL_SCHEMA_VERSION  3
+
+static bool in_bounds(const tfl_model_t* m, uint32_t off, uint32_t len) {
+    return off <= m->size && len <= m->size - off;
+}
+
+static uint32_t rd_u32(const tfl_model_t* m, uint32_t off) {
+    uint32_t v = 0;
+    if (in_bounds(m, off, 4)) {
+        memcpy(&v, m->data + off, 4);
+    }
+    return v;
+}
+
+static uint16_t rd_u16(const tfl_model_t* m, uint32_t off) {
+    uint16_t v = 0;
+    if (in_bounds(m, off, 2)) {
+        memcpy(&v, m->data + off, 2);
+    }
+    return v;
+}
+
+// Absolute offset of a table field, 0 if the field is absent or its width
+// bytes do not fit in the model
+static uint32_t field(const tfl_model_t* m, uint32_t table, int index, uint32_t width) {
+    if (table == 0 || !in_bounds(m, table, 4)) {
+        return 0;
+    }
+    int32_t soff = (int32_t)rd_u32(m, table);
+    int64_t vtable = (int64_t)table - soff;
+    if (vtable < 0 || !in_bounds(m, (uint32_t)vtable, 4)) {
+        return 0;
+    }
+    uint16_t vsize = rd_u16(m, (uint32_t)vtable);
+    uint32_t slot = 4 + 2 * (uint32_t)index;
+    if (slot + 2 > vsize) {
+        return 0;
+    }
+    uint16_t foff = rd_u16(m, (uint32_t)vtable + slot);
+    if (foff == 0 || !in_bounds(m, table, (uint32_t)foff + width)) {
+        return 0;
+    }
+    return table + foff;
+}
+
+static uint32_t deref(const tfl_model_t* m, uint32_t off) {
+    if (off == 0 || !in_bounds(m, off, 4)) {
+        return 0;
+    }
+    uint32_t target = off + rd_u32(m, off);
+    return in_bounds(m, target, 4) ? target : 0;
+}
+
+static uint32_t field_table(const tfl_model_t* m, uint32_t table, int index) {
+    return deref(m, field(m, table, index, 4));
+}
+
+// Offset of the first element of a vector field, element count in *len
+static uint32_t field_vector(const tfl_model_t* m, uint32_t table, int index,
+                             uint32_t elem_size, uint32_t* len) {
+    *len = 0;
+    uint32_t vec = field_table(m, table, index);
+    if (vec == 0) {
+        return 0;
+    }
+    uint32_t n = rd_u32(m, vec);
+    if (elem_size != 0 && n > (m->size - vec - 4) / elem_size) {
+        return 0;
+    }
+    *len = n;
+    return vec + 4;
+}
+
+static uint32_t vector_table(const tfl_model_t* m, uint32_t vec, uint32_t len, uint32_t i) {
+    if (vec == 0 || i >= len) {
+        return 0;
+    }
+    return deref(m, vec + 4 * i);
+}
+
+static uint32_t subgraph(const tfl_model_t* m, int sg) {
+    if (sg < 0) {
+        return 0;
+    }
+    return vector_table(m, m->subgraphs, m->num_subgraphs, (uint32_t)sg);
+}
+
+static uint32_t op_table(const tfl_model_t* m, int sg, int op) {
+    uint32_t len;
+    uint32_t ops = field_vector(m, subgraph(m, sg), SUBGRAPH_OPERATORS, 4, &len);
+    if (op < 0) {
+        return 0;
+    }
+    return vector_table(m, ops, len, (uint32_t)op);
+}
+
+static int read_int_vector(const tfl_model_t* m, uint32_t table, int index,
+                           int32_t* out, int max) {
+    uint32_t len;
+    uint32_t vec = field_vector(m, table, index, 4, &len);
+    int n = 0;
+    for (uint32_t i = 0; i < len && n < max; i++) {
+        out[n++] = (int32_t)rd_u32(m, vec + 4 * i);
+    }
+    return (int)len;
+}
+
+esp_err_t tfl_model_open(tfl_model_t* model, const uint8_t* data, size_t size) {
+    if (model == NULL || data == NULL || size < 8) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(model, 0, sizeof(*model));
+    model->data = data;
+    model->size = size;
+
+    if (memcmp(data + 4, "TFL3", 4) != 0) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    // The root offset lives at byte 0, which deref() treats as "absent"
+    model->root = rd_u32(model, 0);
+    if (model->root == 0 || !in_bounds(model, model->root, 4)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    uint32_t version_off = field(model, model->root, MODEL_VERSION, 4);
+    if (version_off == 0 || rd_u32(model, version_off) != TFL_SCHEMA_VERSION) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    model->opcodes = field_vector(model, model->root, MODEL_OPCODES, 4, &model->num_opcodes);
+    model->subgraphs = field_vector(model, model->root, MODEL_SUBGRAPHS, 4, &model->num_subgraphs);
+    model->buffers = field_vector(model, model->root, MODEL_BUFFERS, 4, &model->num_buffers);
+    if (model->num_subgraphs == 0 || model->num_opcodes == 0) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    return ESP_OK;
+}
+
+int tfl_subgraph_count(const tfl_model_t* model) {
+    return (int)model->num_subgraphs;
+}
+
+int tfl_subgraph_input(const tfl_model_t* model, int sg, int index) {
+    int32_t idx[16];
+    int n = read_int_vector(model, subgraph(model, sg), SUBGRAPH_INPUTS, idx, 16);
+    return (index >= 0 && index < n && index < 16) ? idx[index] : -1;
+}
+
+int tfl_subgraph_output(const tfl_model_t* model, int sg, int index) {
+    int32_t idx[16];
+    int n = read_int_vector(model, subgraph(model, sg), SUBGRAPH_OUTPUTS, idx, 16);
+    return (index >= 0 && index < n && index < 16) ? idx[index] : -1;
+}
+
+int tfl_op_count(const tfl_model_t* model, int sg) {
+    uint32_t len;
+    field_vector(model, subgraph(model, sg), SUBGRAPH_OPERATORS, 4, &len);
+    return (int)len;
+}
+
+int32_t tfl_op_builtin(const tfl_model_t* model, int sg, int op) {
+    uint32_t table = op_table(model, sg, op);
+    if (table == 0) {
+        return -1;
+    }
+
+    uint32_t idx_off = field(model, table, OP_OPCODE_INDEX, 4);
+    uint32_t opcode_index = idx_off ? rd_u32(model, idx_off) : 0;
+    uint32_t opcode = vector_table(model, model->opcodes, model->num_opcodes, opcode_index);
+    if (opcode == 0) {
+        return -1;
+    }
+
+    // Newer converters store the code in builtin_code and clamp the
+    // deprecated byte field to 127 (PLACEHOLDER_FOR_GREATER_OP_CODES)
+    uint32_t dep_off = field(model, opcode, OPCODE_DEPRECATED, 1);
+    uint32_t code_off = field(model, opcode, OPCODE_BUILTIN, 4);
+    int32_t deprecated = dep_off ? (int8_t)model->data[dep_off] : 0;
+    int32_t builtin = code_off ? (int32_t)rd_u32(model, code_off) : 0;
+    return builtin > deprecated ? builtin : deprecated;
+}
+
+int tfl_op_inputs(const tfl_model_t* model, int sg, int op, int32_t* tensors, int max) {
+    return read_int_vector(model, op_table(model, sg, op), OP_INPUTS, tensors, max);
+}
+
+int tfl_op_outputs(const tfl_model_t* model, int sg, int op, int32_t* tensors, int max) {
+    return read_int_vector(model, op_table(model, sg, op), OP_OUTPUTS, tensors, max);
+}
+
+int32_t tfl_op_option_int(const tfl_model_t* model, int sg, int op, int field_index, int32_t def) {
+    uint32_t options = field_table(model, op_table(model, sg, op), OP_OPTIONS);
+    uint32_t off = field(model, options, field_index, 4);
+    return off ? (int32_t)rd_u32(model, off) : def;
+}
+
+uint8_t tfl_op_option_byte(const tfl_model_t* model, int sg, int op, int field_index, uint8_t def) {
+    uint32_t options = field_table(model, op_table(model, sg, op), OP_OPTIONS);
+    uint32_t off = field(model, options, field_index, 1);
+    return off ? model->data[off] : def;
+}
+
+float tfl_op_option_float(const tfl_model_t* model, int sg, int op, int field_index, float def) {
+    uint32_t options = field_table(model, op_table(model, sg, op), OP_OPTIONS);
+    uint32_t off = field(model, options, field_index, 4);
+    if (off == 0) {
+        return def;
+    }
+    float v;
+    memcpy(&v, model->data + off, 4);
+    return v;
+}
+
+esp_err_t tfl_tensor_get(const tfl_model_t* model, int sg, int tensor, tfl_tensor_t* out) {
+    if (out == NULL || tensor < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(out, 0, sizeof(*out));
+
+    uint32_t len;
+    uint32_t tensors = field_vector(model, subgraph(model, sg), SUBGRAPH_TENSORS, 4, &len);
+    uint32_t table = vector_table(model, tensors, len, (uint32_t)tensor);
+    if (table == 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    uint32_t type_off = field(model, table, TENSOR_TYPE, 1);
+    out->type = type_off ? (tfl_type_t)model->data[type_off] : TFL_TYPE_FLOAT32;
+
+    int32_t dims[TFL_MAX_DIMS];
+    int ndim = read_int_vector(model, table, TENSOR_SHAPE, dims, TFL_MAX_DIMS);
+    if (ndim > TFL_MAX_DIMS) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    out->ndim = ndim;
+    memcpy(out->dims, dims, sizeof(int32_t) * (size_t)ndim);
+
+    uint32_t name = field_vector(model, table, TENSOR_NAME, 1, &len);
+    out->name = name ? (const char*)model->data + name : "";
+    out->name_len = len;
+
+    uint32_t buffer_off = field(model, table, TENSOR_BUFFER, 4);
+    uint32_t buffer_index = buffer_off ? rd_u32(model, buffer_off) : 0;
+    uint32_t buffer = vector_table(model, model->buffers, model->num_buffers, buffer_index);
+    uint32_t data = field_vector(model, buffer, BUFFER_DATA, 1, &len);
+    if (data != 0 && len > 0) {
+        out->data = model->data + data;
+        out->data_size = len;
+    }
+
+    uint32_t quant = field_table(model, table, TENSOR_QUANT);
+    uint32_t scales = field_vector(model, quant, QUANT_SCALE, 4, &len);
+    if (scales != 0) {
+        out->scales = model->data + scales;
+        out->num_scales = len;
+    }
+    uint32_t zero_points = field_vector(model, quant, QUANT_ZERO_POINT, 8, &len);
+    if (zero_points != 0 && len > 0) {
+        int64_t zp;
+        memcpy(&zp, model->data + zero_points, 8);
+        out->zero_point = (int32_t)zp;
+    }
+
+    return ESP_OK;
+}
+
+float tfl_tensor_scale(const tfl_tensor_t* tensor, size_t channel) {
+    if (tensor->num_scales == 0) {
+        return 0.0f;
+    }
+    if (channel >= tensor->num_scales) {
+        channel = 0;
+    }
+    float v;
+    memcpy(&v, tensor->scales + 4 * channel, 4);
+    return v;
+}
+
+int32_t tfl_tensor_elements(const tfl_tensor_t* tensor) {
+    int32_t n = 1;
+    for (int i = 0; i < tensor->ndim; i++) {
+        int32_t d = tensor->dims[i];
+        if (d < 0 || (d > 0 && n > INT32_MAX / d)) {
+            return -1;
+        }
+        n *= d;
+    }
+    return n;
+}
+
+int tfl_find_op(const tfl_model_t* model, int sg, int32_t builtin, int start) {
+    int count = tfl_op_count(model, sg);
+    for (int op = start < 0 ? 0 : start; op < count; op++) {
+        if (tfl_op_builtin(model, sg, op) == builtin) {
+            return op;
+        }
+    }
+    return -1;
+}
+
+int tfl_find_consumer(const tfl_model_t* model, int sg, int32_t tensor, int32_t builtin) {
+    int count = tfl_op_count(model, sg);
+    int32_t inputs[8];
+    for (int op = 0; op < count; op++) {
+        if (tfl_op_builtin(model, sg, op) != builtin) {
+            continue;
+        }
+        int n = tfl_op_inputs(model, sg, op, inputs, 8);
+        for (int i = 0; i < n && i < 8; i++) {
+            if (inputs[i] == tensor) {
+                return op;
+            }
+        }
+    }
+    return -1;
+}
+
+int tfl_find_producer(const tfl_model_t* model, int sg, int32_t tensor) {
+    int count = tfl_op_count(model, sg);
+    int32_t outputs[8];
+    for (int op = 0; op < count; op++) {
+        int n = tfl_op_outputs(model, sg, op, outputs, 8);
+        for (int i = 0; i < n && i < 8; i++) {
+            if (outputs[i] == tensor) {
+                return op;
+            }
+        }
+    }
+    return -1;
+}
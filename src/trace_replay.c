@@ -0,0 +1,233 @@
+#include "trace_replay.h"
+
+#ifdef ESP_PLATFORM
+#include <esp_spiffs.h>
+#endif
+
+#include <ctype.h>
+
+static const char* const column_names[INPUT_FEATURES] = {
+    "AccX", "AccY", "AccZ", "GyroX", "GyroY", "GyroZ",
+};
+
+esp_err_t trace_replay_mount(void) {
+#ifdef ESP_PLATFORM
+    esp_vfs_spiffs_conf_t conf = {
+        .base_path = TRACE_REPLAY_MOUNT,
+        .partition_label = TRACE_REPLAY_PARTITION,
+        .max_files = 2,
+        .format_if_mount_failed = false,
+    };
+    esp_err_t ret = esp_vfs_spiffs_register(&conf);
+    if (ret == ESP_ERR_INVALID_STATE) {
+        return ESP_OK;      // already mounted
+    }
+    if (ret != ESP_OK) {
+        DEBUG_ERROR("Failed to mount spiffs partition '%s': %s", TRACE_REPLAY_PARTITION, esp_err_to_name(ret));
+    }
+    return ret;
+#else
+    return ESP_OK;
+#endif
+}
+
+// Splits line in place at commas; returns the field count
+static int split_fields(char* line, char** fields, int max_fields) {
+    int n = 0;
+    char* p = line;
+    while (n < max_fields) {
+        while (*p == ' ' || *p == '\t' || *p == '"') {
+            p++;
+        }
+        fields[n++] = p;
+        char* comma = strchr(p, ',');
+        char* end = comma != NULL ? comma : p + strlen(p);
+        while (end > p && (isspace((unsigned char)end[-1]) || end[-1] == '"')) {
+            end--;
+        }
+        if (comma == NULL) {
+            *end = '\0';
+            break;
+        }
+        *end = '\0';
+        p = comma + 1;
+    }
+    return n;
+}
+
+static esp_err_t open_csv(trace_replay_t* replay, const char* path) {
+    char line[TRACE_CSV_LINE_MAX];
+    char* fields[TRACE_CSV_LINE_MAX / 2];
+    if (fgets(line, sizeof(line), replay->file) == NULL) {
+        DEBUG_ERROR("Trace '%s' is empty", path);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    replay->line = 1;
+
+    int n = split_fields(line, fields, (int)(sizeof(fields) / sizeof(fields[0])));
+    for (int f = 0; f < INPUT_FEATURES; f++) {
+        replay->columns[f] = -1;
+        for (int c = 0; c < n; c++) {
+            if (strcmp(fields[c], column_names[f]) == 0) {
+                replay->columns[f] = c;
+                break;
+            }
+        }
+        if (replay->columns[f] < 0) {
+            DEBUG_ERROR("Trace '%s' has no %s column", path, column_names[f]);
+            return ESP_ERR_NOT_FOUND;
+        }
+    }
+
+    replay->format = TRACE_FORMAT_CSV;
+    replay->sample_rate_hz = SAMPLE_RATE_HZ;
+    replay->data_offset = ftell(replay->file);
+    return ESP_OK;
+}
+
+esp_err_t trace_replay_open(trace_replay_t* replay, const char* path, bool loop) {
+    if (replay == NULL || path == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(replay, 0, sizeof(*replay));
+    replay->loop = loop;
+
+    replay->file = fopen(path, "rb");
+    if (replay->file == NULL) {
+        DEBUG_ERROR("Cannot open trace '%s'", path);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    trace_header_t header;
+    esp_err_t ret;
+    if (fread(&header, sizeof(header), 1, replay->file) == 1 && header.magic == TRACE_MAGIC) {
+        if (header.version != TRACE_VERSION || header.sample_rate_hz == 0) {
+            DEBUG_ERROR("Unsupported trace '%s' (version %u, %u Hz)", path,
+                        (unsigned)header.version, (unsigned)header.sample_rate_hz);
+            ret = ESP_ERR_INVALID_VERSION;
+        } else {
+            replay->format = TRACE_FORMAT_BINARY;
+            replay->sample_rate_hz = header.sample_rate_hz;
+            replay->data_offset = (long)sizeof(header);
+            ret = ESP_OK;
+        }
+    } else {
+        rewind(replay->file);
+        ret = open_csv(replay, path);
+    }
+    if (ret != ESP_OK) {
+        trace_replay_close(replay);
+        return ret;
+    }
+
+    if (replay->sample_rate_hz != SAMPLE_RATE_HZ) {
+        DEBUG_WARN("Trace '%s' is sampled at %u Hz, the model expects %d Hz", path,
+                   (unsigned)replay->sample_rate_hz, SAMPLE_RATE_HZ);
+    }
+    DEBUG_PRINT("Replaying %s trace '%s'%s", replay->format == TRACE_FORMAT_CSV ? "CSV" : "binary", path,
+                loop ? " in a loop" : "");
+    return ESP_OK;
+}
+
+void trace_replay_close(trace_replay_t* replay) {
+    if (replay != NULL && replay->file != NULL) {
+        fclose(replay->file);
+        replay->file = NULL;
+    }
+}
+
+static bool read_csv_row(trace_replay_t* replay, mpu6050_data_t* data) {
+    char line[TRACE_CSV_LINE_MAX];
+    char* fields[TRACE_CSV_LINE_MAX / 2];
+    while (fgets(line, sizeof(line), replay->file) != NULL) {
+        replay->line++;
+        int n = split_fields(line, fields, (int)(sizeof(fields) / sizeof(fields[0])));
+        if (n == 1 && fields[0][0] == '\0') {
+            continue;       // blank line
+        }
+
+        float v[INPUT_FEATURES];
+        bool valid = true;
+        for (int f = 0; f < INPUT_FEATURES && valid; f++) {
+            // Missing values are zero, as in the notebook (nan_to_num)
+            const char* field = replay->columns[f] < n ? fields[replay->columns[f]] : "";
+            char* end;
+            v[f] = field[0] == '\0' ? 0.0f : strtof(field, &end);
+            valid = field[0] == '\0' || (*end == '\0' && isfinite(v[f]));
+        }
+        if (!valid) {
+            if (replay->bad_rows++ == 0) {
+                DEBUG_WARN("Skipping unparsable trace row at line %lu", (unsigned long)replay->line);
+            }
+            continue;
+        }
+
+        data->accel_x = v[0];
+        data->accel_y = v[1];
+        data->accel_z = v[2];
+        data->gyro_x = v[3];
+        data->gyro_y = v[4];
+        data->gyro_z = v[5];
+        mpu6050_encode_raw(data);
+        return true;
+    }
+    return false;
+}
+
+static bool read_binary_record(trace_replay_t* replay, mpu6050_data_t* data) {
+    if (fread(&data->raw, sizeof(data->raw), 1, replay->file) != 1) {
+        return false;
+    }
+    data->accel_x = data->raw.accel[0] / MPU6050_ACCEL_LSB_PER_G;
+    data->accel_y = data->raw.accel[1] / MPU6050_ACCEL_LSB_PER_G;
+    data->accel_z = data->raw.accel[2] / MPU6050_ACCEL_LSB_PER_G;
+    data->gyro_x = data->raw.gyro[0] / MPU6050_GYRO_LSB_PER_DPS;
+    data->gyro_y = data->raw.gyro[1] / MPU6050_GYRO_LSB_PER_DPS;
+    data->gyro_z = data->raw.gyro[2] / MPU6050_GYRO_LSB_PER_DPS;
+    return true;
+}
+
+esp_err_t trace_replay_read(trace_replay_t* replay, mpu6050_data_t* data) {
+    if (replay == NULL || replay->file == NULL || data == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(data, 0, sizeof(*data));
+
+    // At most one rewind: a trace without a single sample ends the replay
+    for (int attempt = 0; attempt < 2; attempt++) {
+        bool got = replay->format == TRACE_FORMAT_CSV ? read_csv_row(replay, data)
+                                                      : read_binary_record(replay, data);
+        if (got) {
+            if (replay->samples == 0) {
+                replay->start_us = esp_timer_get_time();
+            }
+            data->timestamp = (uint64_t)(replay->start_us +
+                                         (int64_t)replay->samples * 1000000 / replay->sample_rate_hz);
+            data->temperature = 0.0f;   // not recorded
+            replay->samples++;
+            return ESP_OK;
+        }
+        if (!replay->loop) {
+            break;
+        }
+        replay->passes++;
+        replay->line = 1;
+        fseek(replay->file, replay->data_offset, SEEK_SET);
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+void trace_replay_print_stats(const trace_replay_t* replay, uint32_t inferences) {
+    if (replay == NULL || replay->samples == 0) {
+        return;
+    }
+    double seconds = (double)(esp_timer_get_time() - replay->start_us) / 1e6;
+    DEBUG_PRINT("Trace Replay: %lu samples, %lu passes, %lu bad rows, %.1f s",
+                (unsigned long)replay->samples, (unsigned long)replay->passes,
+                (unsigned long)replay->bad_rows, seconds);
+    if (seconds > 0.0) {
+        DEBUG_PRINT("  %.0f samples/s, %.1f inferences/s (%.1fx real time)",
+                    replay->samples / seconds, inferences / seconds,
+                    replay->samples / seconds / replay->sample_rate_hz);
+    }
+}